@@ -0,0 +1,179 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// associated header
+#include <tiny_sea/core/boat_velocity_raster.h>
+
+// includes
+// std
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+// tiny_sea
+#include <tiny_sea/core/exception.h>
+#include <tiny_sea/core/world_map.h>
+
+namespace tiny_sea {
+
+BoatVelocityRaster::BoatVelocityRaster(
+  const TimeWorldMap& timeWorldMap,
+  const CompiledBoatVelocityTable& speedTable,
+  std::size_t nrThreads)
+  : m_latSpace(timeWorldMap.values().front().latSpace())
+  , m_lonSpace(timeWorldMap.values().front().lonSpace())
+  , m_nrSlices(timeWorldMap.xSpace().nrPoints())
+  , m_relativeWindBearings(speedTable.relativeWindBearings())
+  , m_hasCurrent(false)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    for (std::size_t slice = 0; slice < m_nrSlices; ++slice) {
+        const auto& worldMap = timeWorldMap.values()[slice];
+        const auto& latSpace = worldMap.latSpace();
+        const auto& lonSpace = worldMap.lonSpace();
+        if (!(latSpace.start() == m_latSpace.start()) ||
+            !(latSpace.delta() == m_latSpace.delta()) ||
+            latSpace.nrPoints() != m_latSpace.nrPoints() ||
+            !(lonSpace.start() == m_lonSpace.start()) ||
+            !(lonSpace.delta() == m_lonSpace.delta()) ||
+            lonSpace.nrPoints() != m_lonSpace.nrPoints()) {
+            throw Exception("TimeWorldMap slices don't share the same grid");
+        }
+
+        // Only store currents if at least one node has one
+        for (std::size_t lon = 0;
+             lon < m_lonSpace.nrPoints() && !m_hasCurrent;
+             ++lon) {
+            for (std::size_t lat = 0; lat < m_latSpace.nrPoints(); ++lat) {
+                if (worldMap(lat, lon).hasCurrent()) {
+                    m_hasCurrent = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    m_values.resize(m_nrSlices * sliceSize() * nodeSize());
+
+    // Each thread take the next slice to compute
+    if (nrThreads == 0) {
+        nrThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    nrThreads = std::min(nrThreads, m_nrSlices);
+
+    std::atomic<std::size_t> nextSlice(0);
+    auto worker = [&]() {
+        for (std::size_t slice = nextSlice++; slice < m_nrSlices;
+             slice = nextSlice++) {
+            buildSlice(timeWorldMap, speedTable, slice);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (std::size_t i = 1; i < nrThreads; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    m_buildTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start);
+}
+
+void
+BoatVelocityRaster::interpolated(std::size_t slice,
+                                 latitude_t lat,
+                                 longitude_t lon,
+                                 radian_t& windBearing,
+                                 array_type& boatVelocities) const noexcept
+{
+    WindVector current;
+    interpolated(slice, lat, lon, windBearing, boatVelocities, current);
+}
+
+void
+BoatVelocityRaster::interpolated(std::size_t slice,
+                                 latitude_t lat,
+                                 longitude_t lon,
+                                 radian_t& windBearing,
+                                 array_type& boatVelocities,
+                                 WindVector& current) const noexcept
+{
+    auto resLat = m_latSpace.safeInterpolationWeight(lat);
+    auto resLon = m_lonSpace.safeInterpolationWeight(lon);
+
+    using map_type = Eigen::Map<const float_array_type>;
+    const float* data = m_values.data();
+    std::size_t size = nodeSize();
+    map_type n00(data + offset(slice, resLat.index, resLon.index), size);
+    map_type n10(data + offset(slice, resLat.index + 1, resLon.index), size);
+    map_type n01(data + offset(slice, resLat.index, resLon.index + 1), size);
+    map_type n11(data + offset(slice, resLat.index + 1, resLon.index + 1),
+                 size);
+
+    // Interpolate all bearings and the wind unit vector at once. Lazy Eigen
+    // expressions are evaluated in boatVelocities, no temporary is allocated
+    float pLat = float(resLat.percent.t);
+    float pLon = float(resLon.percent.t);
+    auto y0 = n00 + (n10 - n00) * pLat;
+    auto y1 = n01 + (n11 - n01) * pLat;
+    auto res = y0 + (y1 - y0) * pLon;
+
+    std::size_t nrB = nrBearings();
+    boatVelocities = res.head(nrB).cast<double>();
+    windBearing = radian_t(std::atan2(double(res(nrB)), double(res(nrB + 1))));
+    if (m_hasCurrent) {
+        current =
+          WindVector(velocity_t(res(nrB + 2)), velocity_t(res(nrB + 3)));
+    } else {
+        current = WindVector(velocity_t(0.), velocity_t(0.));
+    }
+}
+
+void
+BoatVelocityRaster::buildSlice(const TimeWorldMap& timeWorldMap,
+                               const CompiledBoatVelocityTable& speedTable,
+                               std::size_t slice)
+{
+    const auto& worldMap = timeWorldMap.values()[slice];
+    std::size_t nrB = nrBearings();
+    array_type boatVelocities;
+
+    // Also fill the duplicated last row and column
+    for (std::size_t lon = 0; lon < m_lonSpace.nrPoints() + 1; ++lon) {
+        for (std::size_t lat = 0; lat < m_latSpace.nrPoints() + 1; ++lat) {
+            auto data = worldMap(std::min(lat, m_latSpace.nrPoints() - 1),
+                                 std::min(lon, m_lonSpace.nrPoints() - 1));
+            speedTable.velocities(data.windVelocity, boatVelocities);
+
+            float* node = m_values.data() + offset(slice, lat, lon);
+            Eigen::Map<float_array_type>(node, nrB) =
+              boatVelocities.cast<float>();
+            node[nrB] = float(std::sin(data.windBearing.t));
+            node[nrB + 1] = float(std::cos(data.windBearing.t));
+            if (m_hasCurrent) {
+                node[nrB + 2] = float(data.current.m_x.t);
+                node[nrB + 3] = float(data.current.m_y.t);
+            }
+        }
+    }
+}
+
+}
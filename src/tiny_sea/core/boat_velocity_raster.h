@@ -0,0 +1,172 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+// includes
+// std
+#include <chrono>
+#include <vector>
+
+// tiny_sea
+#include <tiny_sea/core/compiled_boat_velocity_table.h>
+#include <tiny_sea/core/linear_space.h>
+#include <tiny_sea/core/units.h>
+#include <tiny_sea/core/wind_vector.h>
+#include <tiny_sea/fwd.h>
+
+// Eigen
+#include <Eigen/Core>
+
+namespace tiny_sea {
+
+/*! Boat velocities precomputed on each node of all TimeWorldMap time slice.
+ *
+ * For each slice and each grid node the raster store as float the boat
+ * velocity of all relative wind bearings of a CompiledBoatVelocityTable,
+ * followed by the wind bearing as an unit vector (sine, cosine):
+ *
+ * node (lat, lon) : [v(b0) v(b1) ... v(bn) sin(wind) cos(wind)]
+ *
+ * When a slice hold a current, the current u/v components are appended to
+ * all nodes and interpolated with the same weights:
+ *
+ * node (lat, lon) : [v(b0) ... v(bn) sin(wind) cos(wind) u(cur) v(cur)]
+ *
+ * A lookup compute the bilinear weights once and interpolate all bearings
+ * from the four surrounding nodes.
+ *
+ * \warning Boat velocities are interpolated between nodes instead of being
+ * computed from the interpolated wind. Since the boat velocity table is not
+ * linear, results can slightly differ between nodes.
+ */
+class BoatVelocityRaster
+{
+public:
+    using array_type = CompiledBoatVelocityTable::array_type;
+    using float_array_type = Eigen::ArrayXf;
+
+public:
+    /*! Precompute boat velocities of all \p timeWorldMap slices.
+     * Slices are computed in parallel.
+     * \param nrThreads Number of threads, 0 to use all hardware threads.
+     * \throw Exception if slices don't share the same latitude and
+     * longitude spaces.
+     */
+    BoatVelocityRaster(const TimeWorldMap& timeWorldMap,
+                       const CompiledBoatVelocityTable& speedTable,
+                       std::size_t nrThreads = 0);
+
+    /*! Interpolate wind bearing and boat velocities at a position.
+     * \param[in] slice Time slice index.
+     * \param[in] lat Clamped between [start(), stop()].
+     * \param[in] lon Clamped between [start(), stop()].
+     * \param[out] windBearing Interpolated wind bearing.
+     * \param[out] boatVelocities Boat velocities in the same order than
+     * relativeWindBearings(). Resized if needed.
+     */
+    void interpolated(std::size_t slice,
+                      latitude_t lat,
+                      longitude_t lon,
+                      radian_t& windBearing,
+                      array_type& boatVelocities) const noexcept;
+
+    /*! Interpolate wind bearing, boat velocities and current at a position.
+     * \param[out] current Interpolated current, null if hasCurrent() is
+     * false.
+     * \see interpolated
+     */
+    void interpolated(std::size_t slice,
+                      latitude_t lat,
+                      longitude_t lon,
+                      radian_t& windBearing,
+                      array_type& boatVelocities,
+                      WindVector& current) const noexcept;
+
+    /// \return true if nodes store a current
+    bool hasCurrent() const noexcept { return m_hasCurrent; }
+
+    /// Relative wind bearings of the compiled boat velocity table
+    const array_type& relativeWindBearings() const noexcept
+    {
+        return m_relativeWindBearings;
+    }
+
+    std::size_t nrBearings() const noexcept
+    {
+        return std::size_t(m_relativeWindBearings.size());
+    }
+
+    std::size_t nrSlices() const noexcept { return m_nrSlices; }
+
+    const LinearSpace<latitude_t>& latSpace() const noexcept
+    {
+        return m_latSpace;
+    }
+
+    const LinearSpace<longitude_t>& lonSpace() const noexcept
+    {
+        return m_lonSpace;
+    }
+
+    /// Time spent to precompute the raster
+    std::chrono::nanoseconds buildTime() const noexcept { return m_buildTime; }
+
+    /// Memory used by the raster values in bytes
+    std::size_t memory() const noexcept
+    {
+        return m_values.size() * sizeof(float);
+    }
+
+private:
+    /// \return Number of float stored by node
+    std::size_t nodeSize() const noexcept
+    {
+        return nrBearings() + (m_hasCurrent ? 4 : 2);
+    }
+
+    /// \return Number of node by slice, duplicated last row and column
+    std::size_t sliceSize() const noexcept
+    {
+        return (m_latSpace.nrPoints() + 1) * (m_lonSpace.nrPoints() + 1);
+    }
+
+    /// \return Value offset of a node
+    std::size_t offset(std::size_t slice,
+                       std::size_t lat,
+                       std::size_t lon) const noexcept
+    {
+        return (slice * sliceSize() + lat +
+                lon * (m_latSpace.nrPoints() + 1)) *
+               nodeSize();
+    }
+
+    /// Compute all nodes of one slice
+    void buildSlice(const TimeWorldMap& timeWorldMap,
+                    const CompiledBoatVelocityTable& speedTable,
+                    std::size_t slice);
+
+private:
+    LinearSpace<latitude_t> m_latSpace;
+    LinearSpace<longitude_t> m_lonSpace;
+    std::size_t m_nrSlices;
+    array_type m_relativeWindBearings;
+    bool m_hasCurrent;
+    std::vector<float> m_values;
+    std::chrono::nanoseconds m_buildTime;
+};
+
+}
@@ -0,0 +1,257 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+// includes
+// std
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <numeric>
+#include <vector>
+
+// tiny_sea
+#include <tiny_sea/core/boat_velocity_table.h>
+#include <tiny_sea/core/exception.h>
+#include <tiny_sea/core/linear_space.h>
+#include <tiny_sea/core/numeric_constants.h>
+#include <tiny_sea/core/simd_dispatch.h>
+#include <tiny_sea/core/units.h>
+
+// Eigen
+#include <Eigen/Core>
+
+namespace tiny_sea {
+
+/*! BoatVelocityTable compiled into one contiguous 2D table.
+ *
+ * Rows are relative wind bearings and columns are wind velocities. The table
+ * is stored column major so boat velocities of all bearings for one wind
+ * velocity are contiguous:
+ *
+ *                  [start()   1      stop()]
+ * wind velocity :   0.        5.     10.     10.
+ * bearing 0.    :   0.        2.     3.      3.
+ * bearing PI/2  :   0.        4.     6.      6.
+ * bearing PI    :   0.        3.     5.      5.
+ *
+ * Boat velocities of all bearings are then computed with one linear
+ * interpolation between two columns.
+ */
+class CompiledBoatVelocityTable
+{
+public:
+    using array_type = Eigen::ArrayXd;
+    using table_type = Eigen::ArrayXXd;
+
+public:
+    /*! Compile \p table by keeping its relative wind bearings and their order.
+     * \throw Exception if \p table is empty or if its wind velocity spaces
+     * are not the same.
+     */
+    CompiledBoatVelocityTable(const BoatVelocityTable& table)
+      : m_windVelocitySpace(windVelocitySpace(table))
+      , m_invWindVelocityDelta(1. / m_windVelocitySpace.delta().t)
+      , m_maxVelocity(table.maxVelocity())
+    {
+        const auto& velocities = table.velocityTable();
+        m_relativeWindBearings.resize(velocities.size());
+        m_values.resize(velocities.size(), m_windVelocitySpace.nrPoints() + 1);
+        for (std::size_t b = 0; b < velocities.size(); ++b) {
+            m_relativeWindBearings(b) = velocities[b].relativeWindBearing.t;
+            const auto& values =
+              velocities[b].windVelocityToBoatVelocity.values();
+            for (std::size_t v = 0; v < values.size(); ++v) {
+                m_values(b, v) = values[v].t;
+            }
+        }
+    }
+
+    /*! Compile \p table by resampling it on \p nrBearings relative wind
+     * bearings uniformly spaced in [0, 2PI[.
+     * Boat velocities are linearly interpolated between the two closest
+     * bearings of \p table.
+     * \throw Exception if \p table is empty, if its wind velocity spaces
+     * are not the same or if \p nrBearings is null.
+     */
+    CompiledBoatVelocityTable(const BoatVelocityTable& table,
+                              std::size_t nrBearings)
+      : m_windVelocitySpace(windVelocitySpace(table))
+      , m_invWindVelocityDelta(1. / m_windVelocitySpace.delta().t)
+      , m_maxVelocity(table.maxVelocity())
+    {
+        if (nrBearings == 0) {
+            throw Exception("nrBearings should at least be 1");
+        }
+
+        // Sort table bearings in [0, 2PI[
+        const auto& velocities = table.velocityTable();
+        std::vector<std::size_t> order(velocities.size());
+        std::vector<double> bearings(velocities.size());
+        for (std::size_t b = 0; b < velocities.size(); ++b) {
+            bearings[b] = normalize(velocities[b].relativeWindBearing.t);
+        }
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(
+          order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+              return bearings[a] < bearings[b];
+          });
+
+        m_relativeWindBearings.resize(nrBearings);
+        m_values.resize(nrBearings, m_windVelocitySpace.nrPoints() + 1);
+        for (std::size_t b = 0; b < nrBearings; ++b) {
+            double bearing = (2. * PI * double(b)) / double(nrBearings);
+            m_relativeWindBearings(b) = bearing;
+
+            // Find the two sorted bearings around bearing, wrapping around 2PI
+            auto upper = std::upper_bound(
+              order.begin(),
+              order.end(),
+              bearing,
+              [&](double t, std::size_t o) { return t < bearings[o]; });
+            std::size_t next = upper == order.end() ? order.front() : *upper;
+            std::size_t prev =
+              upper == order.begin() ? order.back() : *std::prev(upper);
+
+            double range = normalize(bearings[next] - bearings[prev]);
+            double percent =
+              range > 0. ? normalize(bearing - bearings[prev]) / range : 0.;
+
+            const auto& prevValues =
+              velocities[prev].windVelocityToBoatVelocity.values();
+            const auto& nextValues =
+              velocities[next].windVelocityToBoatVelocity.values();
+            for (std::size_t v = 0; v < prevValues.size(); ++v) {
+                m_values(b, v) =
+                  prevValues[v].t +
+                  (nextValues[v].t - prevValues[v].t) * percent;
+            }
+        }
+    }
+
+    /*! Compute boat velocities of all relative wind bearings.
+     * \param[in] windVelocity Clamped between [start(), stop()] of the wind
+     * velocity space.
+     * \param[out] boatVelocities Boat velocities in the same order than
+     * relativeWindBearings(). Resized if needed.
+     */
+    void velocities(velocity_t windVelocity,
+                    array_type& boatVelocities) const noexcept
+    {
+        double percent;
+        std::size_t index = weight(windVelocity, percent);
+        boatVelocities.resize(m_values.rows());
+        simd::kernels().lerp(m_values.col(index).data(),
+                             m_values.col(index + 1).data(),
+                             percent,
+                             std::size_t(m_values.rows()),
+                             boatVelocities.data());
+    }
+
+    /*! \return Boat velocity of one relative wind bearing.
+     * \param[in] bearing Relative wind bearing index.
+     * \param[in] windVelocity Clamped between [start(), stop()] of the wind
+     * velocity space.
+     */
+    velocity_t velocity(std::size_t bearing,
+                        velocity_t windVelocity) const noexcept
+    {
+        double percent;
+        std::size_t index = weight(windVelocity, percent);
+        double v0 = m_values(bearing, index);
+        return velocity_t(v0 + (m_values(bearing, index + 1) - v0) * percent);
+    }
+
+    std::size_t nrBearings() const noexcept
+    {
+        return std::size_t(m_relativeWindBearings.size());
+    }
+
+    /// Relative wind bearings of each table row
+    const array_type& relativeWindBearings() const noexcept
+    {
+        return m_relativeWindBearings;
+    }
+
+    /// Wind velocity space shared by all table rows
+    const LinearSpace<velocity_t>& windVelocitySpace() const noexcept
+    {
+        return m_windVelocitySpace;
+    }
+
+    /// Table values, one row by relative wind bearing
+    const table_type& values() const noexcept { return m_values; }
+
+    velocity_t maxVelocity() const noexcept { return m_maxVelocity; }
+
+private:
+    /// \return Wind velocity space of \p table
+    static LinearSpace<velocity_t> windVelocitySpace(
+      const BoatVelocityTable& table)
+    {
+        const auto& velocities = table.velocityTable();
+        if (velocities.empty()) {
+            throw Exception("BoatVelocityTable is empty");
+        }
+
+        const auto& space =
+          velocities.front().windVelocityToBoatVelocity.xSpace();
+        for (const auto& boatVelocity : velocities) {
+            const auto& o = boatVelocity.windVelocityToBoatVelocity.xSpace();
+            if (!(o.start() == space.start()) ||
+                !(o.delta() == space.delta()) ||
+                o.nrPoints() != space.nrPoints()) {
+                throw Exception(
+                  "BoatVelocityTable wind velocity spaces differ");
+            }
+        }
+        return space;
+    }
+
+    /// \return \p t normalized in [0, 2PI[
+    static double normalize(double t) noexcept
+    {
+        double res = std::fmod(t, 2. * PI);
+        return res < 0. ? res + 2. * PI : res;
+    }
+
+    /*! Compute interpolation weight of \p windVelocity with the precomputed
+     * inverse delta.
+     * \return Index of the smallest column.
+     */
+    std::size_t weight(velocity_t windVelocity, double& percent) const noexcept
+    {
+        double t = std::clamp(windVelocity,
+                              m_windVelocitySpace.start(),
+                              m_windVelocitySpace.stop())
+                     .t;
+        double x = (t - m_windVelocitySpace.start().t) * m_invWindVelocityDelta;
+        std::size_t index =
+          std::min(std::size_t(x), m_windVelocitySpace.nrPoints() - 1);
+        percent = x - double(index);
+        return index;
+    }
+
+private:
+    LinearSpace<velocity_t> m_windVelocitySpace;
+    double m_invWindVelocityDelta;
+    velocity_t m_maxVelocity;
+    array_type m_relativeWindBearings;
+    table_type m_values;
+};
+
+}
@@ -0,0 +1,206 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// associated header
+#include <tiny_sea/core/edge_index.h>
+
+// includes
+// std
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace tiny_sea {
+
+namespace {
+
+/// Latitude and longitude bounding box in radian
+struct Box
+{
+    double minLat = std::numeric_limits<double>::max();
+    double maxLat = std::numeric_limits<double>::lowest();
+    double minLon = std::numeric_limits<double>::max();
+    double maxLon = std::numeric_limits<double>::lowest();
+};
+
+/*! Bounding box of the great circle segment [\p a, \p b].
+ * The arc is bounded by its end points and middle point, the remaining
+ * bulge is smaller than the squared chord length.
+ */
+Box
+boundingBox(const Eigen::Vector3d& a, const Eigen::Vector3d& b) noexcept
+{
+    Box box;
+    const Eigen::Vector3d mid = (a + b).normalized();
+    for (const Eigen::Vector3d* p : { &a, &mid, &b }) {
+        double lat = std::asin(std::clamp(p->z(), -1., 1.));
+        double lon = std::atan2(p->y(), p->x());
+        box.minLat = std::min(box.minLat, lat);
+        box.maxLat = std::max(box.maxLat, lat);
+        box.minLon = std::min(box.minLon, lon);
+        box.maxLon = std::max(box.maxLon, lon);
+    }
+
+    double margin = (b - a).squaredNorm();
+    box.minLat -= margin;
+    box.maxLat += margin;
+    box.minLon -= margin;
+    box.maxLon += margin;
+    return box;
+}
+
+}
+
+EdgeIndex::EdgeIndex(const std::vector<GreatCircleEdge>& edges,
+                     radian_t bucketSize)
+  : m_latSpace(makeLinearSpace(latitude_t(0.), latitude_t(bucketSize.t), 2))
+  , m_lonSpace(
+      makeLinearSpace(longitude_t(0.), longitude_t(bucketSize.t), 2))
+  , m_nrEdges(edges.size())
+{
+    assert(bucketSize.t > 0.);
+
+    Box all;
+    for (const auto& edge : edges) {
+        Box box = boundingBox(edge.a, edge.b);
+        all.minLat = std::min(all.minLat, box.minLat);
+        all.maxLat = std::max(all.maxLat, box.maxLat);
+        all.minLon = std::min(all.minLon, box.minLon);
+        all.maxLon = std::max(all.maxLon, box.maxLon);
+    }
+
+    if (!edges.empty()) {
+        auto nrBuckets = [&](double min, double max) {
+            return std::max(std::size_t(2),
+                            std::size_t((max - min) / bucketSize.t) + 1);
+        };
+        m_latSpace = makeLinearSpace(latitude_t(all.minLat),
+                                     latitude_t(bucketSize.t),
+                                     nrBuckets(all.minLat, all.maxLat));
+        m_lonSpace = makeLinearSpace(longitude_t(all.minLon),
+                                     longitude_t(bucketSize.t),
+                                     nrBuckets(all.minLon, all.maxLon));
+    }
+
+    // Count edges by bucket, then fill buckets
+    m_offsets.assign(m_latSpace.nrPoints() * m_lonSpace.nrPoints() + 1, 0);
+    std::vector<Rect> rects(edges.size());
+    for (std::size_t i = 0; i < edges.size(); ++i) {
+        bool inside = bound(edges[i].a, edges[i].b, rects[i]);
+        assert(inside);
+        (void)inside;
+        for (std::size_t y = rects[i].y0; y <= rects[i].y1; ++y) {
+            for (std::size_t x = rects[i].x0; x <= rects[i].x1; ++x) {
+                ++m_offsets[bucket(x, y) + 1];
+            }
+        }
+    }
+    for (std::size_t b = 1; b < m_offsets.size(); ++b) {
+        m_offsets[b] += m_offsets[b - 1];
+    }
+
+    m_edges.resize(m_offsets.back());
+    std::vector<std::uint32_t> next(m_offsets.begin(), m_offsets.end() - 1);
+    for (std::size_t i = 0; i < edges.size(); ++i) {
+        for (std::size_t y = rects[i].y0; y <= rects[i].y1; ++y) {
+            for (std::size_t x = rects[i].x0; x <= rects[i].x1; ++x) {
+                m_edges[next[bucket(x, y)]++] = edges[i];
+            }
+        }
+    }
+}
+
+bool
+EdgeIndex::crossed(const NVector& from, const NVector& to) const noexcept
+{
+    Eigen::Vector3d a = from.toEigen();
+    Eigen::Vector3d b = to.toEigen();
+    Rect rect;
+    if (m_edges.empty() || !bound(a, b, rect)) {
+        return false;
+    }
+
+    for (std::size_t y = rect.y0; y <= rect.y1; ++y) {
+        std::size_t first = m_offsets[bucket(rect.x0, y)];
+        std::size_t last = m_offsets[bucket(rect.x1, y) + 1];
+        for (std::size_t i = first; i < last; ++i) {
+            if (m_edges[i].crossed(a, b)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool
+EdgeIndex::bound(const Eigen::Vector3d& a,
+                 const Eigen::Vector3d& b,
+                 Rect& rect) const noexcept
+{
+    Box box = boundingBox(a, b);
+
+    auto range = [](double min,
+                    double max,
+                    double start,
+                    double delta,
+                    std::size_t size,
+                    std::size_t& first,
+                    std::size_t& last) {
+        double first_bucket = std::floor((min - start) / delta);
+        double last_bucket = std::floor((max - start) / delta);
+        if (last_bucket < 0. || first_bucket >= double(size)) {
+            return false;
+        }
+        first = std::size_t(std::max(first_bucket, 0.));
+        last = std::size_t(std::min(last_bucket, double(size - 1)));
+        return true;
+    };
+
+    return range(box.minLat,
+                 box.maxLat,
+                 m_latSpace.start().t,
+                 m_latSpace.delta().t,
+                 m_latSpace.nrPoints(),
+                 rect.x0,
+                 rect.x1) &&
+           range(box.minLon,
+                 box.maxLon,
+                 m_lonSpace.start().t,
+                 m_lonSpace.delta().t,
+                 m_lonSpace.nrPoints(),
+                 rect.y0,
+                 rect.y1);
+}
+
+void
+EdgeIndexBuilder::addPolyline(const std::vector<NVector>& points)
+{
+    for (std::size_t i = 1; i < points.size(); ++i) {
+        m_edges.emplace_back(points[i - 1], points[i]);
+    }
+}
+
+void
+EdgeIndexBuilder::addPolygon(const std::vector<NVector>& points)
+{
+    addPolyline(points);
+    if (points.size() > 2) {
+        m_edges.emplace_back(points.back(), points.front());
+    }
+}
+
+}
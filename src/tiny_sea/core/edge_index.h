@@ -0,0 +1,170 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+// includes
+// std
+#include <cstdint>
+#include <vector>
+
+// tiny_sea
+#include <tiny_sea/core/linear_space.h>
+#include <tiny_sea/core/n_vector.h>
+#include <tiny_sea/core/units.h>
+
+// Eigen
+#include <Eigen/Core>
+
+namespace tiny_sea {
+
+/*! Great circle edge of a coastline or an exclusion polygon.
+ */
+struct GreatCircleEdge
+{
+    GreatCircleEdge() = default;
+    GreatCircleEdge(const NVector& p_a, const NVector& p_b)
+      : a(p_a.toEigen())
+      , b(p_b.toEigen())
+      , normal(a.cross(b))
+    {}
+
+    /*! Test if the great circle segment [\p from, \p to] cross this edge.
+     * Touching segments are crossing.
+     * \warning Both segments must be shorter than half a great circle.
+     */
+    bool crossed(const Eigen::Vector3d& from, const Eigen::Vector3d& to) const
+      noexcept
+    {
+        // Each segment end points must be on both sides of the other
+        // segment plane
+        Eigen::Vector3d n = from.cross(to);
+        if (normal.dot(from) * normal.dot(to) > 0. ||
+            n.dot(a) * n.dot(b) > 0.) {
+            return false;
+        }
+        // Both segments must cross the same of the two antipodal
+        // intersections
+        Eigen::Vector3d x = normal.cross(n);
+        return x.dot(a + b) * x.dot(from + to) >= 0.;
+    }
+
+    Eigen::Vector3d a;
+    Eigen::Vector3d b;
+    /// a x b
+    Eigen::Vector3d normal;
+};
+
+/*! Spatial index of great circle edges.
+ *
+ * Edges are stored in a regular latitude and longitude grid of buckets.
+ * Each edge is copied in all the buckets crossed by its bounding box, so a
+ * query only read the contiguous edges of the buckets crossed by the query
+ * bounding box. Bounding boxes are computed from the end points and the
+ * middle point, with a margin for the arc bulge.
+ *
+ * \warning Edges and queries crossing the antimeridian are not supported.
+ */
+class EdgeIndex
+{
+public:
+    /*!
+     * \param edges Indexed edges.
+     * \param bucketSize Latitude and longitude size of a bucket. Should be
+     * chosen to keep a few edges by bucket.
+     * \warning \p bucketSize should be strictly positive.
+     */
+    EdgeIndex(const std::vector<GreatCircleEdge>& edges, radian_t bucketSize);
+
+    /// \return true if the great circle step from \p from to \p to cross an
+    /// edge
+    bool crossed(const NVector& from, const NVector& to) const noexcept;
+
+    /// Number of indexed edges
+    std::size_t nrEdges() const noexcept { return m_nrEdges; }
+
+    /// Number of edges stored in buckets, edges can be in many buckets
+    std::size_t nrBucketEdges() const noexcept { return m_edges.size(); }
+
+    const LinearSpace<latitude_t>& latSpace() const noexcept
+    {
+        return m_latSpace;
+    }
+
+    const LinearSpace<longitude_t>& lonSpace() const noexcept
+    {
+        return m_lonSpace;
+    }
+
+    /// Memory used by the buckets in bytes
+    std::size_t memory() const noexcept
+    {
+        return m_edges.size() * sizeof(GreatCircleEdge) +
+               m_offsets.size() * sizeof(std::uint32_t);
+    }
+
+private:
+    /// Inclusive bucket rectangle
+    struct Rect
+    {
+        std::size_t x0, x1, y0, y1;
+    };
+
+    /*! Bucket rectangle bounding the great circle segment [\p a, \p b].
+     * \return false if the segment is outside the index
+     */
+    bool bound(const Eigen::Vector3d& a,
+               const Eigen::Vector3d& b,
+               Rect& rect) const noexcept;
+
+    std::size_t bucket(std::size_t x, std::size_t y) const noexcept
+    {
+        return x + y * m_latSpace.nrPoints();
+    }
+
+private:
+    LinearSpace<latitude_t> m_latSpace;
+    LinearSpace<longitude_t> m_lonSpace;
+    std::size_t m_nrEdges;
+    /// Bucket b edges are in [m_offsets[b], m_offsets[b + 1][
+    std::vector<std::uint32_t> m_offsets;
+    std::vector<GreatCircleEdge> m_edges;
+};
+
+/*! Helper class to build EdgeIndex from coastlines and exclusion polygons.
+ */
+class EdgeIndexBuilder
+{
+public:
+    /// \param bucketSize \see EdgeIndex
+    explicit EdgeIndexBuilder(radian_t bucketSize)
+      : m_bucketSize(bucketSize)
+    {}
+
+    /// Add the edges between consecutive points of \p points
+    void addPolyline(const std::vector<NVector>& points);
+
+    /// Add a closed polygon, the last point is linked to the first one
+    void addPolygon(const std::vector<NVector>& points);
+
+    EdgeIndex build() const { return EdgeIndex(m_edges, m_bucketSize); }
+
+private:
+    radian_t m_bucketSize;
+    std::vector<GreatCircleEdge> m_edges;
+};
+
+}
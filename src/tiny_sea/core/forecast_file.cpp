@@ -0,0 +1,368 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// associated header
+#include <tiny_sea/core/forecast_file.h>
+
+// includes
+// std
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <vector>
+
+// POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// tiny_sea
+#include <tiny_sea/core/exception.h>
+#include <tiny_sea/core/wind_vector.h>
+#include <tiny_sea/core/world_map.h>
+
+namespace tiny_sea {
+
+namespace {
+
+std::uint64_t
+align(std::uint64_t size)
+{
+    const auto a = ForecastHeader::PLANE_ALIGNMENT;
+    return ((size + a - 1) / a) * a;
+}
+
+/// \return false if \p a * \p b overflow
+bool
+checkedMul(std::uint64_t a, std::uint64_t b, std::uint64_t& res) noexcept
+{
+    if (b != 0 && a > std::numeric_limits<std::uint64_t>::max() / b) {
+        return false;
+    }
+    res = a * b;
+    return true;
+}
+
+/// \return false if \p a + \p b overflow
+bool
+checkedAdd(std::uint64_t a, std::uint64_t b, std::uint64_t& res) noexcept
+{
+    if (a > std::numeric_limits<std::uint64_t>::max() - b) {
+        return false;
+    }
+    res = a + b;
+    return true;
+}
+
+/// \throw Exception if \p timeSpace steps are not uniform
+LinearSpace<time_t>
+uniformTimeSpace(const NonUniformSpace<time_t>& timeSpace)
+{
+    auto res = makeLinearSpaceFromBound(
+      timeSpace.start(), timeSpace.stop(), timeSpace.nrPoints());
+    for (std::size_t i = 0; i < timeSpace.nrPoints(); ++i) {
+        if (std::abs((timeSpace.value(i) - res.value(i)).t) >
+            1e-6 * res.delta().t) {
+            throw Exception("Forecast file need uniform time steps");
+        }
+    }
+    return res;
+}
+
+/// \return true if a node of \p worldMap has a current
+bool
+hasCurrent(const WorldMap& worldMap)
+{
+    for (std::size_t lon = 0; lon < worldMap.lonSpace().nrPoints(); ++lon) {
+        for (std::size_t lat = 0; lat < worldMap.latSpace().nrPoints(); ++lat) {
+            if (worldMap(lat, lon).hasCurrent()) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+}
+
+ForecastHeader
+ForecastHeader::make(const LinearSpace<time_t>& timeSpace,
+                     const LinearSpace<latitude_t>& latSpace,
+                     const LinearSpace<longitude_t>& lonSpace,
+                     bool current)
+{
+    ForecastHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::copy(std::begin(MAGIC), std::end(MAGIC), header.magic);
+    header.version = VERSION;
+    header.byteOrder = ENDIAN_MARK;
+    header.timeStart = timeSpace.start().t;
+    header.timeDelta = timeSpace.delta().t;
+    header.timeNrPoints = timeSpace.nrPoints();
+    header.latStart = latSpace.start().t;
+    header.latDelta = latSpace.delta().t;
+    header.latNrPoints = latSpace.nrPoints();
+    header.lonStart = lonSpace.start().t;
+    header.lonDelta = lonSpace.delta().t;
+    header.lonNrPoints = lonSpace.nrPoints();
+    header.nrComponents = current ? 4 : 2;
+    header.planeOffset = align(sizeof(ForecastHeader));
+    header.planeStride = align(header.planeSize() * sizeof(float));
+    return header;
+}
+
+void
+ForecastHeader::check(std::uint64_t size) const
+{
+    if (!std::equal(std::begin(MAGIC), std::end(MAGIC), magic)) {
+        throw Exception("Invalid forecast file magic");
+    }
+    if (version != VERSION) {
+        throw Exception("Unsupported forecast file version");
+    }
+    if (byteOrder != ENDIAN_MARK) {
+        throw Exception("Forecast file byte order differ from host");
+    }
+    if (nrComponents != 2 && nrComponents != 4) {
+        throw Exception("Invalid forecast file number of components");
+    }
+    if (timeNrPoints < 2 || latNrPoints < 2 || lonNrPoints < 2) {
+        throw Exception("Invalid forecast file grid");
+    }
+
+    // Recompute the layout written by ForecastWriter, without overflow
+    std::uint64_t nrValues = 0;
+    std::uint64_t nrBytes = 0;
+    std::uint64_t padded = 0;
+    std::uint64_t nrPlanes = 0;
+    std::uint64_t planesBytes = 0;
+    std::uint64_t expectedSize = 0;
+    std::uint64_t offset = align(sizeof(ForecastHeader));
+    bool valid =
+      checkedMul(latNrPoints + 1, lonNrPoints + 1, nrValues) &&
+      checkedMul(nrValues, sizeof(float), nrBytes) &&
+      checkedAdd(nrBytes, PLANE_ALIGNMENT - 1, padded) &&
+      checkedMul(timeNrPoints, nrComponents, nrPlanes) &&
+      checkedMul(nrPlanes, align(nrBytes), planesBytes) &&
+      checkedAdd(planesBytes, offset, expectedSize);
+    if (!valid) {
+        throw Exception("Forecast file size overflow");
+    }
+    if (planeOffset != offset || planeStride != align(nrBytes)) {
+        throw Exception("Invalid forecast file plane layout");
+    }
+    if (expectedSize > size) {
+        throw Exception("Truncated forecast file");
+    }
+}
+
+LinearSpace<time_t>
+ForecastHeader::timeSpace() const
+{
+    return safeMakeLinearSpace(
+      time_t(timeStart), time_t(timeDelta), std::size_t(timeNrPoints));
+}
+
+LinearSpace<latitude_t>
+ForecastHeader::latSpace() const
+{
+    return safeMakeLinearSpace(
+      latitude_t(latStart), latitude_t(latDelta), std::size_t(latNrPoints));
+}
+
+LinearSpace<longitude_t>
+ForecastHeader::lonSpace() const
+{
+    return safeMakeLinearSpace(
+      longitude_t(lonStart), longitude_t(lonDelta), std::size_t(lonNrPoints));
+}
+
+ForecastWriter::ForecastWriter(const std::string& path,
+                               const LinearSpace<time_t>& timeSpace,
+                               const LinearSpace<latitude_t>& latSpace,
+                               const LinearSpace<longitude_t>& lonSpace,
+                               bool current)
+  : m_header(ForecastHeader::make(timeSpace, latSpace, lonSpace, current))
+  , m_file(path, std::ios::binary | std::ios::out | std::ios::trunc)
+{
+    if (!m_file) {
+        throw Exception("Impossible to create forecast file " + path);
+    }
+
+    // Write the header and allocate the whole file
+    m_file.write(reinterpret_cast<const char*>(&m_header), sizeof(m_header));
+    m_file.seekp(std::streamoff(m_header.fileSize() - 1));
+    m_file.put('\0');
+    if (!m_file) {
+        throw Exception("Impossible to write forecast file " + path);
+    }
+}
+
+void
+ForecastWriter::write(std::size_t slice,
+                      Component component,
+                      const float* values)
+{
+    if (slice >= m_header.timeNrPoints) {
+        throw Exception("Forecast slice out of range");
+    }
+    if (std::size_t(component) >= m_header.nrComponents) {
+        throw Exception("Forecast file don't store current planes");
+    }
+
+    // Reorder values in the WindGrid plane layout
+    std::size_t nrLat = m_header.latNrPoints;
+    std::size_t nrLon = m_header.lonNrPoints;
+    std::vector<float> plane(m_header.planeSize());
+    for (std::size_t lon = 0; lon < nrLon + 1; ++lon) {
+        for (std::size_t lat = 0; lat < nrLat + 1; ++lat) {
+            plane[lat + lon * (nrLat + 1)] =
+              values[std::min(lat, nrLat - 1) +
+                     std::min(lon, nrLon - 1) * nrLat];
+        }
+    }
+
+    m_file.seekp(
+      std::streamoff(m_header.offset(slice, std::size_t(component))));
+    m_file.write(reinterpret_cast<const char*>(plane.data()),
+                 std::streamsize(plane.size() * sizeof(float)));
+    if (!m_file) {
+        throw Exception("Impossible to write forecast plane");
+    }
+}
+
+void
+ForecastWriter::write(std::size_t slice, const WorldMap& worldMap)
+{
+    std::size_t nrLat = m_header.latNrPoints;
+    std::size_t nrLon = m_header.lonNrPoints;
+    if (worldMap.latSpace().nrPoints() != nrLat ||
+        worldMap.lonSpace().nrPoints() != nrLon) {
+        throw Exception("WorldMap grid don't match forecast grid");
+    }
+
+    std::vector<float> u(nrLat * nrLon);
+    std::vector<float> v(nrLat * nrLon);
+    std::vector<float> currentU(nrLat * nrLon);
+    std::vector<float> currentV(nrLat * nrLon);
+    bool current = false;
+    for (std::size_t lon = 0; lon < nrLon; ++lon) {
+        for (std::size_t lat = 0; lat < nrLat; ++lat) {
+            auto data = worldMap(lat, lon);
+            auto wind =
+              WindVector::fromBearing(data.windBearing, data.windVelocity);
+            u[lat + lon * nrLat] = float(wind.m_x.t);
+            v[lat + lon * nrLat] = float(wind.m_y.t);
+            currentU[lat + lon * nrLat] = float(data.current.m_x.t);
+            currentV[lat + lon * nrLat] = float(data.current.m_y.t);
+            current = current || data.hasCurrent();
+        }
+    }
+    if (current && !m_header.hasCurrent()) {
+        throw Exception("Forecast file don't store current planes");
+    }
+
+    write(slice, Component::U, u.data());
+    write(slice, Component::V, v.data());
+    if (m_header.hasCurrent()) {
+        write(slice, Component::CURRENT_U, currentU.data());
+        write(slice, Component::CURRENT_V, currentV.data());
+    }
+}
+
+void
+ForecastWriter::close()
+{
+    m_file.close();
+    if (!m_file) {
+        throw Exception("Impossible to close forecast file");
+    }
+}
+
+void
+writeForecast(const std::string& path, const TimeWorldMap& timeWorldMap)
+{
+    const auto& worldMaps = timeWorldMap.values();
+    std::size_t nrSlices = timeWorldMap.xSpace().nrPoints();
+    bool current = std::any_of(worldMaps.begin(),
+                               worldMaps.begin() + std::ptrdiff_t(nrSlices),
+                               [](const WorldMap& w) { return hasCurrent(w); });
+    ForecastWriter writer(path,
+                          uniformTimeSpace(timeWorldMap.xSpace()),
+                          worldMaps.front().latSpace(),
+                          worldMaps.front().lonSpace(),
+                          current);
+    for (std::size_t i = 0; i < nrSlices; ++i) {
+        writer.write(i, worldMaps[i]);
+    }
+    writer.close();
+}
+
+TimeWorldMap
+mapForecast(const std::string& path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw Exception("Impossible to open forecast file " + path);
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 ||
+        std::size_t(st.st_size) < sizeof(ForecastHeader)) {
+        ::close(fd);
+        throw Exception("Invalid forecast file " + path);
+    }
+
+    std::size_t size = std::size_t(st.st_size);
+    void* addr = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        throw Exception("Impossible to map forecast file " + path);
+    }
+    std::shared_ptr<const void> mapping(
+      addr, [size](const void* p) { ::munmap(const_cast<void*>(p), size); });
+
+    const auto* header = static_cast<const ForecastHeader*>(mapping.get());
+    header->check(size);
+
+    auto latSpace = header->latSpace();
+    auto lonSpace = header->lonSpace();
+    const char* data = static_cast<const char*>(mapping.get());
+    std::vector<WorldMap> worldMaps;
+    worldMaps.reserve(header->timeNrPoints + 1);
+    auto plane = [&](std::size_t slice, std::size_t component) {
+        return reinterpret_cast<const float*>(
+          data + header->offset(slice, component));
+    };
+    for (std::size_t i = 0; i < header->timeNrPoints; ++i) {
+        bool current = header->hasCurrent();
+        worldMaps.emplace_back(WindGrid(latSpace,
+                                        lonSpace,
+                                        mapping,
+                                        plane(i, 0),
+                                        plane(i, 1),
+                                        current ? plane(i, 2) : nullptr,
+                                        current ? plane(i, 3) : nullptr));
+    }
+    worldMaps.emplace_back(worldMaps.back());
+
+    return TimeWorldMap(header->timeSpace(), std::move(worldMaps));
+}
+
+}
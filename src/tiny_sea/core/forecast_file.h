@@ -0,0 +1,187 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+// includes
+// std
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+// tiny_sea
+#include <tiny_sea/core/linear_space.h>
+#include <tiny_sea/core/units.h>
+#include <tiny_sea/fwd.h>
+
+namespace tiny_sea {
+
+/*! Binary forecast file format.
+ *
+ * The file start with a ForecastHeader followed by the wind u/v planes of all
+ * time slices. Each plane is a WindGrid plane of float values (last row and
+ * column duplicated) starting on a PLANE_ALIGNMENT aligned offset:
+ *
+ * [header][slice 0 u][slice 0 v][slice 1 u][slice 1 v]...
+ *
+ * When nrComponents is 4, the current u/v planes follow the wind planes of
+ * each slice:
+ *
+ * [header][slice 0 u][slice 0 v][slice 0 current u][slice 0 current v]...
+ *
+ * Values are stored in the host byte order, the header byteOrder field allow
+ * to detect a file written on a different host.
+ */
+struct ForecastHeader
+{
+    static constexpr char MAGIC[8] = { 'T', 'S', 'F', 'O', 'R', 'E', 'C', 'A' };
+    static constexpr std::uint32_t VERSION = 2;
+    static constexpr std::uint32_t ENDIAN_MARK = 0x01020304;
+    static constexpr std::uint64_t PLANE_ALIGNMENT = 64;
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+
+    double timeStart;
+    double timeDelta;
+    std::uint64_t timeNrPoints;
+
+    double latStart;
+    double latDelta;
+    std::uint64_t latNrPoints;
+
+    double lonStart;
+    double lonDelta;
+    std::uint64_t lonNrPoints;
+
+    std::uint64_t nrComponents; //< 2 (wind) or 4 (wind and current) planes
+    std::uint64_t planeOffset; //< Offset of the first plane
+    std::uint64_t planeStride; //< Bytes between two planes
+
+    /*! Build a valid header
+     * \param current Store current planes.
+     */
+    static ForecastHeader make(const LinearSpace<time_t>& timeSpace,
+                               const LinearSpace<latitude_t>& latSpace,
+                               const LinearSpace<longitude_t>& lonSpace,
+                               bool current = false);
+
+    /*! Check the header is valid for a file of \p size bytes.
+     * The plane layout must be the one computed by make, so planes never
+     * overlap nor end past \p size.
+     * \throw Exception on invalid header, plane layout or size overflow,
+     * or on truncated file.
+     */
+    void check(std::uint64_t size) const;
+
+    LinearSpace<time_t> timeSpace() const;
+    LinearSpace<latitude_t> latSpace() const;
+    LinearSpace<longitude_t> lonSpace() const;
+
+    /// \return Number of float by plane
+    std::uint64_t planeSize() const noexcept
+    {
+        return (latNrPoints + 1) * (lonNrPoints + 1);
+    }
+
+    /// \return true if current planes are stored
+    bool hasCurrent() const noexcept { return nrComponents == 4; }
+
+    /*! \return Offset of a wind u (\p component 0), wind v (1), current u (2)
+     * or current v (3) plane
+     */
+    std::uint64_t offset(std::size_t slice, std::size_t component) const
+      noexcept
+    {
+        return planeOffset + (nrComponents * slice + component) * planeStride;
+    }
+
+    /// \return Expected file size
+    std::uint64_t fileSize() const noexcept
+    {
+        return offset(timeNrPoints, 0);
+    }
+};
+
+/*! Write a forecast file plane by plane.
+ * Planes can be written in any order. Unwritten planes are filled with 0.
+ */
+class ForecastWriter
+{
+public:
+    enum class Component : std::size_t
+    {
+        U = 0,         //< West to east component
+        V = 1,         //< South to north component
+        CURRENT_U = 2, //< West to east current component
+        CURRENT_V = 3  //< South to north current component
+    };
+
+public:
+    /*! Create the file and write the header.
+     * \param current Store current planes.
+     * \throw Exception if the file can't be created.
+     */
+    ForecastWriter(const std::string& path,
+                   const LinearSpace<time_t>& timeSpace,
+                   const LinearSpace<latitude_t>& latSpace,
+                   const LinearSpace<longitude_t>& lonSpace,
+                   bool current = false);
+
+    /*! Write one plane.
+     * \param values latNrPoints * lonNrPoints values, value of the (lat, lon)
+     * node is values[lat + lon * latNrPoints].
+     * \throw Exception on write error or if \p component is a current plane
+     * of a file without current.
+     */
+    void write(std::size_t slice, Component component, const float* values);
+
+    /*! Write all planes of one slice.
+     * \throw Exception on write error or if \p worldMap has a current and the
+     * file don't store current planes.
+     */
+    void write(std::size_t slice, const WorldMap& worldMap);
+
+    /*! Flush and close the file.
+     * \throw Exception on write error.
+     */
+    void close();
+
+    const ForecastHeader& header() const noexcept { return m_header; }
+
+private:
+    ForecastHeader m_header;
+    std::ofstream m_file;
+};
+
+/*! Write all \p timeWorldMap slices into \p path
+ * Current planes are only stored if a node of a slice has a current.
+ * \throw Exception if \p timeWorldMap time steps are not uniform.
+ */
+void
+writeForecast(const std::string& path, const TimeWorldMap& timeWorldMap);
+
+/*! Memory map a forecast file and build a TimeWorldMap view on it.
+ * All slices are WindGrid views on the mapped wind and current planes, no
+ * value is copied.
+ * The mapping is released when the last WindGrid is destroyed.
+ * \throw Exception if the file can't be mapped or is not a valid forecast.
+ */
+TimeWorldMap
+mapForecast(const std::string& path);
+
+}
@@ -0,0 +1,890 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// associated header
+#include <tiny_sea/core/grib2.h>
+
+// includes
+// std
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+// tiny_sea
+#include <tiny_sea/core/exception.h>
+#include <tiny_sea/core/forecast_file.h>
+#include <tiny_sea/core/numeric_constants.h>
+#include <tiny_sea/core/wind_vector.h>
+#include <tiny_sea/core/world_map.h>
+
+namespace tiny_sea {
+
+namespace {
+
+const double DEG_TO_RAD = PI / 180.;
+
+// GRIB2 octets are numbered from 1, all helpers take the section start and
+// the octet number used by the WMO tables.
+
+std::uint32_t
+u8(const std::uint8_t* s, std::size_t octet)
+{
+    return s[octet - 1];
+}
+
+std::uint32_t
+u16(const std::uint8_t* s, std::size_t octet)
+{
+    return (u8(s, octet) << 8) | u8(s, octet + 1);
+}
+
+std::uint32_t
+u32(const std::uint8_t* s, std::size_t octet)
+{
+    return (u16(s, octet) << 16) | u16(s, octet + 2);
+}
+
+std::uint64_t
+u64(const std::uint8_t* s, std::size_t octet)
+{
+    return (std::uint64_t(u32(s, octet)) << 32) | u32(s, octet + 4);
+}
+
+/// Signed integers use the sign and magnitude representation
+std::int64_t
+signedValue(std::uint64_t value, std::size_t nrBits)
+{
+    std::uint64_t sign = std::uint64_t(1) << (nrBits - 1);
+    return (value & sign) ? -std::int64_t(value & (sign - 1))
+                          : std::int64_t(value);
+}
+
+std::int32_t
+s8(const std::uint8_t* s, std::size_t octet)
+{
+    return std::int32_t(signedValue(u8(s, octet), 8));
+}
+
+std::int32_t
+s16(const std::uint8_t* s, std::size_t octet)
+{
+    return std::int32_t(signedValue(u16(s, octet), 16));
+}
+
+std::int32_t
+s32(const std::uint8_t* s, std::size_t octet)
+{
+    return std::int32_t(signedValue(u32(s, octet), 32));
+}
+
+float
+ieee32(const std::uint8_t* s, std::size_t octet)
+{
+    std::uint32_t bits = u32(s, octet);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/// Big endian bit stream reader
+class BitReader
+{
+public:
+    BitReader(const std::uint8_t* data, std::size_t size)
+      : m_data(data)
+      , m_nrBits(size * 8)
+    {}
+
+    /// Read \p nrBits bits (at most 64) as an unsigned value
+    std::uint64_t read(std::size_t nrBits)
+    {
+        if (m_pos + nrBits > m_nrBits) {
+            throw Exception("GRIB2 data section is too short");
+        }
+
+        std::uint64_t value = 0;
+        while (nrBits > 0) {
+            std::size_t offset = m_pos & 7;
+            std::size_t take = std::min(8 - offset, nrBits);
+            std::uint64_t bits =
+              (m_data[m_pos >> 3] >> (8 - offset - take)) & ((1u << take) - 1);
+            value = (value << take) | bits;
+            m_pos += take;
+            nrBits -= take;
+        }
+        return value;
+    }
+
+    /// Move to the next octet boundary
+    void align() noexcept { m_pos = (m_pos + 7) & ~std::size_t(7); }
+
+private:
+    const std::uint8_t* m_data;
+    std::size_t m_nrBits;
+    std::size_t m_pos = 0;
+};
+
+/// Grid definition template 3.0
+struct Grid
+{
+    bool supported = false;
+    std::size_t nrPoints = 0;
+    std::size_t ni = 0; // Points along a parallel
+    std::size_t nj = 0; // Points along a meridian
+    double la1 = 0.;    // Degrees
+    double lo1 = 0.;
+    double la2 = 0.;
+    double lo2 = 0.;
+    double di = 0.;
+    double dj = 0.;
+    std::uint32_t scanningMode = 0;
+};
+
+/// Product definition templates 4.0 to 4.15, they share the same first octets
+struct Product
+{
+    bool supported = false;
+    Grib2FieldHeader header;
+};
+
+/// Data representation templates 5.0, 5.2 and 5.3
+struct Representation
+{
+    std::uint32_t templateNumber = 0;
+    std::size_t nrPoints = 0;
+    float reference = 0.f;
+    std::int32_t binaryScale = 0;
+    std::int32_t decimalScale = 0;
+    std::size_t nrBits = 0;
+
+    // Complex packing
+    std::uint32_t missingManagement = 0;
+    std::size_t nrGroups = 0;
+    std::uint32_t widthReference = 0;
+    std::size_t widthNrBits = 0;
+    std::uint32_t lengthReference = 0;
+    std::uint32_t lengthIncrement = 0;
+    std::uint32_t lastLength = 0;
+    std::size_t lengthNrBits = 0;
+
+    // Spatial differencing
+    std::uint32_t differencingOrder = 0;
+    std::size_t differencingNrOctets = 0;
+};
+
+double
+angle(const std::uint8_t* s, std::size_t octet, double unit)
+{
+    return double(s32(s, octet)) * unit;
+}
+
+Grid
+parseGrid(const std::uint8_t* s, std::size_t length)
+{
+    Grid grid;
+    if (length < 72 || u8(s, 6) != 0 || u16(s, 13) != 0) {
+        return grid;
+    }
+
+    grid.nrPoints = u32(s, 7);
+    grid.ni = u32(s, 31);
+    grid.nj = u32(s, 35);
+
+    // Angles are in micro degree unless a basic angle is given
+    double unit = 1e-6;
+    std::uint32_t basicAngle = u32(s, 39);
+    std::uint32_t subdivisions = u32(s, 43);
+    if (basicAngle != 0 && basicAngle != 0xFFFFFFFF) {
+        unit = double(basicAngle) / double(subdivisions);
+    }
+
+    grid.la1 = angle(s, 47, unit);
+    grid.lo1 = double(u32(s, 51)) * unit;
+    grid.la2 = angle(s, 56, unit);
+    grid.lo2 = double(u32(s, 60)) * unit;
+    grid.scanningMode = u8(s, 72);
+
+    // Increments can be missing, use the grid bounds instead
+    bool iNegative = (grid.scanningMode & 0x80) != 0;
+    double lonSpan = iNegative ? grid.lo1 - grid.lo2 : grid.lo2 - grid.lo1;
+    if (lonSpan < 0.) {
+        lonSpan += 360.;
+    }
+    grid.di = u32(s, 64) != 0xFFFFFFFF
+                ? double(u32(s, 64)) * unit
+                : lonSpan / double(std::max<std::size_t>(grid.ni - 1, 1));
+    grid.dj = u32(s, 68) != 0xFFFFFFFF
+                ? double(u32(s, 68)) * unit
+                : std::abs(grid.la2 - grid.la1) /
+                    double(std::max<std::size_t>(grid.nj - 1, 1));
+
+    grid.supported = grid.ni > 1 && grid.nj > 1 &&
+                     grid.ni * grid.nj == grid.nrPoints &&
+                     (grid.scanningMode & 0x10) == 0;
+    return grid;
+}
+
+time_t
+forecastTime(std::uint32_t unit, std::uint32_t value)
+{
+    double seconds = 0.;
+    switch (unit) {
+        case 0:
+            seconds = 60.;
+            break;
+        case 1:
+            seconds = 3600.;
+            break;
+        case 2:
+            seconds = 86400.;
+            break;
+        case 10:
+            seconds = 3. * 3600.;
+            break;
+        case 11:
+            seconds = 6. * 3600.;
+            break;
+        case 12:
+            seconds = 12. * 3600.;
+            break;
+        case 13:
+            seconds = 1.;
+            break;
+        default:
+            throw Exception("Unsupported GRIB2 time range unit " +
+                            std::to_string(unit));
+    }
+    return time_t(seconds * double(value));
+}
+
+Product
+parseProduct(const std::uint8_t* s, std::size_t length, std::uint8_t discipline)
+{
+    Product product;
+    if (length < 34 || u16(s, 8) > 15) {
+        return product;
+    }
+
+    product.supported = true;
+    auto& header = product.header;
+    header.discipline = discipline;
+    header.category = std::uint8_t(u8(s, 10));
+    header.number = std::uint8_t(u8(s, 11));
+    header.forecastTime = forecastTime(u8(s, 18), u32(s, 19));
+    header.surfaceType = std::uint8_t(u8(s, 23));
+    header.surfaceValue =
+      double(u32(s, 25)) * std::pow(10., -double(s8(s, 24)));
+    return product;
+}
+
+Representation
+parseRepresentation(const std::uint8_t* s, std::size_t length)
+{
+    Representation rep;
+    if (length < 21) {
+        throw Exception("GRIB2 data representation section is too short");
+    }
+
+    rep.nrPoints = u32(s, 6);
+    rep.templateNumber = u16(s, 10);
+    rep.reference = ieee32(s, 12);
+    rep.binaryScale = s16(s, 16);
+    rep.decimalScale = s16(s, 18);
+    rep.nrBits = u8(s, 20);
+
+    if (rep.templateNumber == 2 || rep.templateNumber == 3) {
+        if (length < 47 || (rep.templateNumber == 3 && length < 49)) {
+            throw Exception("GRIB2 complex packing section is too short");
+        }
+        rep.missingManagement = u8(s, 23);
+        rep.nrGroups = u32(s, 32);
+        rep.widthReference = u8(s, 36);
+        rep.widthNrBits = u8(s, 37);
+        rep.lengthReference = u32(s, 38);
+        rep.lengthIncrement = u8(s, 42);
+        rep.lastLength = u32(s, 43);
+        rep.lengthNrBits = u8(s, 47);
+        if (rep.templateNumber == 3) {
+            rep.differencingOrder = u8(s, 48);
+            rep.differencingNrOctets = u8(s, 49);
+        }
+    }
+    return rep;
+}
+
+/// Unpack simple packing (template 7.0) integer values
+void
+unpackSimple(const Representation& rep,
+             const std::uint8_t* data,
+             std::size_t size,
+             std::vector<std::int64_t>& values)
+{
+    BitReader reader(data, size);
+    for (auto& v : values) {
+        v = std::int64_t(reader.read(rep.nrBits));
+    }
+}
+
+/// Unpack complex packing (templates 7.2 and 7.3) integer values
+void
+unpackComplex(const Representation& rep,
+              const std::uint8_t* data,
+              std::size_t size,
+              std::vector<std::int64_t>& values)
+{
+    if (rep.missingManagement != 0) {
+        throw Exception("GRIB2 complex packing missing values unsupported");
+    }
+    if (rep.templateNumber == 3 &&
+        (rep.differencingOrder < 1 || rep.differencingOrder > 2 ||
+         rep.differencingNrOctets == 0)) {
+        throw Exception("Unsupported GRIB2 spatial differencing");
+    }
+
+    BitReader reader(data, size);
+
+    // Spatial differencing first values and minimum
+    std::int64_t first[2] = { 0, 0 };
+    std::int64_t minimum = 0;
+    if (rep.templateNumber == 3) {
+        std::size_t nrBits = rep.differencingNrOctets * 8;
+        for (std::uint32_t i = 0; i < rep.differencingOrder; ++i) {
+            first[i] = signedValue(reader.read(nrBits), nrBits);
+        }
+        minimum = signedValue(reader.read(nrBits), nrBits);
+    }
+
+    std::vector<std::uint64_t> references(rep.nrGroups);
+    for (auto& r : references) {
+        r = reader.read(rep.nrBits);
+    }
+    reader.align();
+
+    std::vector<std::size_t> widths(rep.nrGroups);
+    for (auto& w : widths) {
+        w = rep.widthReference + reader.read(rep.widthNrBits);
+    }
+    reader.align();
+
+    std::vector<std::size_t> lengths(rep.nrGroups);
+    for (auto& l : lengths) {
+        l = rep.lengthReference +
+            rep.lengthIncrement * reader.read(rep.lengthNrBits);
+    }
+    reader.align();
+    if (!lengths.empty()) {
+        lengths.back() = rep.lastLength;
+    }
+
+    std::size_t index = 0;
+    for (std::size_t g = 0; g < rep.nrGroups; ++g) {
+        if (index + lengths[g] > values.size()) {
+            throw Exception("GRIB2 complex packing groups are too long");
+        }
+        for (std::size_t i = 0; i < lengths[g]; ++i) {
+            values[index++] =
+              std::int64_t(references[g] + reader.read(widths[g]));
+        }
+    }
+    if (index != values.size()) {
+        throw Exception("GRIB2 complex packing groups are too short");
+    }
+
+    // Undo the spatial differencing
+    std::size_t order = rep.differencingOrder;
+    if (rep.templateNumber == 3 && values.size() >= order) {
+        for (std::size_t i = 0; i < order; ++i) {
+            values[i] = first[i];
+        }
+        for (std::size_t i = order; i < values.size(); ++i) {
+            if (order == 1) {
+                values[i] += minimum + values[i - 1];
+            } else {
+                values[i] += minimum + 2 * values[i - 1] - values[i - 2];
+            }
+        }
+    }
+}
+
+Grib2Field
+unpack(const Product& product,
+       const Grid& grid,
+       const Representation& rep,
+       const std::uint8_t* data,
+       std::size_t size)
+{
+    if (!grid.supported) {
+        throw Exception("Unsupported GRIB2 grid definition");
+    }
+    if (rep.nrPoints != grid.nrPoints) {
+        throw Exception("GRIB2 data points don't match grid points");
+    }
+
+    std::vector<std::int64_t> packed(rep.nrPoints);
+    switch (rep.templateNumber) {
+        case 0:
+            unpackSimple(rep, data, size, packed);
+            break;
+        case 2:
+        case 3:
+            unpackComplex(rep, data, size, packed);
+            break;
+        default:
+            throw Exception("Unsupported GRIB2 data representation " +
+                            std::to_string(rep.templateNumber));
+    }
+
+    // Grid axis, the space always go from south to north and west to east
+    bool iNegative = (grid.scanningMode & 0x80) != 0;
+    bool jPositive = (grid.scanningMode & 0x40) != 0;
+    bool jConsecutive = (grid.scanningMode & 0x20) != 0;
+    double lonStart = iNegative ? grid.lo2 : grid.lo1;
+
+    // Longitudes are normalized in [-180, 180[ like NVector::toLatLon.
+    // Columns of a global grid are rotated to start at the westernmost
+    // normalized longitude and the first one is repeated at +360 so the
+    // seam between the last and the first column is interpolated.
+    lonStart = std::fmod(lonStart + 180., 360.);
+    lonStart = (lonStart < 0. ? lonStart + 360. : lonStart) - 180.;
+    bool global = std::abs(double(grid.ni) * grid.di - 360.) < 1e-3 * grid.di;
+    std::size_t nrLon = grid.ni;
+    std::size_t rotation = 0;
+    if (global) {
+        rotation = std::size_t(std::ceil((-180. - lonStart) / grid.di -
+                                         1e-6 + double(grid.ni))) %
+                   grid.ni;
+        lonStart += double(rotation) * grid.di;
+        if (lonStart >= 180.) {
+            lonStart -= 360.;
+        }
+        ++nrLon;
+    } else if (lonStart + double(grid.ni - 1) * grid.di > 180.) {
+        throw Exception("GRIB2 grid crossing the antimeridian is not "
+                        "supported");
+    }
+
+    Grib2Field field(
+      product.header,
+      safeMakeLinearSpace(latitude_t(std::min(grid.la1, grid.la2) * DEG_TO_RAD),
+                          latitude_t(grid.dj * DEG_TO_RAD),
+                          grid.nj),
+      safeMakeLinearSpace(longitude_t(lonStart * DEG_TO_RAD),
+                          longitude_t(grid.di * DEG_TO_RAD),
+                          nrLon));
+
+    // Y = (R + X * 2^E) / 10^D
+    double reference = double(rep.reference);
+    double binaryScale = std::pow(2., double(rep.binaryScale));
+    double decimalScale = std::pow(10., -double(rep.decimalScale));
+    field.values.resize(grid.nj * nrLon);
+    for (std::size_t k = 0; k < packed.size(); ++k) {
+        std::size_t i = jConsecutive ? k / grid.nj : k % grid.ni;
+        std::size_t j = jConsecutive ? k % grid.nj : k / grid.ni;
+        std::size_t lon = iNegative ? grid.ni - 1 - i : i;
+        lon = (lon + grid.ni - rotation) % grid.ni;
+        std::size_t lat = jPositive ? j : grid.nj - 1 - j;
+        field.values[lat + lon * grid.nj] = float(
+          (reference + double(packed[k]) * binaryScale) * decimalScale);
+    }
+    if (global) {
+        std::copy(field.values.begin(),
+                  field.values.begin() + std::ptrdiff_t(grid.nj),
+                  field.values.end() - std::ptrdiff_t(grid.nj));
+    }
+    return field;
+}
+
+}
+
+bool
+readGrib2Message(std::istream& in, std::vector<std::uint8_t>& message)
+{
+    // Look for the "GRIB" indicator
+    const char indicator[] = { 'G', 'R', 'I', 'B' };
+    std::size_t matched = 0;
+    int c;
+    while (matched < 4 && (c = in.get()) != std::char_traits<char>::eof()) {
+        if (char(c) == indicator[matched]) {
+            ++matched;
+        } else {
+            matched = (char(c) == indicator[0]) ? 1 : 0;
+        }
+    }
+    if (matched == 0 && !in) {
+        return false;
+    }
+    if (matched < 4) {
+        throw Exception("Truncated GRIB2 indicator section");
+    }
+
+    std::uint8_t section0[16] = { 'G', 'R', 'I', 'B' };
+    if (!in.read(reinterpret_cast<char*>(section0 + 4), 12)) {
+        throw Exception("Truncated GRIB2 indicator section");
+    }
+    if (u8(section0, 8) != 2) {
+        throw Exception("Only GRIB edition 2 is supported");
+    }
+
+    std::uint64_t length = u64(section0, 9);
+    if (length < 16 + 4) {
+        throw Exception("Invalid GRIB2 message length");
+    }
+    message.resize(length);
+    std::copy(std::begin(section0), std::end(section0), message.begin());
+    if (!in.read(reinterpret_cast<char*>(message.data() + 16),
+                 std::streamsize(length - 16))) {
+        throw Exception("Truncated GRIB2 message");
+    }
+    return true;
+}
+
+std::vector<Grib2Field>
+decodeGrib2Message(const std::uint8_t* data,
+                   std::size_t size,
+                   const Grib2FieldFilter& filter)
+{
+    if (size < 16 || std::memcmp(data, "GRIB", 4) != 0 || u8(data, 8) != 2 ||
+        u64(data, 9) != size) {
+        throw Exception("Invalid GRIB2 message");
+    }
+    std::uint8_t discipline = std::uint8_t(u8(data, 7));
+
+    std::vector<Grib2Field> fields;
+    Grid grid;
+    Product product;
+    std::optional<Representation> rep;
+    bool accepted = false;
+
+    // Sections 2 to 7 can be repeated, each section 7 end a field
+    std::size_t pos = 16;
+    while (pos + 4 <= size) {
+        const std::uint8_t* s = data + pos;
+        if (std::memcmp(s, "7777", 4) == 0) {
+            return fields;
+        }
+        if (pos + 5 > size) {
+            break;
+        }
+
+        std::size_t length = u32(s, 1);
+        if (length < 5 || pos + length > size) {
+            throw Exception("Invalid GRIB2 section length");
+        }
+
+        switch (u8(s, 5)) {
+            case 3:
+                grid = parseGrid(s, length);
+                break;
+            case 4:
+                product = parseProduct(s, length, discipline);
+                accepted = product.supported &&
+                           (!filter || filter(product.header));
+                break;
+            case 5:
+                if (accepted) {
+                    rep = parseRepresentation(s, length);
+                }
+                break;
+            case 6:
+                if (accepted && length >= 6 && u8(s, 6) != 255) {
+                    throw Exception("GRIB2 bitmap unsupported");
+                }
+                break;
+            case 7:
+                if (accepted) {
+                    if (!rep) {
+                        throw Exception("GRIB2 data without representation");
+                    }
+                    fields.emplace_back(
+                      unpack(product, grid, *rep, s + 5, length - 5));
+                }
+                accepted = false;
+                break;
+            default:
+                break;
+        }
+        pos += length;
+    }
+    throw Exception("GRIB2 end section not found");
+}
+
+void
+decodeGrib2Stream(std::istream& in,
+                  const Grib2FieldFilter& filter,
+                  const Grib2FieldCallback& callback,
+                  std::size_t nrThreads)
+{
+    if (nrThreads == 0) {
+        nrThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    std::mutex callbackMutex;
+    auto decode = [&](const std::vector<std::uint8_t>& message) {
+        auto fields =
+          decodeGrib2Message(message.data(), message.size(), filter);
+        std::lock_guard<std::mutex> lock(callbackMutex);
+        for (auto& field : fields) {
+            callback(std::move(field));
+        }
+    };
+
+    if (nrThreads == 1) {
+        std::vector<std::uint8_t> message;
+        while (readGrib2Message(in, message)) {
+            decode(message);
+        }
+        return;
+    }
+
+    // Bounded queue between the reading thread and the decoding threads
+    std::mutex queueMutex;
+    std::condition_variable queueCond;
+    std::deque<std::vector<std::uint8_t>> queue;
+    bool done = false;
+    std::exception_ptr error;
+    const std::size_t maxQueueSize = 2 * nrThreads;
+
+    auto worker = [&]() {
+        for (;;) {
+            std::vector<std::uint8_t> message;
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                queueCond.wait(lock, [&]() { return done || !queue.empty(); });
+                if (queue.empty()) {
+                    return;
+                }
+                message = std::move(queue.front());
+                queue.pop_front();
+            }
+            queueCond.notify_all();
+
+            try {
+                decode(message);
+            } catch (...) {
+                {
+                    std::lock_guard<std::mutex> lock(queueMutex);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                    done = true;
+                    queue.clear();
+                }
+                queueCond.notify_all();
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < nrThreads; ++i) {
+        threads.emplace_back(worker);
+    }
+
+    try {
+        std::vector<std::uint8_t> message;
+        while (readGrib2Message(in, message)) {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCond.wait(
+              lock, [&]() { return done || queue.size() < maxQueueSize; });
+            if (done) {
+                break;
+            }
+            queue.emplace_back(std::move(message));
+            lock.unlock();
+            queueCond.notify_all();
+        }
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (!error) {
+            error = std::current_exception();
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        done = true;
+    }
+    queueCond.notify_all();
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+namespace {
+
+/// \return Slice of \p time in \p timeSpace or nullopt
+std::optional<std::size_t>
+sliceIndex(const LinearSpace<time_t>& timeSpace, time_t time)
+{
+    double index = ((time - timeSpace.start()) / timeSpace.delta()).t;
+    double rounded = std::round(index);
+    if (std::abs(index - rounded) > 1e-6 || rounded < 0. ||
+        rounded >= double(timeSpace.nrPoints())) {
+        return std::nullopt;
+    }
+    return std::size_t(rounded);
+}
+
+/// \return Slice of \p time in \p timeSpace or nullopt
+std::optional<std::size_t>
+sliceIndex(const NonUniformSpace<time_t>& timeSpace, time_t time)
+{
+    std::size_t index = timeSpace.safeIndex(time);
+    for (std::size_t i = index; i < std::min(index + 2, timeSpace.nrPoints());
+         ++i) {
+        if (std::abs((timeSpace.value(i) - time).t) < 1e-3) {
+            return i;
+        }
+    }
+    return std::nullopt;
+}
+
+bool
+sameSpace(const LinearSpace<latitude_t>& a,
+          const LinearSpace<latitude_t>& b) noexcept
+{
+    return a.nrPoints() == b.nrPoints() &&
+           std::abs((a.start() - b.start()).t) < 1e-9 &&
+           std::abs((a.delta() - b.delta()).t) < 1e-9;
+}
+
+bool
+sameSpace(const LinearSpace<longitude_t>& a,
+          const LinearSpace<longitude_t>& b) noexcept
+{
+    return a.nrPoints() == b.nrPoints() &&
+           std::abs((a.start() - b.start()).t) < 1e-9 &&
+           std::abs((a.delta() - b.delta()).t) < 1e-9;
+}
+
+bool
+isWind(const Grib2FieldHeader& header)
+{
+    return header.isWindU10m() || header.isWindV10m();
+}
+
+}
+
+void
+decodeGrib2Wind(std::istream& in,
+                ForecastWriter& writer,
+                std::size_t nrThreads)
+{
+    const auto& header = writer.header();
+    auto timeSpace = header.timeSpace();
+    auto latSpace = header.latSpace();
+    auto lonSpace = header.lonSpace();
+
+    decodeGrib2Stream(
+      in,
+      isWind,
+      [&](Grib2Field&& field) {
+          auto slice = sliceIndex(timeSpace, field.header.forecastTime);
+          if (!slice) {
+              return;
+          }
+          if (!sameSpace(field.latSpace, latSpace) ||
+              !sameSpace(field.lonSpace, lonSpace)) {
+              throw Exception("GRIB2 grid don't match forecast grid");
+          }
+          writer.write(*slice,
+                       field.header.isWindU10m() ? ForecastWriter::Component::U
+                                                 : ForecastWriter::Component::V,
+                       field.values.data());
+      },
+      nrThreads);
+}
+
+TimeWorldMap
+decodeGrib2Wind(std::istream& in,
+                const NonUniformSpace<time_t>& timeSpace,
+                std::size_t nrThreads)
+{
+    struct Slice
+    {
+        std::vector<float> u;
+        std::vector<float> v;
+        std::optional<WorldMapGrid> grid;
+    };
+    std::vector<Slice> slices(timeSpace.nrPoints());
+    std::optional<LinearSpace<latitude_t>> latSpace;
+    std::optional<LinearSpace<longitude_t>> lonSpace;
+
+    decodeGrib2Stream(
+      in,
+      isWind,
+      [&](Grib2Field&& field) {
+          auto index = sliceIndex(timeSpace, field.header.forecastTime);
+          if (!index) {
+              return;
+          }
+          if (!latSpace) {
+              latSpace = field.latSpace;
+              lonSpace = field.lonSpace;
+          } else if (!sameSpace(field.latSpace, *latSpace) ||
+                     !sameSpace(field.lonSpace, *lonSpace)) {
+              throw Exception("GRIB2 fields don't share the same grid");
+          }
+
+          auto& slice = slices[*index];
+          if (field.header.isWindU10m()) {
+              slice.u = std::move(field.values);
+          } else {
+              slice.v = std::move(field.values);
+          }
+          if (slice.u.empty() || slice.v.empty()) {
+              return;
+          }
+
+          // Both components are available, fill the builder
+          std::size_t nrLat = latSpace->nrPoints();
+          WorldMapGridBuilder builder(*latSpace, *lonSpace);
+          for (std::size_t lon = 0; lon < lonSpace->nrPoints(); ++lon) {
+              for (std::size_t lat = 0; lat < nrLat; ++lat) {
+                  std::size_t i = lat + lon * nrLat;
+                  WindVector wind(velocity_t(slice.u[i]),
+                                  velocity_t(slice.v[i]));
+                  builder(lat, lon) =
+                    WorldMapData(wind.bearing(), wind.velocity());
+              }
+          }
+          slice.grid = std::move(builder).build();
+          slice.u = std::vector<float>();
+          slice.v = std::vector<float>();
+      },
+      nrThreads);
+
+    TimeWorldMapBuilder builder(timeSpace);
+    for (auto& slice : slices) {
+        if (!slice.grid) {
+            throw Exception("Missing GRIB2 wind slice");
+        }
+        builder.add(WorldMap(std::move(*slice.grid)));
+    }
+    return std::move(builder).build();
+}
+
+}
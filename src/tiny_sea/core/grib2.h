@@ -0,0 +1,156 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+// includes
+// std
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <vector>
+
+// tiny_sea
+#include <tiny_sea/core/linear_space.h>
+#include <tiny_sea/core/non_uniform_space.h>
+#include <tiny_sea/core/units.h>
+#include <tiny_sea/fwd.h>
+
+namespace tiny_sea {
+
+/*! Identification of a GRIB2 field.
+ * Available before the field values are unpacked.
+ */
+struct Grib2FieldHeader
+{
+    std::uint8_t discipline = 0;  //< Table 0.0
+    std::uint8_t category = 0;    //< Table 4.1
+    std::uint8_t number = 0;      //< Table 4.2
+    std::uint8_t surfaceType = 0; //< Table 4.5, first fixed surface
+    double surfaceValue = 0.;     //< First fixed surface value
+    time_t forecastTime = time_t(0.); //< Lead time from the reference time
+
+    /// \return true for the 10 m above ground u wind component (UGRD)
+    bool isWindU10m() const noexcept
+    {
+        return isWind10m() && number == 2;
+    }
+
+    /// \return true for the 10 m above ground v wind component (VGRD)
+    bool isWindV10m() const noexcept
+    {
+        return isWind10m() && number == 3;
+    }
+
+private:
+    bool isWind10m() const noexcept
+    {
+        return discipline == 0 && category == 2 && surfaceType == 103 &&
+               surfaceValue == 10.;
+    }
+};
+
+/*! GRIB2 field decoded on a regular latitude/longitude grid.
+ * Values are ordered latitude first, like ForecastWriter input: the value of
+ * the (lat, lon) node is values[lat + lon * latSpace.nrPoints()], whatever
+ * the GRIB2 scanning mode was.
+ */
+struct Grib2Field
+{
+    Grib2Field(const Grib2FieldHeader& p_header,
+               const LinearSpace<latitude_t>& p_latSpace,
+               const LinearSpace<longitude_t>& p_lonSpace)
+      : header(p_header)
+      , latSpace(p_latSpace)
+      , lonSpace(p_lonSpace)
+    {}
+
+    Grib2FieldHeader header;
+    LinearSpace<latitude_t> latSpace;  //< Radian, south to north
+    LinearSpace<longitude_t> lonSpace; //< Radian, west to east from [-PI, PI[
+    std::vector<float> values;
+};
+
+/// Select fields to unpack from their header
+using Grib2FieldFilter = std::function<bool(const Grib2FieldHeader&)>;
+
+/// Receive decoded fields
+using Grib2FieldCallback = std::function<void(Grib2Field&&)>;
+
+/*! Read the next GRIB2 message of \p in.
+ * Bytes before the "GRIB" indicator are skipped.
+ * \param[out] message Whole message, from "GRIB" to "7777".
+ * \return false at the end of the stream.
+ * \throw Exception on truncated or non GRIB2 message.
+ */
+bool
+readGrib2Message(std::istream& in, std::vector<std::uint8_t>& message);
+
+/*! Decode all fields of a GRIB2 message.
+ * Supported grid is the regular latitude/longitude grid (template 3.0),
+ * longitudes are normalized in [-180, 180[ degrees. Global grids are
+ * rotated to start at their westernmost column and this column is repeated
+ * 360 degrees east to close the seam. Regional grids crossing the
+ * antimeridian are rejected. Supported packings are simple packing
+ * (template 5.0) and complex packing with or without spatial differencing
+ * (templates 5.2 and 5.3).
+ * \param filter Only fields accepted by \p filter are unpacked, others are
+ * skipped without looking at their grid or data. Accept all if empty.
+ * \throw Exception on invalid message or unsupported template of an accepted
+ * field.
+ */
+std::vector<Grib2Field>
+decodeGrib2Message(const std::uint8_t* data,
+                   std::size_t size,
+                   const Grib2FieldFilter& filter = Grib2FieldFilter());
+
+/*! Decode all messages of \p in.
+ * The calling thread read messages one by one and \p nrThreads workers
+ * decode them, only a few messages are in memory at the same time.
+ * \p callback is called for each accepted field, never concurrently, in no
+ * particular order.
+ * \param nrThreads Number of decoding threads, 0 to use one by core.
+ * \throw Exception on the first decoding error.
+ */
+void
+decodeGrib2Stream(std::istream& in,
+                  const Grib2FieldFilter& filter,
+                  const Grib2FieldCallback& callback,
+                  std::size_t nrThreads = 0);
+
+/*! Decode 10 m u/v wind of \p in into a forecast file.
+ * Field lead times are matched against the \p writer time space, fields out
+ * of this space are ignored.
+ * \throw Exception if a field grid don't match the \p writer grid.
+ */
+void
+decodeGrib2Wind(std::istream& in,
+                ForecastWriter& writer,
+                std::size_t nrThreads = 0);
+
+/*! Decode 10 m u/v wind of \p in into a TimeWorldMap.
+ * Each slice is filled in a WorldMapGridBuilder as soon as both components
+ * are decoded. Fields out of \p timeSpace are ignored, \p timeSpace can
+ * follow the provider steps, like hourly then 3-hourly.
+ * \throw Exception if fields don't share the same grid or a slice is
+ * missing.
+ */
+TimeWorldMap
+decodeGrib2Wind(std::istream& in,
+                const NonUniformSpace<time_t>& timeSpace,
+                std::size_t nrThreads = 0);
+
+}
@@ -0,0 +1,217 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// associated header
+#include <tiny_sea/core/land_mask.h>
+
+// includes
+// std
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// tiny_sea
+#include <tiny_sea/core/exception.h>
+#include <tiny_sea/core/n_vector.h>
+
+namespace tiny_sea {
+
+LandMask::LandMask(const LinearSpace<latitude_t>& latSpace,
+                   const LinearSpace<longitude_t>& lonSpace,
+                   const std::vector<bool>& blocked)
+  : m_latSpace(latSpace)
+  , m_lonSpace(lonSpace)
+{
+    std::size_t nx = latSpace.nrPoints();
+    std::size_t ny = lonSpace.nrPoints();
+    if (blocked.size() != nx * ny) {
+        throw Exception("Land mask size don't match its spaces");
+    }
+
+    m_levels.push_back(makeLevel(nx, ny));
+    for (std::size_t y = 0; y < ny; ++y) {
+        for (std::size_t x = 0; x < nx; ++x) {
+            if (blocked[x + y * nx]) {
+                set(m_levels.front(), x, y);
+            }
+        }
+    }
+    buildPyramid();
+}
+
+LandMask
+LandMask::fromDepth(const LinearSpace<latitude_t>& latSpace,
+                    const LinearSpace<longitude_t>& lonSpace,
+                    const std::vector<float>& depth,
+                    meter_t minDepth)
+{
+    std::vector<bool> blocked(depth.size());
+    for (std::size_t i = 0; i < depth.size(); ++i) {
+        blocked[i] = double(depth[i]) < minDepth.t;
+    }
+    return LandMask(latSpace, lonSpace, blocked);
+}
+
+bool
+LandMask::blocked(const NVector& pos) const noexcept
+{
+    Rect rect;
+    return bound(&pos, 1, rect) && test(m_levels.front(), rect.x0, rect.y0);
+}
+
+bool
+LandMask::blocked(const NVector& from, const NVector& to) const noexcept
+{
+    return blocked(from, to, 0);
+}
+
+std::size_t
+LandMask::memory() const noexcept
+{
+    std::size_t res = 0;
+    for (const auto& level : m_levels) {
+        res += level.bits.size() * sizeof(std::uint64_t);
+    }
+    return res;
+}
+
+void
+LandMask::buildPyramid()
+{
+    while (m_levels.back().nx > 1 || m_levels.back().ny > 1) {
+        const Level& prev = m_levels.back();
+        Level level = makeLevel((prev.nx + 1) / 2, (prev.ny + 1) / 2);
+        for (std::size_t y = 0; y < prev.ny; ++y) {
+            for (std::size_t x = 0; x < prev.nx; ++x) {
+                if (test(prev, x, y)) {
+                    set(level, x / 2, y / 2);
+                }
+            }
+        }
+        m_levels.push_back(std::move(level));
+    }
+}
+
+bool
+LandMask::bound(const NVector* pos, std::size_t size, Rect& rect) const
+  noexcept
+{
+    double minX = std::numeric_limits<double>::max();
+    double maxX = std::numeric_limits<double>::lowest();
+    double minY = minX;
+    double maxY = maxX;
+    for (std::size_t i = 0; i < size; ++i) {
+        auto latLon = pos[i].toLatLon();
+        // Pixel coordinates, pixel i cover [i, i + 1[
+        double x =
+          ((latLon.first - m_latSpace.start()) / m_latSpace.delta()).t + 0.5;
+        double y =
+          ((latLon.second - m_lonSpace.start()) / m_lonSpace.delta()).t + 0.5;
+        minX = std::min(minX, x);
+        maxX = std::max(maxX, x);
+        minY = std::min(minY, y);
+        maxY = std::max(maxY, y);
+    }
+
+    double nx = double(m_levels.front().nx);
+    double ny = double(m_levels.front().ny);
+    if (maxX < 0. || minX >= nx || maxY < 0. || minY >= ny) {
+        return false;
+    }
+    rect.x0 = std::size_t(std::max(minX, 0.));
+    rect.x1 = std::size_t(std::min(maxX, nx - 1.));
+    rect.y0 = std::size_t(std::max(minY, 0.));
+    rect.y1 = std::size_t(std::min(maxY, ny - 1.));
+    return true;
+}
+
+bool
+LandMask::blocked(const Rect& rect) const noexcept
+{
+    // Smallest level where rect cover at most 2x2 pixels
+    std::size_t level = 0;
+    while (((rect.x1 >> level) - (rect.x0 >> level)) > 1 ||
+           ((rect.y1 >> level) - (rect.y0 >> level)) > 1) {
+        ++level;
+    }
+
+    for (std::size_t y = rect.y0 >> level; y <= (rect.y1 >> level); ++y) {
+        for (std::size_t x = rect.x0 >> level; x <= (rect.x1 >> level); ++x) {
+            if (blocked(level, x, y, rect)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool
+LandMask::blocked(std::size_t level,
+                  std::size_t x,
+                  std::size_t y,
+                  const Rect& rect) const noexcept
+{
+    if (!test(m_levels[level], x, y)) {
+        return false;
+    }
+    if (level == 0) {
+        return true;
+    }
+
+    // Refine children intersecting rect
+    const Level& child = m_levels[level - 1];
+    std::size_t childSize = std::size_t(1) << (level - 1);
+    for (std::size_t cy = 2 * y; cy < std::min(2 * y + 2, child.ny); ++cy) {
+        std::size_t y0 = cy * childSize;
+        if (y0 > rect.y1 || y0 + childSize - 1 < rect.y0) {
+            continue;
+        }
+        for (std::size_t cx = 2 * x; cx < std::min(2 * x + 2, child.nx);
+             ++cx) {
+            std::size_t x0 = cx * childSize;
+            if (x0 > rect.x1 || x0 + childSize - 1 < rect.x0) {
+                continue;
+            }
+            if (blocked(level - 1, cx, cy, rect)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool
+LandMask::blocked(const NVector& from,
+                  const NVector& to,
+                  std::size_t subdivision) const noexcept
+{
+    NVector mid((from.toEigen() + to.toEigen()).normalized());
+    const NVector points[] = { from, mid, to };
+
+    Rect rect;
+    if (!bound(points, 3, rect) || !blocked(rect)) {
+        return false;
+    }
+    // Step inside a single blocked pixel, or too small to be refined
+    if ((rect.x0 == rect.x1 && rect.y0 == rect.y1) ||
+        subdivision == MAX_SUBDIVISIONS) {
+        return true;
+    }
+    return blocked(from, mid, subdivision + 1) ||
+           blocked(mid, to, subdivision + 1);
+}
+
+}
@@ -0,0 +1,168 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+// includes
+// std
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+// tiny_sea
+#include <tiny_sea/core/linear_space.h>
+#include <tiny_sea/core/units.h>
+#include <tiny_sea/fwd.h>
+
+namespace tiny_sea {
+
+/*! Static raster of blocked (land or too shallow) pixels.
+ *
+ * Pixel (x, y) is centered on the node (latSpace.value(x),
+ * lonSpace.value(y)) and cover half a delta around it. Positions outside
+ * the raster are not blocked.
+ *
+ * Pixels are bit-packed, 64 latitudes by word. An occupancy pyramid is
+ * built on top of it: a pixel of level l is blocked if one of the 2x2
+ * pixels it cover at level l - 1 is blocked. A region is tested on the
+ * level where it cover at most 2x2 pixels, then only blocked pixels are
+ * refined, so a free region cost a few word reads.
+ */
+class LandMask
+{
+public:
+    /// Maximum number of great circle step subdivisions
+    static constexpr std::size_t MAX_SUBDIVISIONS = 24;
+
+public:
+    /*! Create a LandMask from blocked pixels.
+     * \param blocked Pixels stored with the x + y*latSpace.nrPoints()
+     * layout.
+     * \throw Exception if \p blocked size doesn't match the spaces.
+     */
+    LandMask(const LinearSpace<latitude_t>& latSpace,
+             const LinearSpace<longitude_t>& lonSpace,
+             const std::vector<bool>& blocked);
+
+    /*! Create a LandMask from a depth raster.
+     * \param depth Pixels depth, negative or null on land, with the
+     * x + y*latSpace.nrPoints() layout.
+     * \param minDepth Pixels with a depth lower than \p minDepth are blocked.
+     * \throw Exception if \p depth size doesn't match the spaces.
+     */
+    static LandMask fromDepth(const LinearSpace<latitude_t>& latSpace,
+                              const LinearSpace<longitude_t>& lonSpace,
+                              const std::vector<float>& depth,
+                              meter_t minDepth);
+
+    /*! Getter from pixel index.
+     * \warning \p x and \p y must be valid index.
+     */
+    bool operator()(std::size_t x, std::size_t y) const noexcept
+    {
+        return test(m_levels.front(), x, y);
+    }
+
+    /// \return true if the pixel containing \p pos is blocked
+    bool blocked(const NVector& pos) const noexcept;
+
+    /*! Test if the great circle step from \p from to \p to cross a blocked
+     * pixel.
+     * The step is subdivided at its middle point until each part cover a
+     * free region or a single pixel. Each part is bounded by its two end
+     * points and its middle point.
+     * \return true if the step is blocked
+     */
+    bool blocked(const NVector& from, const NVector& to) const noexcept;
+
+    const LinearSpace<latitude_t>& latSpace() const noexcept
+    {
+        return m_latSpace;
+    }
+
+    const LinearSpace<longitude_t>& lonSpace() const noexcept
+    {
+        return m_lonSpace;
+    }
+
+    /// Number of pyramid levels, level 0 is the full resolution
+    std::size_t nrLevels() const noexcept { return m_levels.size(); }
+
+    /// Memory used by the pyramid in bytes
+    std::size_t memory() const noexcept;
+
+private:
+    struct Level
+    {
+        std::size_t nx, ny, nrWords;
+        std::vector<std::uint64_t> bits;
+    };
+
+    /// Inclusive pixel rectangle at level 0
+    struct Rect
+    {
+        std::size_t x0, x1, y0, y1;
+    };
+
+    static Level makeLevel(std::size_t nx, std::size_t ny)
+    {
+        std::size_t nrWords = (nx + 63) / 64;
+        return Level{
+            nx, ny, nrWords, std::vector<std::uint64_t>(nrWords * ny)
+        };
+    }
+
+    static bool test(const Level& level, std::size_t x, std::size_t y) noexcept
+    {
+        assert(x < level.nx && y < level.ny);
+        return (level.bits[y * level.nrWords + x / 64] >> (x % 64)) & 1u;
+    }
+
+    static void set(Level& level, std::size_t x, std::size_t y) noexcept
+    {
+        assert(x < level.nx && y < level.ny);
+        level.bits[y * level.nrWords + x / 64] |= std::uint64_t(1) << (x % 64);
+    }
+
+    /// Build all the pyramid levels from level 0
+    void buildPyramid();
+
+    /*! Pixel rectangle bounding \p pos.
+     * \return false if all the points are outside the raster
+     */
+    bool bound(const NVector* pos, std::size_t size, Rect& rect) const
+      noexcept;
+
+    /// \return true if one pixel of \p rect is blocked
+    bool blocked(const Rect& rect) const noexcept;
+
+    /// Refine cell (\p x, \p y) of \p level restricted to \p rect
+    bool blocked(std::size_t level,
+                 std::size_t x,
+                 std::size_t y,
+                 const Rect& rect) const noexcept;
+
+    bool blocked(const NVector& from,
+                 const NVector& to,
+                 std::size_t subdivision) const noexcept;
+
+private:
+    LinearSpace<latitude_t> m_latSpace;
+    LinearSpace<longitude_t> m_lonSpace;
+    std::vector<Level> m_levels;
+};
+
+}
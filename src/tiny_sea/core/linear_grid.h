@@ -18,15 +18,23 @@
 
 // includes
 // std
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <cstdint>
 #include <sstream>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 // tiny_sea
 #include <tiny_sea/core/interpolator.h>
 #include <tiny_sea/core/linear_space.h>
 
+// Eigen
+#include <Eigen/Core>
+
 namespace tiny_sea {
 
 namespace internal {
@@ -41,6 +49,15 @@ index2D(const XUnit& xSpace,
     return x + y * (xSpace.nrPoints() + 1);
 }
 
+/// Floating point values linearly interpolated can use Eigen batch kernels
+template<typename DataType, typename Interpolator>
+struct IsVectorizable
+  : std::integral_constant<
+      bool,
+      std::is_floating_point<DataType>::value &&
+        std::is_same<Interpolator, NumericInterpolator<DataType>>::value>
+{};
+
 template<typename XUnit, typename YUnit>
 inline void
 checkIndex2D(const XUnit& xSpace,
@@ -56,8 +73,101 @@ checkIndex2D(const XUnit& xSpace,
     }
 }
 
+/// Spread the 32 low bits of \p v on the even bits of the result
+inline std::uint64_t
+spreadBits(std::uint64_t v) noexcept
+{
+    v &= 0xFFFFFFFF;
+    v = (v | (v << 16)) & 0x0000FFFF0000FFFF;
+    v = (v | (v << 8)) & 0x00FF00FF00FF00FF;
+    v = (v | (v << 4)) & 0x0F0F0F0F0F0F0F0F;
+    v = (v | (v << 2)) & 0x3333333333333333;
+    v = (v | (v << 1)) & 0x5555555555555555;
+    return v;
+}
+
 }
 
+/*! LinearGrid values layout policies.
+ * A layout map the (x, y) index of a grid of nrX * nrY stored points to a
+ * value index. Stored points include the duplicated last column and row.
+ * Layout must define:
+ * - static std::size_t size(std::size_t nrX, std::size_t nrY)
+ * - static std::size_t index(std::size_t nrX, std::size_t nrY,
+ *                            std::size_t x, std::size_t y)
+ */
+
+/// X major layout, same as internal::index2D
+struct RowMajorLayout
+{
+    static std::size_t size(std::size_t nrX, std::size_t nrY) noexcept
+    {
+        return nrX * nrY;
+    }
+
+    static std::size_t index(std::size_t nrX,
+                             std::size_t /* nrY */,
+                             std::size_t x,
+                             std::size_t y) noexcept
+    {
+        return x + y * nrX;
+    }
+};
+
+/*! Square tiles of TileSize * TileSize points.
+ * Tiles are stored X major, and points are stored X major inside a tile.
+ * The four points of a bilinear interpolation are in at most four near
+ * tiles instead of two rows far away on wide grids.
+ */
+template<std::size_t TileSize = 8>
+struct BlockedLayout
+{
+    static_assert(TileSize > 0, "TileSize must be strictly positive");
+
+    static std::size_t size(std::size_t nrX, std::size_t nrY) noexcept
+    {
+        return nrTiles(nrX) * nrTiles(nrY) * TileSize * TileSize;
+    }
+
+    static std::size_t index(std::size_t nrX,
+                             std::size_t /* nrY */,
+                             std::size_t x,
+                             std::size_t y) noexcept
+    {
+        std::size_t tile = x / TileSize + (y / TileSize) * nrTiles(nrX);
+        return tile * TileSize * TileSize + x % TileSize +
+               (y % TileSize) * TileSize;
+    }
+
+    static std::size_t nrTiles(std::size_t nrPoints) noexcept
+    {
+        return (nrPoints + TileSize - 1) / TileSize;
+    }
+};
+
+/*! Z-order (Morton) layout.
+ * x and y bits are interleaved, near points in both directions are near in
+ * memory at every scale.
+ * \warning Storage is padded to the Morton index of the last point, up to
+ * 2 times the number of points on square grids and more on narrow grids.
+ */
+struct MortonLayout
+{
+    static std::size_t size(std::size_t nrX, std::size_t nrY) noexcept
+    {
+        return index(nrX, nrY, nrX - 1, nrY - 1) + 1;
+    }
+
+    static std::size_t index(std::size_t /* nrX */,
+                             std::size_t /* nrY */,
+                             std::size_t x,
+                             std::size_t y) noexcept
+    {
+        return std::size_t(internal::spreadBits(x) |
+                           (internal::spreadBits(y) << 1));
+    }
+};
+
 /*! LinearGrid associate a value to all points of two linear space
  * A LinearGrid can be see as follow:
  *
@@ -73,11 +183,14 @@ checkIndex2D(const XUnit& xSpace,
  *  22. is the value associated to x [0  2[ and y [21  22[
  *   5. is the value associated to x [4  6[ and y [20  21[
  *   9. is the value associated to x 6      and y [21  22[
+ *
+ * Values are stored following the Layout policy, RowMajorLayout by default.
  */
 template<typename XUnit,
          typename YUnit,
          typename DataType,
-         typename Interpolator = NumericInterpolator<DataType>>
+         typename Interpolator = NumericInterpolator<DataType>,
+         typename Layout = RowMajorLayout>
 class LinearGrid
 {
 public:
@@ -85,15 +198,19 @@ public:
     using y_value_type = YUnit;
     using value_type = DataType;
     using interpolator_type = Interpolator;
+    using layout_type = Layout;
 
     using x_space_type = LinearSpace<x_value_type>;
     using y_space_type = LinearSpace<y_value_type>;
     using value_container_type = std::vector<value_type>;
 
+    /// Number of points computed at once by the batch interpolation
+    static constexpr std::size_t BATCH_SIZE = 64;
+
 public:
     /*! Create a LinearGrid from two LinearSpace and a vector of values.
-     * \warning \p values must have the \p (xSpace size + 1)*(ySpace size + 1)
-     * size. The last column and row should be duplicated.
+     * \warning \p values must have the \p Layout::size(xSpace size + 1,
+     * ySpace size + 1) size. The last column and row should be duplicated.
      */
     LinearGrid(const x_space_type& xSpace,
                const y_space_type& ySpace,
@@ -102,8 +219,20 @@ public:
       , m_ySpace(ySpace)
       , m_values(values)
     {
-        assert(m_values.size() ==
-               ((m_xSpace.nrPoints() + 1) * (m_ySpace.nrPoints() + 1)));
+        assert(m_values.size() == layout_type::size(m_xSpace.nrPoints() + 1,
+                                                    m_ySpace.nrPoints() + 1));
+    }
+
+    /// Move \p values, \see LinearGrid
+    LinearGrid(const x_space_type& xSpace,
+               const y_space_type& ySpace,
+               value_container_type&& values)
+      : m_xSpace(xSpace)
+      , m_ySpace(ySpace)
+      , m_values(std::move(values))
+    {
+        assert(m_values.size() == layout_type::size(m_xSpace.nrPoints() + 1,
+                                                    m_ySpace.nrPoints() + 1));
     }
 
     /*! Getter from index.
@@ -169,13 +298,67 @@ public:
         return intepolate(resX, resY);
     }
 
+    /*! Batch version of \see safeInterpolated.
+     * Points are processed by block of BATCH_SIZE. Axis weights of a block
+     * are computed first, then floating point values with a
+     * NumericInterpolator have their 4 corners gathered in contiguous
+     * buffers and interpolated with vectorized operations. Other values go
+     * through the interpolator functor.
+     * \param[in] x Array of \p size x values.
+     * \param[in] y Array of \p size y values.
+     * \param[in] size Number of points.
+     * \param[out] res Array of \p size interpolated values.
+     */
+    void safeInterpolated(const x_value_type* x,
+                          const y_value_type* y,
+                          std::size_t size,
+                          value_type* res) const noexcept
+    {
+        std::array<std::size_t, BATCH_SIZE> idxX, idxY;
+        std::array<double, BATCH_SIZE> pX, pY;
+        for (std::size_t start = 0; start < size; start += BATCH_SIZE) {
+            std::size_t n = std::min(BATCH_SIZE, size - start);
+            m_xSpace.safeInterpolationWeights(
+              x + start, n, idxX.data(), pX.data());
+            m_ySpace.safeInterpolationWeights(
+              y + start, n, idxY.data(), pY.data());
+
+            if constexpr (internal::IsVectorizable<value_type,
+                                                   interpolator_type>::value) {
+                using array_type = Eigen::Array<value_type, BATCH_SIZE, 1>;
+                array_type c00, c10, c01, c11, wX, wY;
+                for (std::size_t i = 0; i < n; ++i) {
+                    c00(i) = m_values[safeIndex(idxX[i], idxY[i])];
+                    c10(i) = m_values[safeIndex(idxX[i] + 1, idxY[i])];
+                    c01(i) = m_values[safeIndex(idxX[i], idxY[i] + 1)];
+                    c11(i) = m_values[safeIndex(idxX[i] + 1, idxY[i] + 1)];
+                    wX(i) = value_type(pX[i]);
+                    wY(i) = value_type(pY[i]);
+                }
+                // Only the n first coefficients of the last block are set
+                auto h00 = c00.head(n);
+                auto h01 = c01.head(n);
+                auto y0 = h00 + (c10.head(n) - h00) * wX.head(n);
+                auto y1 = h01 + (c11.head(n) - h01) * wX.head(n);
+                Eigen::Map<Eigen::Array<value_type, Eigen::Dynamic, 1>>(
+                  res + start, Eigen::Index(n)) = y0 + (y1 - y0) * wY.head(n);
+            } else {
+                for (std::size_t i = 0; i < n; ++i) {
+                    res[start + i] = intepolate(
+                      LinearSpaceInterpolationResult(scale_t(pX[i]), idxX[i]),
+                      LinearSpaceInterpolationResult(scale_t(pY[i]), idxY[i]));
+                }
+            }
+        }
+    }
+
     /// X linear space getter
     const x_space_type& xSpace() const noexcept { return m_xSpace; }
 
     /// Y linear space getter
     const y_space_type& ySpace() const noexcept { return m_ySpace; }
 
-    /// Values getter
+    /// Values getter, values are ordered following the Layout policy
     const value_container_type& values() const noexcept { return m_values; }
 
 private:
@@ -187,13 +370,14 @@ private:
         assert(x < m_xSpace.nrPoints());
         assert(y < m_ySpace.nrPoints());
 
-        return internal::index2D(m_xSpace, m_ySpace, x, y);
+        return safeIndex(x, y);
     }
 
     /// \return Value index from linear space index, don't check bounds
     std::size_t safeIndex(std::size_t x, std::size_t y) const noexcept
     {
-        return internal::index2D(m_xSpace, m_ySpace, x, y);
+        return layout_type::index(
+          m_xSpace.nrPoints() + 1, m_ySpace.nrPoints() + 1, x, y);
     }
 
     /// \return Value index from linear space value
@@ -245,7 +429,8 @@ private:
 template<typename XUnit,
          typename YUnit,
          typename DataType,
-         typename Interpolator = NumericInterpolator<DataType>>
+         typename Interpolator = NumericInterpolator<DataType>,
+         typename Layout = RowMajorLayout>
 class LinearGridBuilder
 {
 public:
@@ -253,19 +438,24 @@ public:
     using y_value_type = YUnit;
     using value_type = DataType;
     using interpolator_type = Interpolator;
+    using layout_type = Layout;
 
     using x_space_type = LinearSpace<x_value_type>;
     using y_space_type = LinearSpace<y_value_type>;
     using value_container_type = std::vector<value_type>;
 
-    using linear_grid_type =
-      LinearGrid<x_value_type, y_value_type, value_type, interpolator_type>;
+    using linear_grid_type = LinearGrid<x_value_type,
+                                        y_value_type,
+                                        value_type,
+                                        interpolator_type,
+                                        layout_type>;
 
 public:
     LinearGridBuilder(const x_space_type& x_space, const y_space_type& y_space)
       : m_xSpace(x_space)
       , m_ySpace(y_space)
-      , m_values((m_xSpace.nrPoints() + 1) * (m_ySpace.nrPoints() + 1))
+      , m_values(layout_type::size(m_xSpace.nrPoints() + 1,
+                                   m_ySpace.nrPoints() + 1))
     {}
 
     /*! Getter from index.
@@ -293,30 +483,19 @@ public:
         return m_values[safeIndex(x, y)];
     }
 
-    linear_grid_type build() const noexcept
+    /// Build a LinearGrid with a copy of the values
+    linear_grid_type build() const&
     {
-        // The last column and the last row of m_values is considered mutable.
-        // Since is not possible to do that in C++ we use const_cast.
-        value_container_type& mut_v =
-          const_cast<value_container_type&>(m_values);
-
-        // Fill last column
-        {
-            std::size_t lastX = m_xSpace.nrPoints();
-            for (std::size_t y = 0; y < m_ySpace.nrPoints(); ++y) {
-                mut_v[safeIndex(lastX, y)] = mut_v[safeIndex(lastX - 1, y)];
-            }
-        }
-
-        // Fill last row
-        {
-            std::size_t lastY = m_ySpace.nrPoints();
-            for (std::size_t x = 0; x < m_xSpace.nrPoints() + 1; ++x) {
-                mut_v[safeIndex(x, lastY)] = mut_v[safeIndex(x, lastY - 1)];
-            }
-        }
+        value_container_type values(m_values);
+        fillEdges(values);
+        return linear_grid_type(m_xSpace, m_ySpace, std::move(values));
+    }
 
-        return linear_grid_type(m_xSpace, m_ySpace, m_values);
+    /// Build a LinearGrid by moving the values out of the builder
+    linear_grid_type build() &&
+    {
+        fillEdges(m_values);
+        return linear_grid_type(m_xSpace, m_ySpace, std::move(m_values));
     }
 
 private:
@@ -327,12 +506,33 @@ private:
         assert(x < m_xSpace.nrPoints());
         assert(y < m_ySpace.nrPoints());
 
-        return internal::index2D(m_xSpace, m_ySpace, x, y);
+        return safeIndex(x, y);
     }
 
     std::size_t safeIndex(std::size_t x, std::size_t y) const noexcept
     {
-        return internal::index2D(m_xSpace, m_ySpace, x, y);
+        return layout_type::index(
+          m_xSpace.nrPoints() + 1, m_ySpace.nrPoints() + 1, x, y);
+    }
+
+    /// Duplicate the last column and the last row of \p values
+    void fillEdges(value_container_type& values) const noexcept
+    {
+        // Fill last column
+        {
+            std::size_t lastX = m_xSpace.nrPoints();
+            for (std::size_t y = 0; y < m_ySpace.nrPoints(); ++y) {
+                values[safeIndex(lastX, y)] = values[safeIndex(lastX - 1, y)];
+            }
+        }
+
+        // Fill last row
+        {
+            std::size_t lastY = m_ySpace.nrPoints();
+            for (std::size_t x = 0; x < m_xSpace.nrPoints() + 1; ++x) {
+                values[safeIndex(x, lastY)] = values[safeIndex(x, lastY - 1)];
+            }
+        }
     }
 
 private:
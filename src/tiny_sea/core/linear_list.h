@@ -18,9 +18,12 @@
 
 // includes
 // std
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <sstream>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
 // tiny_sea
@@ -65,10 +68,13 @@ checkIndex1D(const XUnit& xSpace, std::size_t x)
  * 20. is the value associated to the range [3.5  4. [
  * 33. is the value associated to the range [4.   4.5[
  * 11. is the value associated to 4.5
+ *
+ * \tparam XSpace LinearSpace or NonUniformSpace.
  */
 template<typename XUnit,
          typename DataType,
-         typename Interpolator = NumericInterpolator<DataType>>
+         typename Interpolator = NumericInterpolator<DataType>,
+         typename XSpace = LinearSpace<XUnit>>
 class LinearList
 {
 public:
@@ -76,11 +82,14 @@ public:
     using value_type = DataType;
     using interpolator_type = Interpolator;
 
-    using x_space_type = LinearSpace<x_value_type>;
+    using x_space_type = XSpace;
     using value_container_type = std::vector<value_type>;
 
+    /// Number of points computed at once by the batch interpolation
+    static constexpr std::size_t BATCH_SIZE = 64;
+
 public:
-    /*! Create a LinearList from a LinearSpace and a vector of values.
+    /*! Create a LinearList from a space and a vector of values.
      * \warning \p values must have the \p xSpace size + 1. The last value
      * should be duplicated.
      */
@@ -91,6 +100,14 @@ public:
         assert(m_values.size() == (m_xSpace.nrPoints() + 1));
     }
 
+    /// Move \p values, \see LinearList
+    LinearList(const x_space_type& xSpace, value_container_type&& values)
+      : m_xSpace(xSpace)
+      , m_values(std::move(values))
+    {
+        assert(m_values.size() == (m_xSpace.nrPoints() + 1));
+    }
+
     /*! Getter from index.
      * \return Value associated to index x.
      * \warning \p x must be a valid index.
@@ -137,6 +154,32 @@ public:
         return intepolate(res);
     }
 
+    /*! Batch version of \see safeInterpolated.
+     * Points are processed by block of BATCH_SIZE, space weights of a block
+     * are computed before interpolating the values.
+     * \param[in] x Array of \p size space values.
+     * \param[in] size Number of points.
+     * \param[out] res Array of \p size interpolated values.
+     */
+    void safeInterpolated(const x_value_type* x,
+                          std::size_t size,
+                          value_type* res) const noexcept
+    {
+        std::array<std::size_t, BATCH_SIZE> idx;
+        std::array<double, BATCH_SIZE> percent;
+        interpolator_type interpolator;
+        for (std::size_t start = 0; start < size; start += BATCH_SIZE) {
+            std::size_t n = std::min(BATCH_SIZE, size - start);
+            m_xSpace.safeInterpolationWeights(
+              x + start, n, idx.data(), percent.data());
+            for (std::size_t i = 0; i < n; ++i) {
+                res[start + i] = interpolator(m_values[idx[i]],
+                                              m_values[idx[i] + 1],
+                                              scale_t(percent[i]));
+            }
+        }
+    }
+
     /// Linear space getter
     const x_space_type& xSpace() const noexcept { return m_xSpace; }
 
@@ -188,7 +231,8 @@ private:
  */
 template<typename XUnit,
          typename DataType,
-         typename Interpolator = NumericInterpolator<DataType>>
+         typename Interpolator = NumericInterpolator<DataType>,
+         typename XSpace = LinearSpace<XUnit>>
 class LinearListBuilder
 {
 public:
@@ -196,11 +240,11 @@ public:
     using value_type = DataType;
     using interpolator_type = Interpolator;
 
-    using x_space_type = LinearSpace<x_value_type>;
+    using x_space_type = XSpace;
     using value_container_type = std::vector<value_type>;
 
     using linear_list_type =
-      LinearList<x_value_type, value_type, interpolator_type>;
+      LinearList<x_value_type, value_type, interpolator_type, x_space_type>;
 
 public:
     /*! Create a LinearList from a LinearSpace and a vector of values.
@@ -228,13 +272,19 @@ public:
         return m_values[safeIndex(x)];
     }
 
-    linear_list_type build() const noexcept
+    /// Build a LinearList with a copy of the values
+    linear_list_type build() const&
+    {
+        value_container_type values(m_values);
+        values.back() = values[values.size() - 2];
+        return linear_list_type(m_xSpace, std::move(values));
+    }
+
+    /// Build a LinearList by moving the values out of the builder
+    linear_list_type build() &&
     {
-        // The last value of m_values is considered mutable.
-        // Since is not possible to do that in C++ we use const_cast.
-        const_cast<value_container_type&>(m_values).back() =
-          m_values[m_values.size() - 2];
-        return linear_list_type(m_xSpace, m_values);
+        m_values.back() = m_values[m_values.size() - 2];
+        return linear_list_type(m_xSpace, std::move(m_values));
     }
 
 private:
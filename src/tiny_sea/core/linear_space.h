@@ -18,6 +18,7 @@
 
 // includes
 // std
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 
@@ -118,6 +119,41 @@ public:
         return interpolationWeight(clamp(t));
     }
 
+    /*! Batch version of \see safeInterpolationWeight.
+     * The delta division is replaced by a multiplication with the inverse
+     * delta computed once by call.
+     * \param[in] t Array of \p size values, clamped between [start(),
+     * stop()].
+     * \param[out] index Array of \p size index of the smallest element.
+     * \param[out] percent Array of \p size percent between two index.
+     */
+    void safeInterpolationWeights(const value_type* t,
+                                  std::size_t size,
+                                  std::size_t* index,
+                                  double* percent) const noexcept
+    {
+        const double start = m_start.t;
+        const double invDelta = 1. / m_delta.t;
+        const double last = double(m_nrPoints - 1);
+        for (std::size_t i = 0; i < size; ++i) {
+            double p = std::clamp((t[i].t - start) * invDelta, 0., last);
+            double floor = std::floor(p);
+            index[i] = std::size_t(floor);
+            percent[i] = p - floor;
+        }
+    }
+
+    bool operator==(const LinearSpace& other) const noexcept
+    {
+        return m_start == other.m_start && m_delta == other.m_delta &&
+               m_nrPoints == other.m_nrPoints;
+    }
+
+    bool operator!=(const LinearSpace& other) const noexcept
+    {
+        return !(*this == other);
+    }
+
     /// \return Check if a value is inside the linear space [start, stop]
     bool inside(value_type t) const noexcept
     {
@@ -0,0 +1,378 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+// includes
+// std
+#include <array>
+#include <cassert>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// tiny_sea
+#include <tiny_sea/core/interpolator.h>
+#include <tiny_sea/core/linear_space.h>
+
+namespace tiny_sea {
+
+/*! Axis of a LinearTensor.
+ * \tparam Space LinearSpace or NonUniformSpace.
+ * \tparam Interpolator Interpolate two values along this axis. A
+ * NullInterpolator axis snap to the lower point and only read one value.
+ */
+template<typename Space, typename Interpolator>
+struct TensorAxis
+{
+    using space_type = Space;
+    using interpolator_type = Interpolator;
+};
+
+namespace internal {
+
+template<std::size_t N>
+inline std::array<std::size_t, N>
+identityOrder() noexcept
+{
+    std::array<std::size_t, N> order;
+    for (std::size_t i = 0; i < N; ++i) {
+        order[i] = i;
+    }
+    return order;
+}
+
+/*! \return Strides of each axis, \p order axes are sorted from the
+ * contiguous one to the slowest one.
+ */
+template<std::size_t N>
+inline std::array<std::size_t, N>
+tensorStrides(const std::array<std::size_t, N>& shape,
+              const std::array<std::size_t, N>& order) noexcept
+{
+    std::array<std::size_t, N> strides;
+    std::size_t stride = 1;
+    for (std::size_t i = 0; i < N; ++i) {
+        assert(order[i] < N);
+        strides[order[i]] = stride;
+        stride *= shape[order[i]];
+    }
+    return strides;
+}
+
+template<std::size_t N>
+inline void
+checkIndexND(const std::array<std::size_t, N>& shape,
+             const std::array<std::size_t, N>& index)
+{
+    for (std::size_t i = 0; i < N; ++i) {
+        if (index[i] >= shape[i]) {
+            std::ostringstream str;
+            str << "Index (" << index[i] << ") of axis " << i
+                << " is not in tensor axis of shape (" << shape[i] << ")";
+            throw std::out_of_range(str.str());
+        }
+    }
+}
+
+}
+
+/*! N-dimensional regular grid in one contiguous allocation.
+ * Each axis has its own space and interpolator, by example a time x latitude
+ * x longitude tensor of WorldMapData:
+ *
+ *  LinearTensor<WorldMapData,
+ *               TensorAxis<LinearSpace<time_t>, NullInterpolator<...>>,
+ *               TensorAxis<LinearSpace<latitude_t>, WorldMapDataInterpolator>,
+ *               TensorAxis<LinearSpace<longitude_t>, WorldMapDataInterpolator>>
+ *
+ * Axis order in memory is configurable, by default the first axis is
+ * contiguous like the LinearGrid x axis.
+ *
+ * Unlike LinearGrid, last values are not duplicated: on the last point of an
+ * axis the upper value is not read. Multilinear interpolation is unrolled at
+ * compile time, axes are interpolated from the first one to the last one.
+ */
+template<typename DataType, typename... Axes>
+class LinearTensor
+{
+public:
+    static constexpr std::size_t NR_DIMS = sizeof...(Axes);
+
+    using value_type = DataType;
+    using spaces_type = std::tuple<typename Axes::space_type...>;
+    using index_type = std::array<std::size_t, NR_DIMS>;
+    using value_container_type = std::vector<value_type>;
+
+    static_assert(NR_DIMS > 0, "LinearTensor need at least one axis");
+
+public:
+    /*! Create a LinearTensor from its spaces and values.
+     * \param order Axes from the contiguous one to the slowest one.
+     * \warning \p values must have the product of spaces size.
+     * \warning \p order must be a permutation of [0, NR_DIMS[.
+     */
+    LinearTensor(const spaces_type& spaces,
+                 value_container_type values,
+                 const index_type& order = internal::identityOrder<NR_DIMS>())
+      : m_spaces(spaces)
+      , m_shape(shapeOf(spaces))
+      , m_order(order)
+      , m_strides(internal::tensorStrides(m_shape, order))
+      , m_values(std::move(values))
+    {
+        assert(m_values.size() == sizeOf(m_shape));
+    }
+
+    /*! Getter from index.
+     * \warning \p index must be a valid index.
+     */
+    value_type operator()(const index_type& index) const
+    {
+        return m_values[offset(index)];
+    }
+
+    /// \throw std::out_of_range if \p index is not valid
+    value_type safeAt(const index_type& index) const
+    {
+        internal::checkIndexND(m_shape, index);
+        return m_values[offset(index)];
+    }
+
+    /*!
+     * \return Interpolated value
+     * \warning \p x must be inside each axis space.
+     */
+    value_type interpolated(typename Axes::space_type::value_type... x) const
+    {
+        return interpolate<NR_DIMS>(
+          weights<false>(std::forward_as_tuple(x...),
+                         std::index_sequence_for<Axes...>()),
+          0);
+    }
+
+    /*!
+     * \param[in] x Clamped between [start(), stop()] of each axis.
+     * \return Interpolated value
+     */
+    value_type safeInterpolated(
+      typename Axes::space_type::value_type... x) const noexcept
+    {
+        return interpolate<NR_DIMS>(
+          weights<true>(std::forward_as_tuple(x...),
+                        std::index_sequence_for<Axes...>()),
+          0);
+    }
+
+    /// Space of axis \p D getter
+    template<std::size_t D>
+    const std::tuple_element_t<D, spaces_type>& space() const noexcept
+    {
+        return std::get<D>(m_spaces);
+    }
+
+    /// Spaces getter
+    const spaces_type& spaces() const noexcept { return m_spaces; }
+
+    /// Number of points of each axis
+    const index_type& shape() const noexcept { return m_shape; }
+
+    /// Axes from the contiguous one to the slowest one
+    const index_type& order() const noexcept { return m_order; }
+
+    /// Offset between two consecutive points of each axis
+    const index_type& strides() const noexcept { return m_strides; }
+
+    /// Values getter
+    const value_container_type& values() const noexcept { return m_values; }
+
+    /// \return Value offset of \p index
+    std::size_t offset(const index_type& index) const noexcept
+    {
+        std::size_t res = 0;
+        for (std::size_t i = 0; i < NR_DIMS; ++i) {
+            assert(index[i] < m_shape[i]);
+            res += index[i] * m_strides[i];
+        }
+        return res;
+    }
+
+    static index_type shapeOf(const spaces_type& spaces) noexcept
+    {
+        return shapeOf(spaces, std::index_sequence_for<Axes...>());
+    }
+
+    static std::size_t sizeOf(const index_type& shape) noexcept
+    {
+        std::size_t size = 1;
+        for (std::size_t n : shape) {
+            size *= n;
+        }
+        return size;
+    }
+
+private:
+    using weights_type =
+      std::array<LinearSpaceInterpolationResult, NR_DIMS>;
+
+    template<std::size_t D>
+    using axis_type = std::tuple_element_t<D, std::tuple<Axes...>>;
+
+    template<std::size_t... I>
+    static index_type shapeOf(const spaces_type& spaces,
+                              std::index_sequence<I...>) noexcept
+    {
+        return index_type{ std::get<I>(spaces).nrPoints()... };
+    }
+
+    template<bool Safe, typename Values, std::size_t... I>
+    weights_type weights(const Values& x, std::index_sequence<I...>) const
+      noexcept
+    {
+        return weights_type{ weight<Safe>(std::get<I>(m_spaces),
+                                          std::get<I>(x))... };
+    }
+
+    template<bool Safe, typename Space>
+    static LinearSpaceInterpolationResult weight(
+      const Space& space,
+      typename Space::value_type x) noexcept
+    {
+        if constexpr (Safe) {
+            return space.safeInterpolationWeight(x);
+        } else {
+            return space.interpolationWeight(x);
+        }
+    }
+
+    /*! Interpolate the D first axes, axis D - 1 is interpolated last.
+     * \param base Offset of the already selected points of axes >= D.
+     */
+    template<std::size_t D>
+    value_type interpolate(const weights_type& w, std::size_t base) const
+      noexcept
+    {
+        if constexpr (D == 0) {
+            return m_values[base];
+        } else {
+            using interpolator_type =
+              typename axis_type<D - 1>::interpolator_type;
+            const auto& res = w[D - 1];
+            std::size_t lower = base + res.index * m_strides[D - 1];
+            value_type v0 = interpolate<D - 1>(w, lower);
+            if constexpr (std::is_same<interpolator_type,
+                                       NullInterpolator<value_type>>::value) {
+                return v0;
+            } else {
+                if (res.index + 1 >= m_shape[D - 1] || res.percent.t == 0.) {
+                    return v0;
+                }
+                value_type v1 =
+                  interpolate<D - 1>(w, lower + m_strides[D - 1]);
+                interpolator_type interpolator;
+                return interpolator(v0, v1, res.percent);
+            }
+        }
+    }
+
+private:
+    spaces_type m_spaces;
+    index_type m_shape;
+    index_type m_order;
+    index_type m_strides;
+    value_container_type m_values;
+};
+
+/*! Helper class to build LinearTensor.
+ */
+template<typename DataType, typename... Axes>
+class LinearTensorBuilder
+{
+public:
+    using linear_tensor_type = LinearTensor<DataType, Axes...>;
+    using value_type = DataType;
+    using spaces_type = typename linear_tensor_type::spaces_type;
+    using index_type = typename linear_tensor_type::index_type;
+    using value_container_type =
+      typename linear_tensor_type::value_container_type;
+
+public:
+    /*!
+     * \param order Axes from the contiguous one to the slowest one.
+     * \warning \p order must be a permutation of [0, NR_DIMS[.
+     */
+    LinearTensorBuilder(const spaces_type& spaces,
+                        const index_type& order = internal::identityOrder<
+                          linear_tensor_type::NR_DIMS>())
+      : m_spaces(spaces)
+      , m_shape(linear_tensor_type::shapeOf(spaces))
+      , m_order(order)
+      , m_strides(internal::tensorStrides(m_shape, order))
+      , m_values(linear_tensor_type::sizeOf(m_shape))
+    {}
+
+    /*! Getter from index.
+     * \warning \p index must be a valid index.
+     */
+    value_type operator()(const index_type& index) const
+    {
+        return m_values[offset(index)];
+    }
+    value_type& operator()(const index_type& index)
+    {
+        return m_values[offset(index)];
+    }
+    value_type& safeAt(const index_type& index)
+    {
+        internal::checkIndexND(m_shape, index);
+        return m_values[offset(index)];
+    }
+
+    /// Build a LinearTensor with a copy of the values
+    linear_tensor_type build() const&
+    {
+        return linear_tensor_type(m_spaces, m_values, m_order);
+    }
+
+    /// Build a LinearTensor by moving the values out of the builder
+    linear_tensor_type build() &&
+    {
+        return linear_tensor_type(m_spaces, std::move(m_values), m_order);
+    }
+
+private:
+    std::size_t offset(const index_type& index) const noexcept
+    {
+        std::size_t res = 0;
+        for (std::size_t i = 0; i < index.size(); ++i) {
+            assert(index[i] < m_shape[i]);
+            res += index[i] * m_strides[i];
+        }
+        return res;
+    }
+
+private:
+    spaces_type m_spaces;
+    index_type m_shape;
+    index_type m_order;
+    index_type m_strides;
+    value_container_type m_values;
+};
+
+}
@@ -18,11 +18,14 @@
 
 // includes
 // std
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <utility>
 
 // tiny_sea
 #include <tiny_sea/core/numeric_constants.h>
+#include <tiny_sea/core/simd_dispatch.h>
 #include <tiny_sea/core/units.h>
 
 // Eigen
@@ -33,6 +36,10 @@ namespace tiny_sea {
 
 class NVector
 {
+public:
+    /// Number of points computed at once by the batch kernels
+    static constexpr std::size_t BATCH_SIZE = 64;
+
 public:
     NVector() = default;
     NVector(double x, double y, double z)
@@ -46,7 +53,12 @@ public:
       , m_z(vec.z())
     {}
 
-    static radian_t toAngle(meter_t distance);
+    /// \return \p distance on the earth surface as an angle
+    static radian_t toAngle(meter_t distance) noexcept
+    {
+        return radian_t(distance.t / EARTH_RADIUS);
+    }
+
     static NVector fromLatLon(latitude_t lat, longitude_t lon) noexcept
     {
         double clat = std::cos(lat.t);
@@ -70,7 +82,21 @@ public:
                                   toEigen().dot(o.toEigen())));
     }
 
-    radian_t bearing(const NVector& o) const;
+    /*! Initial great circle bearing toward \p o.
+     * \return Orientation from north clockwise in [-pi, pi].
+     */
+    radian_t bearing(const NVector& o) const noexcept
+    {
+        Eigen::Vector3d self = toEigen();
+
+        // Same frame than destination
+        Eigen::Vector3d east_vec = Eigen::Vector3d::UnitZ().cross(self);
+        Eigen::Vector3d north_vec = self.cross(east_vec);
+
+        Eigen::Vector3d direction = o.toEigen() - self;
+        return radian_t(
+          std::atan2(direction.dot(east_vec), direction.dot(north_vec)));
+    }
 
     /*! Compute a new vector based on bearing from north and a distance.
      * \param[in] bearing Orientation from north clockwise.
@@ -95,6 +121,61 @@ public:
         return NVector(std::cos(angle) * self + std::sin(angle) * direction);
     }
 
+    /*! Batch version of \see destination with a shared distance.
+     * Points are processed by block of BATCH_SIZE with the runtime
+     * dispatched simd::Kernels::destination.
+     * \param[in] bearings Array of \p size orientations from north clockwise.
+     * \param[in] distance Distance from origin of all destinations.
+     * \param[out] res Array of \p size destinations.
+     */
+    void destinations(const radian_t* bearings,
+                      meter_t distance,
+                      std::size_t size,
+                      NVector* res) const
+    {
+        const auto& kernels = simd::kernels();
+        const double origin[3] = { m_x, m_y, m_z };
+        double angle = distance.t / EARTH_RADIUS;
+        std::array<double, BATCH_SIZE> b, x, y, z;
+
+        for (std::size_t start = 0; start < size; start += BATCH_SIZE) {
+            std::size_t n = std::min(BATCH_SIZE, size - start);
+            for (std::size_t i = 0; i < n; ++i) {
+                b[i] = bearings[start + i].t;
+            }
+            kernels.destination(
+              origin, b.data(), angle, n, x.data(), y.data(), z.data());
+            for (std::size_t i = 0; i < n; ++i) {
+                res[start + i] = NVector(x[i], y[i], z[i]);
+            }
+        }
+    }
+
+    /*! Batch version of \see distance.
+     * \param[in] points Array of \p size vectors.
+     * \param[out] res Array of \p size distances from this vector.
+     */
+    void distances(const NVector* points, std::size_t size, meter_t* res) const
+    {
+        const auto& kernels = simd::kernels();
+        const double target[3] = { m_x, m_y, m_z };
+        std::array<double, BATCH_SIZE> x, y, z, angle;
+
+        for (std::size_t start = 0; start < size; start += BATCH_SIZE) {
+            std::size_t n = std::min(BATCH_SIZE, size - start);
+            for (std::size_t i = 0; i < n; ++i) {
+                x[i] = points[start + i].m_x;
+                y[i] = points[start + i].m_y;
+                z[i] = points[start + i].m_z;
+            }
+            kernels.distance(
+              target, x.data(), y.data(), z.data(), n, angle.data());
+            for (std::size_t i = 0; i < n; ++i) {
+                res[start + i] = meter_t(EARTH_RADIUS * angle[i]);
+            }
+        }
+    }
+
     Eigen::Vector3d toEigen() const { return Eigen::Vector3d(m_x, m_y, m_z); }
 
     double x() const noexcept { return m_x; }
@@ -0,0 +1,259 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+// includes
+// std
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// tiny_sea
+#include <tiny_sea/core/exception.h>
+#include <tiny_sea/core/linear_space.h>
+#include <tiny_sea/core/units.h>
+
+namespace tiny_sea {
+
+/*! Set of strictly increasing points with arbitrary spacing.
+ * Drop-in replacement of LinearSpace when steps are not uniform, like a
+ * forecast with hourly steps followed by 3-hourly steps:
+ *
+ *  [start()  1      2        3      stop()]
+ *   0h       1h     2h       5h     8h
+ *
+ * index() is O(1): the [start, stop] range is split in buckets no larger
+ * than the smallest step, each bucket store the index of the point before
+ * it. A bucket then contains at most one point and a lookup is one bucket
+ * read and one comparison. The number of buckets is bounded to
+ * MAX_BUCKETS_BY_POINT by point, a bucket can then contain a few points on
+ * very irregular spaces.
+ */
+template<typename Unit>
+class NonUniformSpace
+{
+public:
+    using value_type = Unit;
+
+    /// Maximum number of buckets by point
+    static constexpr std::size_t MAX_BUCKETS_BY_POINT = 16;
+
+public:
+    /*!
+     * \param[in] values Points of the space.
+     * \warning \p values should be strictly increasing.
+     * \warning \p values should contains at least 2 points.
+     */
+    explicit NonUniformSpace(std::vector<value_type> values)
+      : m_values(std::move(values))
+    {
+        assert(m_values.size() > 1);
+        assert(std::adjacent_find(m_values.begin(),
+                                  m_values.end(),
+                                  std::greater_equal<value_type>()) ==
+               m_values.end());
+        buildBuckets();
+    }
+
+    /// Convert a LinearSpace
+    NonUniformSpace(const LinearSpace<value_type>& space)
+      : m_values(space.nrPoints())
+    {
+        for (std::size_t i = 0; i < m_values.size(); ++i) {
+            m_values[i] = space.value(i);
+        }
+        buildBuckets();
+    }
+
+    value_type start() const noexcept { return m_values.front(); }
+    value_type stop() const noexcept { return m_values.back(); }
+    std::size_t nrPoints() const noexcept { return m_values.size(); }
+
+    /*! \return Space value at a current index
+     * \warning \p index must be lower than nrPoints().
+     */
+    value_type value(std::size_t index) const noexcept
+    {
+        assert(index < m_values.size());
+        return m_values[index];
+    }
+
+    /*! \return Step between \p index and \p index + 1
+     * \warning \p index must be lower than nrPoints() - 1.
+     */
+    value_type delta(std::size_t index) const noexcept
+    {
+        assert(index + 1 < m_values.size());
+        return m_values[index + 1] - m_values[index];
+    }
+
+    /// Points getter
+    const std::vector<value_type>& values() const noexcept
+    {
+        return m_values;
+    }
+
+    /*! \return Space index associated to a space value.
+     * \warning \p t must be in the space range [start, stop]
+     */
+    std::size_t index(value_type t) const noexcept
+    {
+        assert(inside(t));
+        auto bucket = std::min(
+          std::size_t(double((t - start()) / m_bucketSize)), m_nrBuckets - 1);
+        std::size_t idx = m_buckets[bucket];
+        // Rounding can put t just before its bucket start
+        if (idx > 0 && t < m_values[idx]) {
+            --idx;
+        }
+        while (idx + 1 < m_values.size() && t >= m_values[idx + 1]) {
+            ++idx;
+        }
+        return idx;
+    }
+
+    /*! Safe version of \see index.
+     * \param[in] t Clamped between [start(), stop()].
+     */
+    std::size_t safeIndex(value_type t) const noexcept
+    {
+        return index(clamp(t));
+    }
+
+    /// \return Interpolation weight of \p t
+    LinearSpaceInterpolationResult interpolationWeight(value_type t) const
+      noexcept
+    {
+        std::size_t idx = index(t);
+        if (idx + 1 == m_values.size()) {
+            return LinearSpaceInterpolationResult(scale_t(0.), idx);
+        }
+        return LinearSpaceInterpolationResult((t - m_values[idx]) / delta(idx),
+                                              idx);
+    }
+
+    /*! Safe version of \see interpolationWeight.
+     * \param[in] t Clamped between [start(), stop()].
+     */
+    LinearSpaceInterpolationResult safeInterpolationWeight(
+      value_type t) const noexcept
+    {
+        return interpolationWeight(clamp(t));
+    }
+
+    /*! Batch version of \see safeInterpolationWeight.
+     * \param[in] t Array of \p size values, clamped between [start(),
+     * stop()].
+     * \param[out] index Array of \p size index of the smallest element.
+     * \param[out] percent Array of \p size percent between two index.
+     */
+    void safeInterpolationWeights(const value_type* t,
+                                  std::size_t size,
+                                  std::size_t* index,
+                                  double* percent) const noexcept
+    {
+        for (std::size_t i = 0; i < size; ++i) {
+            auto res = safeInterpolationWeight(t[i]);
+            index[i] = res.index;
+            percent[i] = res.percent.t;
+        }
+    }
+
+    /// \return Check if a value is inside the space [start, stop]
+    bool inside(value_type t) const noexcept
+    {
+        return t >= start() && t <= stop();
+    }
+
+    bool operator==(const NonUniformSpace& other) const noexcept
+    {
+        return m_values == other.m_values;
+    }
+
+    bool operator!=(const NonUniformSpace& other) const noexcept
+    {
+        return !(*this == other);
+    }
+
+private:
+    /// \return \p t clamped in the space [start, stop]
+    value_type clamp(value_type t) const noexcept
+    {
+        return std::clamp(t, start(), stop());
+    }
+
+    void buildBuckets()
+    {
+        value_type minDelta = delta(0);
+        for (std::size_t i = 1; i + 1 < m_values.size(); ++i) {
+            minDelta = std::min(minDelta, delta(i));
+        }
+
+        double range = double((stop() - start()) / minDelta);
+        m_nrBuckets = std::min(std::size_t(std::ceil(range)),
+                               MAX_BUCKETS_BY_POINT * m_values.size());
+        m_nrBuckets = std::max<std::size_t>(m_nrBuckets, 1);
+        m_bucketSize = (stop() - start()) / scale_t(double(m_nrBuckets));
+
+        m_buckets.resize(m_nrBuckets);
+        std::size_t idx = 0;
+        for (std::size_t b = 0; b < m_nrBuckets; ++b) {
+            value_type bucketStart =
+              start() + m_bucketSize * scale_t(double(b));
+            while (idx + 1 < m_values.size() &&
+                   m_values[idx + 1] <= bucketStart) {
+                ++idx;
+            }
+            m_buckets[b] = idx;
+        }
+    }
+
+private:
+    std::vector<value_type> m_values;
+    value_type m_bucketSize;
+    std::size_t m_nrBuckets;
+    std::vector<std::size_t> m_buckets; //< Last point before each bucket
+};
+
+/// Helper method to create a NonUniformSpace
+template<typename Unit>
+inline NonUniformSpace<Unit>
+makeNonUniformSpace(std::vector<Unit> values)
+{
+    return NonUniformSpace<Unit>(std::move(values));
+}
+
+/// Safe version of \see makeNonUniformSpace
+template<typename Unit>
+inline NonUniformSpace<Unit>
+safeMakeNonUniformSpace(std::vector<Unit> values)
+{
+    if (values.size() <= 1) {
+        throw Exception("values should at least contains 2 points");
+    }
+    for (std::size_t i = 1; i < values.size(); ++i) {
+        if (values[i] <= values[i - 1]) {
+            throw Exception("values must be strictly increasing");
+        }
+    }
+    return makeNonUniformSpace(std::move(values));
+}
+
+}
@@ -0,0 +1,255 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// associated header
+#include <tiny_sea/core/paged_wind_grid.h>
+
+// includes
+// std
+#include <algorithm>
+#include <cassert>
+
+// POSIX
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// tiny_sea
+#include <tiny_sea/core/exception.h>
+#include <tiny_sea/core/world_map.h>
+
+namespace tiny_sea {
+
+namespace {
+
+ForecastHeader
+readHeader(const std::string& path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw Exception("Impossible to open forecast file " + path);
+    }
+
+    ForecastHeader header;
+    struct stat st;
+    bool valid = ::fstat(fd, &st) == 0 &&
+                 ::pread(fd, &header, sizeof(header), 0) ==
+                   ssize_t(sizeof(header));
+    ::close(fd);
+    if (!valid) {
+        throw Exception("Invalid forecast file " + path);
+    }
+    header.check(std::uint64_t(st.st_size));
+    if (header.hasCurrent()) {
+        throw Exception("Paged forecast don't support current planes " + path);
+    }
+    return header;
+}
+
+}
+
+PagedForecast::PagedForecast(const std::string& path,
+                             std::size_t tileSize,
+                             std::size_t memoryCap)
+  : m_header(readHeader(path))
+  , m_latSpace(m_header.latSpace())
+  , m_lonSpace(m_header.lonSpace())
+  , m_tileSize(std::max<std::size_t>(tileSize, 1))
+  , m_memoryCap(memoryCap)
+  , m_nrLatTiles((m_latSpace.nrPoints() + m_tileSize - 1) / m_tileSize)
+  , m_nrLonTiles((m_lonSpace.nrPoints() + m_tileSize - 1) / m_tileSize)
+  , m_fd(::open(path.c_str(), O_RDONLY))
+{
+    if (m_fd < 0) {
+        throw Exception("Impossible to open forecast file " + path);
+    }
+}
+
+PagedForecast::~PagedForecast()
+{
+    ::close(m_fd);
+}
+
+WindVector
+PagedForecast::vector(std::size_t slice, std::size_t lat, std::size_t lon) const
+{
+    assert(lat < m_latSpace.nrPoints());
+    assert(lon < m_lonSpace.nrPoints());
+
+    auto t = tile(slice, lat, lon);
+    std::size_t idx = t->index(lat, lon);
+    return WindVector(velocity_t(t->u[idx]), velocity_t(t->v[idx]));
+}
+
+WindVector
+PagedForecast::safeInterpolatedVector(std::size_t slice,
+                                      latitude_t lat,
+                                      longitude_t lon) const
+{
+    auto resLat = m_latSpace.safeInterpolationWeight(lat);
+    auto resLon = m_lonSpace.safeInterpolationWeight(lon);
+    float pLat = float(resLat.percent.t);
+    float pLon = float(resLon.percent.t);
+
+    auto t = tile(slice, resLat.index, resLon.index);
+    std::size_t idx00 = t->index(resLat.index, resLon.index);
+    std::size_t idx01 = idx00 + t->nrLat;
+    auto bilinear = [&](const std::vector<float>& c) {
+        float y0 = c[idx00] + (c[idx00 + 1] - c[idx00]) * pLat;
+        float y1 = c[idx01] + (c[idx01 + 1] - c[idx01]) * pLat;
+        return y0 + (y1 - y0) * pLon;
+    };
+    return WindVector(velocity_t(bilinear(t->u)), velocity_t(bilinear(t->v)));
+}
+
+PagedForecast::Stats
+PagedForecast::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void
+PagedForecast::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_tiles.clear();
+    m_tileIndex.clear();
+    m_stats = Stats();
+}
+
+PagedForecast::TilePtr
+PagedForecast::tile(std::size_t slice, std::size_t lat, std::size_t lon) const
+{
+    assert(slice < m_header.timeNrPoints);
+    std::size_t latTile = lat / m_tileSize;
+    std::size_t lonTile = lon / m_tileSize;
+    std::uint64_t key =
+      (slice * m_nrLonTiles + lonTile) * m_nrLatTiles + latTile;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto it = m_tileIndex.find(key);
+    if (it != m_tileIndex.end()) {
+        ++m_stats.nrHit;
+        m_tiles.splice(m_tiles.begin(), m_tiles, it->second);
+        auto future = it->second->tile;
+        lock.unlock();
+        // Wait if another thread is loading the tile
+        return future.get();
+    }
+
+    // Insert a placeholder so concurrent accesses wait on this load instead
+    // of reading the tile again
+    ++m_stats.nrMiss;
+    std::promise<TilePtr> promise;
+    std::uint64_t serial = m_serial++;
+    m_tiles.push_front(Entry{ key, serial, 0, promise.get_future().share() });
+    m_tileIndex.emplace(key, m_tiles.begin());
+    lock.unlock();
+
+    // clear() can remove the entry while loading
+    auto findEntry = [&]() {
+        auto found = m_tileIndex.find(key);
+        return found != m_tileIndex.end() && found->second->serial == serial
+                 ? found->second
+                 : m_tiles.end();
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    TilePtr t;
+    try {
+        t = load(slice, latTile, lonTile);
+    } catch (...) {
+        promise.set_exception(std::current_exception());
+        lock.lock();
+        auto entry = findEntry();
+        if (entry != m_tiles.end()) {
+            m_tileIndex.erase(key);
+            m_tiles.erase(entry);
+        }
+        throw;
+    }
+    promise.set_value(t);
+    auto loadTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start);
+
+    lock.lock();
+    auto entry = findEntry();
+    if (entry == m_tiles.end()) {
+        return t;
+    }
+    m_stats.loadTime += loadTime;
+    entry->memory = t->memory();
+    m_stats.memory += entry->memory;
+
+    // Evict least recently used tiles, the loaded tile is always kept
+    m_tiles.splice(m_tiles.begin(), m_tiles, entry);
+    while (m_stats.memory > m_memoryCap && m_tiles.size() > 1) {
+        m_stats.memory -= m_tiles.back().memory;
+        m_tileIndex.erase(m_tiles.back().key);
+        m_tiles.pop_back();
+        ++m_stats.nrEvicted;
+    }
+    return t;
+}
+
+PagedForecast::TilePtr
+PagedForecast::load(std::size_t slice,
+                    std::size_t latTile,
+                    std::size_t lonTile) const
+{
+    // Tiles store tileSize + 1 nodes, the duplicated last row and column of
+    // the file allow to do that on border tiles
+    auto t = std::make_shared<Tile>();
+    t->lat0 = latTile * m_tileSize;
+    t->lon0 = lonTile * m_tileSize;
+    t->nrLat = std::min(m_tileSize + 1, m_latSpace.nrPoints() + 1 - t->lat0);
+    std::size_t nrLon =
+      std::min(m_tileSize + 1, m_lonSpace.nrPoints() + 1 - t->lon0);
+
+    std::size_t rowSize = m_latSpace.nrPoints() + 1;
+    t->u.resize(t->nrLat * nrLon);
+    t->v.resize(t->nrLat * nrLon);
+    std::size_t nrBytes = t->nrLat * sizeof(float);
+    for (std::size_t component = 0; component < 2; ++component) {
+        float* dst = component == 0 ? t->u.data() : t->v.data();
+        std::uint64_t plane = m_header.offset(slice, component);
+        for (std::size_t lon = 0; lon < nrLon; ++lon) {
+            std::uint64_t offset =
+              plane + ((t->lon0 + lon) * rowSize + t->lat0) * sizeof(float);
+            if (::pread(m_fd, dst + lon * t->nrLat, nrBytes, off_t(offset)) !=
+                ssize_t(nrBytes)) {
+                throw Exception("Impossible to read forecast tile");
+            }
+        }
+    }
+    return t;
+}
+
+TimeWorldMap
+pagedTimeWorldMap(const std::shared_ptr<const PagedForecast>& forecast)
+{
+    std::size_t nrSlices = forecast->header().timeNrPoints;
+    std::vector<WorldMap> worldMaps;
+    worldMaps.reserve(nrSlices + 1);
+    for (std::size_t i = 0; i < nrSlices; ++i) {
+        worldMaps.emplace_back(PagedWindGrid(forecast, i));
+    }
+    worldMaps.emplace_back(worldMaps.back());
+    return TimeWorldMap(forecast->header().timeSpace(), std::move(worldMaps));
+}
+
+}
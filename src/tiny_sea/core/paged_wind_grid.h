@@ -0,0 +1,240 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+// includes
+// std
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// tiny_sea
+#include <tiny_sea/core/forecast_file.h>
+#include <tiny_sea/core/linear_space.h>
+#include <tiny_sea/core/units.h>
+#include <tiny_sea/core/wind_vector.h>
+#include <tiny_sea/core/world_map_grid.h>
+
+namespace tiny_sea {
+
+/*! Forecast file loaded tile by tile on first access.
+ * Each slice is split in tiles of tileSize x tileSize cells. A tile also
+ * store the first node of the next tile, so a bilinear interpolation only
+ * touch one tile.
+ *
+ * Loaded tiles are kept in a LRU cache, least recently used tiles are
+ * evicted when the memory cap is reached.
+ *
+ * All methods are thread safe. The cache mutex only guard the LRU
+ * bookkeeping: tiles are read from the file and interpolated outside of it.
+ * Concurrent accesses to a tile being loaded wait for this load.
+ */
+class PagedForecast
+{
+public:
+    struct Stats
+    {
+        std::size_t nrHit = 0;     //< Access to a loaded tile
+        std::size_t nrMiss = 0;    //< Access that loaded a tile
+        std::size_t nrEvicted = 0; //< Evicted tiles
+        std::size_t memory = 0;    //< Loaded tiles memory in bytes
+        std::chrono::nanoseconds loadTime = std::chrono::nanoseconds(0);
+    };
+
+public:
+    /*!
+     * \param path Forecast file written by ForecastWriter.
+     * \param tileSize Number of cells along each tile side.
+     * \param memoryCap Maximum memory used by loaded tiles in bytes. At least
+     * one tile is always kept.
+     * \throw Exception if \p path is not a valid forecast file or store
+     * current planes.
+     */
+    PagedForecast(const std::string& path,
+                  std::size_t tileSize = 32,
+                  std::size_t memoryCap = std::size_t(64) << 20);
+    ~PagedForecast();
+
+    PagedForecast(const PagedForecast&) = delete;
+    PagedForecast& operator=(const PagedForecast&) = delete;
+
+    /// Wind vector of the (\p lat, \p lon) node of \p slice
+    WindVector vector(std::size_t slice,
+                      std::size_t lat,
+                      std::size_t lon) const;
+
+    /*!
+     * \param[in] lat Clamped between [start(), stop()].
+     * \param[in] lon Clamped between [start(), stop()].
+     * \return Interpolated wind vector of \p slice
+     */
+    WindVector safeInterpolatedVector(std::size_t slice,
+                                      latitude_t lat,
+                                      longitude_t lon) const;
+
+    const ForecastHeader& header() const noexcept { return m_header; }
+    const LinearSpace<latitude_t>& latSpace() const noexcept
+    {
+        return m_latSpace;
+    }
+    const LinearSpace<longitude_t>& lonSpace() const noexcept
+    {
+        return m_lonSpace;
+    }
+    std::size_t tileSize() const noexcept { return m_tileSize; }
+    std::size_t memoryCap() const noexcept { return m_memoryCap; }
+
+    Stats stats() const;
+
+    /// Evict all tiles and reset counters
+    void clear();
+
+private:
+    struct Tile
+    {
+        std::size_t lat0;  // First node
+        std::size_t lon0;
+        std::size_t nrLat; // Number of nodes
+        std::vector<float> u;
+        std::vector<float> v;
+
+        std::size_t index(std::size_t lat, std::size_t lon) const noexcept
+        {
+            return (lat - lat0) + (lon - lon0) * nrLat;
+        }
+        std::size_t memory() const noexcept
+        {
+            return (u.size() + v.size()) * sizeof(float);
+        }
+    };
+    using TilePtr = std::shared_ptr<const Tile>;
+
+    /// LRU cache entry, tile is not ready until its load is done
+    struct Entry
+    {
+        std::uint64_t key;
+        std::uint64_t serial;   // Identify the entry across clear()
+        std::size_t memory = 0; // Zero while loading
+        std::shared_future<TilePtr> tile;
+    };
+
+    /*! Find the (\p lat, \p lon) cell tile or load it.
+     * m_mutex must not be locked, the returned tile stay valid even if it's
+     * evicted.
+     */
+    TilePtr tile(std::size_t slice, std::size_t lat, std::size_t lon) const;
+
+    TilePtr load(std::size_t slice,
+                 std::size_t latTile,
+                 std::size_t lonTile) const;
+
+private:
+    ForecastHeader m_header;
+    LinearSpace<latitude_t> m_latSpace;
+    LinearSpace<longitude_t> m_lonSpace;
+    std::size_t m_tileSize;
+    std::size_t m_memoryCap;
+    std::size_t m_nrLatTiles;
+    std::size_t m_nrLonTiles;
+    int m_fd;
+
+    mutable std::mutex m_mutex;
+    mutable std::list<Entry> m_tiles; // Most recently used first
+    mutable std::unordered_map<std::uint64_t, std::list<Entry>::iterator>
+      m_tileIndex;
+    mutable std::uint64_t m_serial = 0;
+    mutable Stats m_stats;
+};
+
+/*! One slice of a PagedForecast.
+ * Cheap to copy, all copies share the same PagedForecast.
+ */
+class PagedWindGrid
+{
+public:
+    using x_space_type = LinearSpace<latitude_t>;
+    using y_space_type = LinearSpace<longitude_t>;
+
+public:
+    PagedWindGrid(std::shared_ptr<const PagedForecast> forecast,
+                  std::size_t slice)
+      : m_forecast(std::move(forecast))
+      , m_slice(slice)
+    {}
+
+    /*! Getter from index.
+     * \warning \p x must be a valid index.
+     * \warning \p y must be a valid index.
+     */
+    WorldMapData operator()(std::size_t x, std::size_t y) const
+    {
+        auto wind = m_forecast->vector(m_slice, x, y);
+        return WorldMapData(wind.bearing(), wind.velocity());
+    }
+
+    /*!
+     * \param[in] x Clamped between [start(), stop()].
+     * \param[in] y Clamped between [start(), stop()].
+     * \return Interpolated value
+     */
+    WorldMapData safeInterpolated(latitude_t x, longitude_t y) const
+    {
+        auto wind = safeInterpolatedVector(x, y);
+        return WorldMapData(wind.bearing(), wind.velocity());
+    }
+
+    /*!
+     * \param[in] x Clamped between [start(), stop()].
+     * \param[in] y Clamped between [start(), stop()].
+     * \return Interpolated wind vector
+     */
+    WindVector safeInterpolatedVector(latitude_t x, longitude_t y) const
+    {
+        return m_forecast->safeInterpolatedVector(m_slice, x, y);
+    }
+
+    /// X linear space getter
+    const x_space_type& xSpace() const noexcept
+    {
+        return m_forecast->latSpace();
+    }
+
+    /// Y linear space getter
+    const y_space_type& ySpace() const noexcept
+    {
+        return m_forecast->lonSpace();
+    }
+
+    const PagedForecast& forecast() const noexcept { return *m_forecast; }
+    std::size_t slice() const noexcept { return m_slice; }
+
+private:
+    std::shared_ptr<const PagedForecast> m_forecast;
+    std::size_t m_slice;
+};
+
+/// Build a TimeWorldMap of PagedWindGrid on all \p forecast slices
+TimeWorldMap
+pagedTimeWorldMap(const std::shared_ptr<const PagedForecast>& forecast);
+
+}
@@ -17,12 +17,23 @@
 #pragma once
 
 // includes
+// std
+#include <cmath>
+
 // tiny_sea
+#include <tiny_sea/core/exception.h>
 #include <tiny_sea/core/n_vector.h>
 #include <tiny_sea/core/units.h>
 
+// Eigen
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
 namespace tiny_sea {
 
+/*! Great circle going through nvector with an initial bearing.
+ * \warning Bearing is not defined on the poles.
+ */
 struct Path
 {
     Path() = default;
@@ -31,9 +42,41 @@ struct Path
       , bearing(p_bearing)
     {}
 
-    static Path fromNVector(const NVector& start, const NVector& stop);
+    /// \return Great circle path going from \p start toward \p stop
+    static Path fromNVector(const NVector& start, const NVector& stop) noexcept
+    {
+        return Path(start, start.bearing(stop));
+    }
+
+    /// \return Unit normal of the great circle plane
+    Eigen::Vector3d normal() const noexcept
+    {
+        Eigen::Vector3d self = nvector.toEigen();
+        Eigen::Vector3d east_vec = Eigen::Vector3d::UnitZ().cross(self);
+        Eigen::Vector3d north_vec = self.cross(east_vec);
+        Eigen::Vector3d direction =
+          std::cos(bearing.t) * north_vec + std::sin(bearing.t) * east_vec;
+        return self.cross(direction).normalized();
+    }
 
-    NVector intersection(const Path& o) const;
+    /*! Intersection of the two paths great circles.
+     * Two great circles cross on two antipodal points, the nearest of this
+     * path start is returned.
+     * \throw Exception if both paths are on the same great circle.
+     */
+    NVector intersection(const Path& o) const
+    {
+        Eigen::Vector3d res = normal().cross(o.normal());
+        double norm = res.norm();
+        if (norm < 1e-12) {
+            throw Exception("Paths are on the same great circle");
+        }
+        res /= norm;
+        if (res.dot(nvector.toEigen()) < 0.) {
+            res = -res;
+        }
+        return NVector(res);
+    }
 
     NVector nvector;
     radian_t bearing;
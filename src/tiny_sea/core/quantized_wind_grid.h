@@ -0,0 +1,370 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+// includes
+// std
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// tiny_sea
+#include <tiny_sea/core/linear_grid.h>
+#include <tiny_sea/core/linear_space.h>
+#include <tiny_sea/core/units.h>
+#include <tiny_sea/core/wind_vector.h>
+#include <tiny_sea/core/world_map_grid.h>
+
+namespace tiny_sea {
+
+/*! Affine quantization of one component:
+ * value = offset + scale * quantized
+ */
+struct Quantization
+{
+    Quantization() = default;
+    Quantization(float p_scale, float p_offset)
+      : scale(p_scale)
+      , offset(p_offset)
+    {}
+
+    /// Compute the quantization that cover [min, max]
+    static Quantization fromRange(float min, float max) noexcept
+    {
+        float scale = (max - min) / float(2 * MAX_VALUE);
+        return Quantization(scale > 0.f ? scale : 1.f, (min + max) / 2.f);
+    }
+
+    std::int16_t quantize(float value) const noexcept
+    {
+        float q = std::round((value - offset) / scale);
+        return std::int16_t(
+          std::clamp(q, -float(MAX_VALUE), float(MAX_VALUE)));
+    }
+
+    float dequantize(float quantized) const noexcept
+    {
+        return offset + scale * quantized;
+    }
+
+    static constexpr std::int16_t MAX_VALUE = 32767;
+
+    float scale = 1.f;
+    float offset = 0.f;
+};
+
+/*! Wind grid storing the wind as WindVector components quantized on 16 bits.
+ * Like WindGrid, components are stored in two planes using the LinearGrid
+ * layout. Each plane have its own Quantization, computed from its range.
+ *
+ * An optional current is stored in two more quantized planes with the same
+ * layout.
+ *
+ * The quantization is affine so quantized values are interpolated first and
+ * dequantized once at the end of the interpolation.
+ */
+class QuantizedWindGrid
+{
+public:
+    using x_space_type = LinearSpace<latitude_t>;
+    using y_space_type = LinearSpace<longitude_t>;
+    using plane_type = std::vector<std::int16_t>;
+
+public:
+    /*! Create a QuantizedWindGrid from two LinearSpace and u/v planes.
+     * \warning \p u and \p v must have the \p (xSpace size + 1)*(ySpace size +
+     * 1) size. The last column and row should be duplicated.
+     */
+    QuantizedWindGrid(const x_space_type& xSpace,
+                      const y_space_type& ySpace,
+                      const plane_type& u,
+                      const plane_type& v,
+                      Quantization uQuantization,
+                      Quantization vQuantization)
+      : m_xSpace(xSpace)
+      , m_ySpace(ySpace)
+      , m_u(u)
+      , m_v(v)
+      , m_uQuantization(uQuantization)
+      , m_vQuantization(vQuantization)
+    {
+        assert(m_u.size() == planeSize());
+        assert(m_v.size() == planeSize());
+    }
+
+    /// Quantize a WorldMapGrid, current planes are only kept if not null
+    explicit QuantizedWindGrid(const WorldMapGrid& grid)
+      : m_xSpace(grid.xSpace())
+      , m_ySpace(grid.ySpace())
+    {
+        const auto& values = grid.values();
+        std::vector<float> u(values.size());
+        std::vector<float> v(values.size());
+        std::vector<float> currentU(values.size());
+        std::vector<float> currentV(values.size());
+        bool current = false;
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            auto wind = WindVector::fromBearing(values[i].windBearing,
+                                                values[i].windVelocity);
+            u[i] = float(wind.m_x.t);
+            v[i] = float(wind.m_y.t);
+            currentU[i] = float(values[i].current.m_x.t);
+            currentV[i] = float(values[i].current.m_y.t);
+            current = current || values[i].hasCurrent();
+        }
+
+        m_uQuantization = quantize(u, m_u);
+        m_vQuantization = quantize(v, m_v);
+        if (current) {
+            m_currentUQuantization = quantize(currentU, m_currentU);
+            m_currentVQuantization = quantize(currentV, m_currentV);
+        }
+    }
+
+    /*! Getter from index.
+     * \warning \p x must be a valid index.
+     * \warning \p y must be a valid index.
+     */
+    WorldMapData operator()(std::size_t x, std::size_t y) const
+    {
+        assert(x < m_xSpace.nrPoints());
+        assert(y < m_ySpace.nrPoints());
+        std::size_t idx = internal::index2D(m_xSpace, m_ySpace, x, y);
+        WindVector wind(velocity_t(m_uQuantization.dequantize(m_u[idx])),
+                        velocity_t(m_vQuantization.dequantize(m_v[idx])));
+        WindVector current(velocity_t(0.), velocity_t(0.));
+        if (hasCurrent()) {
+            current = WindVector(
+              velocity_t(m_currentUQuantization.dequantize(m_currentU[idx])),
+              velocity_t(m_currentVQuantization.dequantize(m_currentV[idx])));
+        }
+        return WorldMapData(wind.bearing(), wind.velocity(), current);
+    }
+
+    /*!
+     * \param[in] x Clamped between [start(), stop()].
+     * \param[in] y Clamped between [start(), stop()].
+     * \return Interpolated wind vector
+     */
+    WindVector safeInterpolatedVector(latitude_t x, longitude_t y) const
+      noexcept
+    {
+        auto resX = m_xSpace.safeInterpolationWeight(x);
+        auto resY = m_ySpace.safeInterpolationWeight(y);
+
+        std::size_t idx00 =
+          internal::index2D(m_xSpace, m_ySpace, resX.index, resY.index);
+        std::size_t idx01 = idx00 + m_xSpace.nrPoints() + 1;
+        float pX = float(resX.percent.t);
+        float pY = float(resY.percent.t);
+
+        float u = bilinear(m_u, idx00, idx01, pX, pY);
+        float v = bilinear(m_v, idx00, idx01, pX, pY);
+        return WindVector(velocity_t(m_uQuantization.dequantize(u)),
+                          velocity_t(m_vQuantization.dequantize(v)));
+    }
+
+    /*!
+     * \param[in] x Clamped between [start(), stop()].
+     * \param[in] y Clamped between [start(), stop()].
+     * \return Interpolated value
+     */
+    WorldMapData safeInterpolated(latitude_t x, longitude_t y) const noexcept
+    {
+        auto wind = safeInterpolatedVector(x, y);
+        if (!hasCurrent()) {
+            return WorldMapData(wind.bearing(), wind.velocity());
+        }
+
+        auto resX = m_xSpace.safeInterpolationWeight(x);
+        auto resY = m_ySpace.safeInterpolationWeight(y);
+        std::size_t idx00 =
+          internal::index2D(m_xSpace, m_ySpace, resX.index, resY.index);
+        std::size_t idx01 = idx00 + m_xSpace.nrPoints() + 1;
+        float pX = float(resX.percent.t);
+        float pY = float(resY.percent.t);
+        float u = bilinear(m_currentU, idx00, idx01, pX, pY);
+        float v = bilinear(m_currentV, idx00, idx01, pX, pY);
+        return WorldMapData(
+          wind.bearing(),
+          wind.velocity(),
+          WindVector(velocity_t(m_currentUQuantization.dequantize(u)),
+                     velocity_t(m_currentVQuantization.dequantize(v))));
+    }
+
+    /// X linear space getter
+    const x_space_type& xSpace() const noexcept { return m_xSpace; }
+
+    /// Y linear space getter
+    const y_space_type& ySpace() const noexcept { return m_ySpace; }
+
+    /// West to east quantized component plane
+    const plane_type& u() const noexcept { return m_u; }
+
+    /// South to north quantized component plane
+    const plane_type& v() const noexcept { return m_v; }
+
+    /// Current west to east quantized plane, empty if there is no current
+    const plane_type& currentU() const noexcept { return m_currentU; }
+
+    /// Current south to north quantized plane, empty if there is no current
+    const plane_type& currentV() const noexcept { return m_currentV; }
+
+    /// \return true if current planes are stored
+    bool hasCurrent() const noexcept { return !m_currentU.empty(); }
+
+    Quantization uQuantization() const noexcept { return m_uQuantization; }
+    Quantization vQuantization() const noexcept { return m_vQuantization; }
+    Quantization currentUQuantization() const noexcept
+    {
+        return m_currentUQuantization;
+    }
+    Quantization currentVQuantization() const noexcept
+    {
+        return m_currentVQuantization;
+    }
+
+    /// Memory used by the planes in bytes
+    std::size_t memory() const noexcept
+    {
+        return (m_u.size() + m_v.size() + m_currentU.size() +
+                m_currentV.size()) *
+               sizeof(std::int16_t);
+    }
+
+private:
+    std::size_t planeSize() const noexcept
+    {
+        return (m_xSpace.nrPoints() + 1) * (m_ySpace.nrPoints() + 1);
+    }
+
+    /// Quantize \p values in \p plane with a quantization covering them
+    static Quantization quantize(const std::vector<float>& values,
+                                 plane_type& plane)
+    {
+        auto range = std::minmax_element(values.begin(), values.end());
+        auto quantization =
+          Quantization::fromRange(*range.first, *range.second);
+        plane.resize(values.size());
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            plane[i] = quantization.quantize(values[i]);
+        }
+        return quantization;
+    }
+
+    static float bilinear(const plane_type& plane,
+                          std::size_t idx00,
+                          std::size_t idx01,
+                          float pX,
+                          float pY) noexcept
+    {
+        float y0 = float(plane[idx00]) +
+                   float(plane[idx00 + 1] - plane[idx00]) * pX;
+        float y1 = float(plane[idx01]) +
+                   float(plane[idx01 + 1] - plane[idx01]) * pX;
+        return y0 + (y1 - y0) * pY;
+    }
+
+private:
+    x_space_type m_xSpace;
+    y_space_type m_ySpace;
+    plane_type m_u;
+    plane_type m_v;
+    plane_type m_currentU;
+    plane_type m_currentV;
+    Quantization m_uQuantization;
+    Quantization m_vQuantization;
+    Quantization m_currentUQuantization;
+    Quantization m_currentVQuantization;
+};
+
+/*! Error of a wind grid against the double precision reference.
+ */
+struct WindGridError
+{
+    velocity_t maxVelocity = velocity_t(0.); //< Max wind vector error norm
+    velocity_t rmsVelocity = velocity_t(0.); //< RMS wind vector error norm
+    std::size_t nrSamples = 0;               //< Number of compared samples
+};
+
+/*! Measure \p grid error against \p reference.
+ * Reference is the double precision bilinear interpolation of \p reference
+ * node wind vectors. Each cell is sampled \p subdivisions times along each
+ * axis.
+ * \tparam Grid Must define safeInterpolatedVector(latitude_t, longitude_t).
+ */
+template<typename Grid>
+WindGridError
+measureError(const WorldMapGrid& reference,
+             const Grid& grid,
+             std::size_t subdivisions = 4)
+{
+    const auto& xSpace = reference.xSpace();
+    const auto& ySpace = reference.ySpace();
+    auto nodeVector = [&](std::size_t x, std::size_t y) {
+        auto data = reference(std::min(x, xSpace.nrPoints() - 1),
+                              std::min(y, ySpace.nrPoints() - 1));
+        return WindVector::fromBearing(data.windBearing, data.windVelocity);
+    };
+
+    WindGridError error;
+    double sum = 0.;
+    for (std::size_t x = 0; x < xSpace.nrPoints(); ++x) {
+        for (std::size_t y = 0; y < ySpace.nrPoints(); ++y) {
+            auto w00 = nodeVector(x, y);
+            auto w10 = nodeVector(x + 1, y);
+            auto w01 = nodeVector(x, y + 1);
+            auto w11 = nodeVector(x + 1, y + 1);
+            for (std::size_t sx = 0; sx < subdivisions; ++sx) {
+                for (std::size_t sy = 0; sy < subdivisions; ++sy) {
+                    double pX = double(sx) / double(subdivisions);
+                    double pY = double(sy) / double(subdivisions);
+                    if ((pX > 0. && x + 1 == xSpace.nrPoints()) ||
+                        (pY > 0. && y + 1 == ySpace.nrPoints())) {
+                        continue;
+                    }
+                    auto lerp = [&](velocity_t v00,
+                                    velocity_t v10,
+                                    velocity_t v01,
+                                    velocity_t v11) {
+                        double y0 = v00.t + (v10.t - v00.t) * pX;
+                        double y1 = v01.t + (v11.t - v01.t) * pX;
+                        return y0 + (y1 - y0) * pY;
+                    };
+                    double u = lerp(w00.m_x, w10.m_x, w01.m_x, w11.m_x);
+                    double v = lerp(w00.m_y, w10.m_y, w01.m_y, w11.m_y);
+
+                    auto res = grid.safeInterpolatedVector(
+                      xSpace.value(x) + xSpace.delta() * scale_t(pX),
+                      ySpace.value(y) + ySpace.delta() * scale_t(pY));
+                    double err = std::hypot(res.m_x.t - u, res.m_y.t - v);
+                    error.maxVelocity =
+                      std::max(error.maxVelocity, velocity_t(err));
+                    sum += err * err;
+                    ++error.nrSamples;
+                }
+            }
+        }
+    }
+    error.rmsVelocity = velocity_t(
+      std::sqrt(sum / double(std::max<std::size_t>(error.nrSamples, 1))));
+    return error;
+}
+
+}
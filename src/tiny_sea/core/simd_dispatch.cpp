@@ -0,0 +1,131 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// associated header
+#include <tiny_sea/core/simd_dispatch.h>
+
+// includes
+// std
+#include <string>
+
+// tiny_sea
+#include <tiny_sea/core/exception.h>
+
+namespace tiny_sea {
+
+namespace simd {
+
+// Variants defined in simd_kernels_*.cpp
+namespace scalar {
+const Kernels&
+variantKernels() noexcept;
+}
+namespace sse42 {
+const Kernels&
+variantKernels() noexcept;
+}
+namespace avx2 {
+const Kernels&
+variantKernels() noexcept;
+}
+namespace avx512 {
+const Kernels&
+variantKernels() noexcept;
+}
+
+namespace {
+
+const Kernels&
+bestKernels() noexcept
+{
+    for (Isa isa : { Isa::AVX512, Isa::AVX2, Isa::SSE42 }) {
+        if (supported(isa)) {
+            return kernels(isa);
+        }
+    }
+    return scalar::variantKernels();
+}
+
+}
+
+const char*
+isaName(Isa isa) noexcept
+{
+    switch (isa) {
+        case Isa::SCALAR:
+            return "scalar";
+        case Isa::SSE42:
+            return "sse4.2";
+        case Isa::AVX2:
+            return "avx2";
+        case Isa::AVX512:
+            return "avx512";
+    }
+    return "unknown";
+}
+
+bool
+supported(Isa isa) noexcept
+{
+    // Variants are only compiled with their instruction set on x86, see
+    // src/CMakeLists.txt
+#if defined(TINY_SEA_SIMD_X86)
+    __builtin_cpu_init();
+    switch (isa) {
+        case Isa::SCALAR:
+            return true;
+        case Isa::SSE42:
+            return __builtin_cpu_supports("sse4.2");
+        case Isa::AVX2:
+            return __builtin_cpu_supports("avx2");
+        case Isa::AVX512:
+            return __builtin_cpu_supports("avx512f");
+    }
+    return false;
+#else
+    return isa == Isa::SCALAR;
+#endif
+}
+
+const Kernels&
+kernels(Isa isa)
+{
+    if (!supported(isa)) {
+        throw Exception(std::string("Unsupported instruction set ") +
+                        isaName(isa));
+    }
+    switch (isa) {
+        case Isa::SSE42:
+            return sse42::variantKernels();
+        case Isa::AVX2:
+            return avx2::variantKernels();
+        case Isa::AVX512:
+            return avx512::variantKernels();
+        default:
+            return scalar::variantKernels();
+    }
+}
+
+const Kernels&
+kernels() noexcept
+{
+    static const Kernels& best = bestKernels();
+    return best;
+}
+
+}
+
+}
@@ -0,0 +1,119 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+// includes
+// std
+#include <cstddef>
+
+namespace tiny_sea {
+
+namespace simd {
+
+/// Instruction set a kernels variant is compiled for
+enum class Isa
+{
+    SCALAR,
+    SSE42,
+    AVX2,
+    AVX512
+};
+
+/*! Hot numeric kernels of one instruction set.
+ * Arrays are structure of arrays and must not overlap the outputs.
+ * All variants do the same operations in the same order, without fused
+ * multiply-add (kernel sources are built with -ffp-contract=off), so they
+ * give the same results.
+ *
+ * Only lerp and bilinear are vectorized by the instruction set variants.
+ * destination and distance call the scalar libm cos, sin and atan2 on
+ * each point, so their variants are not faster than the scalar ones.
+ */
+struct Kernels
+{
+    Isa isa;
+
+    /// Polar evaluation: res[i] = v0[i] + (v1[i] - v0[i]) * percent
+    void (*lerp)(const double* v0,
+                 const double* v1,
+                 double percent,
+                 std::size_t size,
+                 double* res);
+
+    /*! Bilinear interpolation of a float plane.
+     * \param rowSize Offset between a node and its next y node.
+     * \param idx00 Index of the lower corner of each point.
+     * \param pX Percent along x of each point.
+     * \param pY Percent along y of each point.
+     */
+    void (*bilinear)(const float* plane,
+                     std::size_t rowSize,
+                     const std::size_t* idx00,
+                     const float* pX,
+                     const float* pY,
+                     std::size_t size,
+                     float* res);
+
+    /*! NVector destinations from one origin toward \p size bearings.
+     * \param origin x, y, z of the origin NVector.
+     * \param bearing Orientation from north clockwise in radian.
+     * \param angle Distance as an angle in radian, shared by all points.
+     * \param x, y, z Destination NVector components.
+     */
+    void (*destination)(const double* origin,
+                        const double* bearing,
+                        double angle,
+                        std::size_t size,
+                        double* x,
+                        double* y,
+                        double* z);
+
+    /*! Distances between one target and \p size NVector.
+     * \param target x, y, z of the target NVector.
+     * \param res Distances as an angle in radian.
+     */
+    void (*distance)(const double* target,
+                     const double* x,
+                     const double* y,
+                     const double* z,
+                     std::size_t size,
+                     double* res);
+};
+
+/// \return Instruction set name
+const char*
+isaName(Isa isa) noexcept;
+
+/// \return true if \p isa kernels are built and supported by the CPU
+bool
+supported(Isa isa) noexcept;
+
+/*! \return Kernels of \p isa
+ * \throw Exception if \p isa is not supported.
+ */
+const Kernels&
+kernels(Isa isa);
+
+/*! \return Kernels of the best supported instruction set.
+ * The instruction set is chosen on the first call.
+ */
+const Kernels&
+kernels() noexcept;
+
+}
+
+}
@@ -0,0 +1,142 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// Kernels body, only included by simd_kernels_*.cpp.
+// Each file define TINY_SEA_SIMD_NAMESPACE and TINY_SEA_SIMD_ISA and is
+// compiled with its own instruction set flags.
+//
+// Kernels are plain loops left to the compiler auto-vectorization. They must
+// not call inline functions shared with other translation units (Eigen,
+// std::min, ...): the linker could keep the copy compiled for the widest
+// instruction set and run it on any CPU.
+//
+// destination and distance loops call libm cos, sin and atan2, which are not
+// vectorized without -ffast-math. Only lerp and bilinear benefit from the
+// instruction set variants.
+
+#pragma once
+
+// includes
+// std
+#include <cmath>
+#include <cstddef>
+
+// tiny_sea
+#include <tiny_sea/core/simd_dispatch.h>
+
+#if !defined(TINY_SEA_SIMD_NAMESPACE) || !defined(TINY_SEA_SIMD_ISA)
+#error "TINY_SEA_SIMD_NAMESPACE and TINY_SEA_SIMD_ISA must be defined"
+#endif
+
+namespace tiny_sea {
+
+namespace simd {
+
+namespace TINY_SEA_SIMD_NAMESPACE {
+
+namespace {
+
+void
+lerp(const double* v0,
+     const double* v1,
+     double percent,
+     std::size_t size,
+     double* res)
+{
+    for (std::size_t i = 0; i < size; ++i) {
+        res[i] = v0[i] + (v1[i] - v0[i]) * percent;
+    }
+}
+
+void
+bilinear(const float* plane,
+         std::size_t rowSize,
+         const std::size_t* idx00,
+         const float* pX,
+         const float* pY,
+         std::size_t size,
+         float* res)
+{
+    for (std::size_t i = 0; i < size; ++i) {
+        const float* c = plane + idx00[i];
+        float y0 = c[0] + (c[1] - c[0]) * pX[i];
+        float y1 = c[rowSize] + (c[rowSize + 1] - c[rowSize]) * pX[i];
+        res[i] = y0 + (y1 - y0) * pY[i];
+    }
+}
+
+void
+destination(const double* origin,
+            const double* bearing,
+            double angle,
+            std::size_t size,
+            double* x,
+            double* y,
+            double* z)
+{
+    // Same frame than NVector::destination: east = Z x origin and
+    // north = origin x east
+    double sx = origin[0], sy = origin[1], sz = origin[2];
+    double ex = -sy, ey = sx;
+    double nx = -sz * sx, ny = -sz * sy, nz = sx * sx + sy * sy;
+    double ca = std::cos(angle);
+    double sa = std::sin(angle);
+    for (std::size_t i = 0; i < size; ++i) {
+        double cb = std::cos(bearing[i]);
+        double sb = std::sin(bearing[i]);
+        x[i] = ca * sx + sa * (cb * nx + sb * ex);
+        y[i] = ca * sy + sa * (cb * ny + sb * ey);
+        z[i] = ca * sz + sa * (cb * nz);
+    }
+}
+
+void
+distance(const double* target,
+         const double* x,
+         const double* y,
+         const double* z,
+         std::size_t size,
+         double* res)
+{
+    double tx = target[0], ty = target[1], tz = target[2];
+    for (std::size_t i = 0; i < size; ++i) {
+        double cx = ty * z[i] - tz * y[i];
+        double cy = tz * x[i] - tx * z[i];
+        double cz = tx * y[i] - ty * x[i];
+        double dot = tx * x[i] + ty * y[i] + tz * z[i];
+        res[i] = std::atan2(std::sqrt(cx * cx + cy * cy + cz * cz), dot);
+    }
+}
+
+const Kernels KERNELS = { TINY_SEA_SIMD_ISA,
+                          &lerp,
+                          &bilinear,
+                          &destination,
+                          &distance };
+
+}
+
+const Kernels&
+variantKernels() noexcept
+{
+    return KERNELS;
+}
+
+}
+
+}
+
+}
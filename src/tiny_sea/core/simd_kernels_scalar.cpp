@@ -0,0 +1,24 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// Reference kernels, compiled without extra instruction set flags
+
+#define TINY_SEA_SIMD_NAMESPACE scalar
+#define TINY_SEA_SIMD_ISA Isa::SCALAR
+
+// includes
+// tiny_sea
+#include <tiny_sea/core/simd_kernels.h>
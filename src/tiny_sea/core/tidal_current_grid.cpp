@@ -0,0 +1,174 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// associated header
+#include <tiny_sea/core/tidal_current_grid.h>
+
+// includes
+// std
+#include <algorithm>
+#include <cmath>
+
+// tiny_sea
+#include <tiny_sea/core/exception.h>
+
+namespace tiny_sea {
+
+TidalCurrentGrid::TidalCurrentGrid(
+  const LinearSpace<latitude_t>& latSpace,
+  const LinearSpace<longitude_t>& lonSpace,
+  const NonUniformSpace<time_t>& timeSpace,
+  const std::vector<TidalConstituent>& constituents,
+  const std::vector<float>& coefficients)
+  : m_latSpace(latSpace)
+  , m_lonSpace(lonSpace)
+  , m_timeSpace(timeSpace)
+  , m_speeds(constituents.size())
+  , m_nodalFactors(constituents.size())
+  , m_arguments(constituents.size(), timeSpace.nrPoints())
+{
+    std::size_t nx = latSpace.nrPoints();
+    std::size_t ny = lonSpace.nrPoints();
+    std::size_t size = nodeSize();
+    if (constituents.size() > std::size_t(MAX_CONSTITUENTS)) {
+        throw Exception("Too many tidal constituents");
+    }
+    if (coefficients.size() != nx * ny * size) {
+        throw Exception("Tidal coefficients size doesn't match the grid");
+    }
+
+    // Arguments are computed in double then wrapped, so the float
+    // evaluation only see a small time offset
+    for (std::size_t k = 0; k < constituents.size(); ++k) {
+        const auto& c = constituents[k];
+        m_speeds(k) = float(c.speed);
+        m_nodalFactors(k) = float(c.nodalFactor);
+        for (std::size_t s = 0; s < timeSpace.nrPoints(); ++s) {
+            double arg = c.phase.t + c.speed * timeSpace.value(s).t;
+            arg = std::fmod(arg, 2. * PI);
+            m_arguments(k, s) = float(arg < 0. ? arg + 2. * PI : arg);
+        }
+    }
+
+    // Also fill the duplicated last row and column
+    m_values.resize((nx + 1) * (ny + 1) * size);
+    for (std::size_t lon = 0; lon < ny + 1; ++lon) {
+        for (std::size_t lat = 0; lat < nx + 1; ++lat) {
+            std::size_t src =
+              (std::min(lat, nx - 1) + std::min(lon, ny - 1) * nx) * size;
+            std::copy(coefficients.begin() + src,
+                      coefficients.begin() + src + size,
+                      m_values.begin() + offset(lat, lon));
+        }
+    }
+}
+
+WindVector
+TidalCurrentGrid::current(time_t time, latitude_t lat, longitude_t lon) const
+{
+    if (nrConstituents() == 0) {
+        return WindVector(velocity_t(0.), velocity_t(0.));
+    }
+
+    // Time weights from the arguments cached at the slice before time
+    time = std::clamp(time, m_timeSpace.start(), m_timeSpace.stop());
+    auto slice = m_timeSpace.index(time);
+    float dt = float((time - m_timeSpace.value(slice)).t);
+    using arg_type =
+      Eigen::Array<float, Eigen::Dynamic, 1, 0, MAX_CONSTITUENTS, 1>;
+    using weights_type =
+      Eigen::Array<float, Eigen::Dynamic, 1, 0, 2 * MAX_CONSTITUENTS, 1>;
+    std::size_t nrK = nrConstituents();
+    arg_type arg = m_arguments.col(slice).array() + m_speeds * dt;
+    weights_type weights(2 * nrK);
+    weights.head(nrK) = m_nodalFactors * arg.cos();
+    weights.tail(nrK) = m_nodalFactors * arg.sin();
+
+    // Blend the four corner nodes coefficients
+    auto resLat = m_latSpace.safeInterpolationWeight(lat);
+    auto resLon = m_lonSpace.safeInterpolationWeight(lon);
+
+    using map_type = Eigen::Map<const float_array_type>;
+    const float* data = m_values.data();
+    std::size_t size = nodeSize();
+    map_type n00(data + offset(resLat.index, resLon.index), size);
+    map_type n10(data + offset(resLat.index + 1, resLon.index), size);
+    map_type n01(data + offset(resLat.index, resLon.index + 1), size);
+    map_type n11(data + offset(resLat.index + 1, resLon.index + 1), size);
+
+    // Lazy expressions, the blend is evaluated inside the dot products
+    float pLat = float(resLat.percent.t);
+    float pLon = float(resLon.percent.t);
+    auto y0 = n00 + (n10 - n00) * pLat;
+    auto y1 = n01 + (n11 - n01) * pLat;
+    auto res = y0 + (y1 - y0) * pLon;
+
+    float u = (res.head(2 * nrK) * weights).sum();
+    float v = (res.tail(2 * nrK) * weights).sum();
+    return WindVector(velocity_t(u), velocity_t(v));
+}
+
+velocity_t
+TidalCurrentGrid::speedBound(std::size_t x, std::size_t y) const noexcept
+{
+    std::size_t nrK = nrConstituents();
+    const float* node = m_values.data() + offset(x, y);
+    double bound = 0.;
+    for (std::size_t k = 0; k < nrK; ++k) {
+        double uc = node[k];
+        double us = node[nrK + k];
+        double vc = node[2 * nrK + k];
+        double vs = node[3 * nrK + k];
+        bound += std::abs(double(m_nodalFactors(Eigen::Index(k)))) *
+                 std::sqrt(uc * uc + us * us + vc * vc + vs * vs);
+    }
+    return velocity_t(bound);
+}
+
+velocity_t
+TidalCurrentGrid::maxSpeedBound() const noexcept
+{
+    velocity_t res(0.);
+    for (std::size_t lon = 0; lon < m_lonSpace.nrPoints(); ++lon) {
+        for (std::size_t lat = 0; lat < m_latSpace.nrPoints(); ++lat) {
+            res = std::max(res, speedBound(lat, lon));
+        }
+    }
+    return res;
+}
+
+void
+TidalCurrentGridBuilder::set(std::size_t x,
+                             std::size_t y,
+                             std::size_t constituent,
+                             const TidalHarmonic& u,
+                             const TidalHarmonic& v)
+{
+    std::size_t nrK = m_constituents.size();
+    if (x >= m_latSpace.nrPoints() || y >= m_lonSpace.nrPoints() ||
+        constituent >= nrK) {
+        throw Exception("Tidal harmonic index out of range");
+    }
+
+    float* node =
+      m_coefficients.data() + (x + y * m_latSpace.nrPoints()) * 4 * nrK;
+    node[constituent] = float(u.amplitude.t * std::cos(u.phase.t));
+    node[nrK + constituent] = float(u.amplitude.t * std::sin(u.phase.t));
+    node[2 * nrK + constituent] = float(v.amplitude.t * std::cos(v.phase.t));
+    node[3 * nrK + constituent] = float(v.amplitude.t * std::sin(v.phase.t));
+}
+
+}
@@ -0,0 +1,233 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+// includes
+// std
+#include <vector>
+
+// tiny_sea
+#include <tiny_sea/core/linear_space.h>
+#include <tiny_sea/core/non_uniform_space.h>
+#include <tiny_sea/core/units.h>
+#include <tiny_sea/core/wind_vector.h>
+
+// Eigen
+#include <Eigen/Core>
+
+namespace tiny_sea {
+
+/*! Tidal constituent shared by all the nodes of a TidalCurrentGrid.
+ * The constituent astronomical argument at time t is
+ * phase + speed * t, its amplitude is scaled by nodalFactor.
+ */
+struct TidalConstituent
+{
+    // Speeds of the main constituents in degrees per hour
+    static constexpr double M2 = 28.9841042;
+    static constexpr double S2 = 30.;
+    static constexpr double N2 = 28.4397295;
+    static constexpr double K2 = 30.0821373;
+    static constexpr double K1 = 15.0410686;
+    static constexpr double O1 = 13.9430356;
+    static constexpr double P1 = 14.9589314;
+    static constexpr double M4 = 57.9682084;
+
+    TidalConstituent(double p_speed, radian_t p_phase, double p_nodalFactor)
+      : speed(p_speed)
+      , phase(p_phase)
+      , nodalFactor(p_nodalFactor)
+    {}
+
+    /*! Create a constituent from a speed in degrees per hour.
+     * \param phase Astronomical argument (V0 + u) at time 0.
+     */
+    static TidalConstituent fromDegreesPerHour(double degreesPerHour,
+                                               radian_t phase,
+                                               double nodalFactor = 1.)
+    {
+        return TidalConstituent(
+          degreesPerHour * PI / (180. * 3600.), phase, nodalFactor);
+    }
+
+    double speed;       // Angular speed in radian by second
+    radian_t phase;     // Astronomical argument at time 0
+    double nodalFactor; // Amplitude nodal factor
+};
+
+/// Amplitude and phase lag of a constituent on one current component
+struct TidalHarmonic
+{
+    velocity_t amplitude;
+    radian_t phase;
+};
+
+/*! Tidal current computed from harmonic constituents stored by node.
+ *
+ * Each node store for each constituent k the u and v harmonics as
+ * (A cos(g), A sin(g)) pairs, so a component is the dot product of the node
+ * coefficients with the time weights (f cos(a(t)), f sin(a(t))):
+ *
+ * u(t) = sum_k f_k A_k cos(a_k(t) - g_k)
+ *
+ * node (lat, lon) : [uc(k0) ... uc(kn) us(k0) ... us(kn) vc(k0) ... vs(kn)]
+ *
+ * The argument of each constituent is cached, wrapped in [0, 2PI[, at each
+ * time slice. A query only add speed * (t - slice time) to the cached
+ * arguments, so sine and cosine are computed in float by the Eigen
+ * vectorized kernels. Coefficients of the four corner nodes are blended
+ * with the bilinear weights inside the two dot products. Time weights use
+ * fixed capacity arrays, so a query never allocate.
+ *
+ * A few constituents by node cost far less memory than hourly gridded
+ * currents of a multi-day race.
+ */
+class TidalCurrentGrid
+{
+public:
+    using float_array_type = Eigen::ArrayXf;
+
+    /// Maximum number of constituents
+    static constexpr int MAX_CONSTITUENTS = 32;
+
+public:
+    /*!
+     * \param timeSpace Times of the cached arguments, queries are clamped
+     * in [start(), stop()].
+     * \param coefficients Node coefficients with the node layout, nodes
+     * stored with the x + y*latSpace.nrPoints() layout.
+     * \throw Exception if \p coefficients size doesn't match the spaces and
+     * the number of constituents, or if there are more than
+     * MAX_CONSTITUENTS constituents.
+     */
+    TidalCurrentGrid(const LinearSpace<latitude_t>& latSpace,
+                     const LinearSpace<longitude_t>& lonSpace,
+                     const NonUniformSpace<time_t>& timeSpace,
+                     const std::vector<TidalConstituent>& constituents,
+                     const std::vector<float>& coefficients);
+
+    /*! Evaluate the current.
+     * \param[in] time Clamped between [start(), stop()].
+     * \param[in] lat Clamped between [start(), stop()].
+     * \param[in] lon Clamped between [start(), stop()].
+     * \return Current u/v components
+     */
+    WindVector current(time_t time, latitude_t lat, longitude_t lon) const;
+
+    /*! Current speed upper bound of node (\p x, \p y) for all times:
+     * sum_k f_k sqrt(Au_k^2 + Av_k^2).
+     * An interpolated current is bounded by the bounds of its corner nodes.
+     * \warning \p x and \p y must be valid index.
+     */
+    velocity_t speedBound(std::size_t x, std::size_t y) const noexcept;
+
+    /// Largest speedBound of all the nodes
+    velocity_t maxSpeedBound() const noexcept;
+
+    const LinearSpace<latitude_t>& latSpace() const noexcept
+    {
+        return m_latSpace;
+    }
+
+    const LinearSpace<longitude_t>& lonSpace() const noexcept
+    {
+        return m_lonSpace;
+    }
+
+    const NonUniformSpace<time_t>& timeSpace() const noexcept
+    {
+        return m_timeSpace;
+    }
+
+    std::size_t nrConstituents() const noexcept
+    {
+        return std::size_t(m_speeds.size());
+    }
+
+    /// Memory used by the node coefficients in bytes
+    std::size_t memory() const noexcept
+    {
+        return m_values.size() * sizeof(float);
+    }
+
+private:
+    /// \return Number of float stored by node
+    std::size_t nodeSize() const noexcept { return 4 * nrConstituents(); }
+
+    /// \return Value offset of a node, duplicated last row and column
+    std::size_t offset(std::size_t lat, std::size_t lon) const noexcept
+    {
+        return (lat + lon * (m_latSpace.nrPoints() + 1)) * nodeSize();
+    }
+
+private:
+    LinearSpace<latitude_t> m_latSpace;
+    LinearSpace<longitude_t> m_lonSpace;
+    NonUniformSpace<time_t> m_timeSpace;
+    float_array_type m_speeds;
+    float_array_type m_nodalFactors;
+    /// Wrapped arguments, one column by time slice
+    Eigen::MatrixXf m_arguments;
+    std::vector<float> m_values;
+};
+
+/*! Helper class to build TidalCurrentGrid.
+ * Harmonics not set are null.
+ */
+class TidalCurrentGridBuilder
+{
+public:
+    /// \see TidalCurrentGrid
+    TidalCurrentGridBuilder(const LinearSpace<latitude_t>& latSpace,
+                            const LinearSpace<longitude_t>& lonSpace,
+                            const NonUniformSpace<time_t>& timeSpace,
+                            std::vector<TidalConstituent> constituents)
+      : m_latSpace(latSpace)
+      , m_lonSpace(lonSpace)
+      , m_timeSpace(timeSpace)
+      , m_constituents(std::move(constituents))
+      , m_coefficients(latSpace.nrPoints() * lonSpace.nrPoints() * 4 *
+                         m_constituents.size(),
+                       0.f)
+    {}
+
+    /*! Set the harmonics of \p constituent at node (\p x, \p y).
+     * \param u West to east component harmonic.
+     * \param v South to north component harmonic.
+     * \throw Exception if an index is out of range.
+     */
+    void set(std::size_t x,
+             std::size_t y,
+             std::size_t constituent,
+             const TidalHarmonic& u,
+             const TidalHarmonic& v);
+
+    TidalCurrentGrid build() const
+    {
+        return TidalCurrentGrid(
+          m_latSpace, m_lonSpace, m_timeSpace, m_constituents, m_coefficients);
+    }
+
+private:
+    LinearSpace<latitude_t> m_latSpace;
+    LinearSpace<longitude_t> m_lonSpace;
+    NonUniformSpace<time_t> m_timeSpace;
+    std::vector<TidalConstituent> m_constituents;
+    std::vector<float> m_coefficients;
+};
+
+}
@@ -0,0 +1,157 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// associated header
+#include <tiny_sea/core/time_obstacle_index.h>
+
+// includes
+// std
+#include <algorithm>
+#include <utility>
+
+// tiny_sea
+#include <tiny_sea/core/exception.h>
+
+namespace tiny_sea {
+
+TimeObstacle::TimeObstacle(EdgeIndex p_edges,
+                           const std::vector<NVector>& polygon,
+                           time_t p_start,
+                           time_t p_stop)
+  : edges(std::move(p_edges))
+  , minVertex(latitude_t(0.), longitude_t(0.))
+  , maxVertex(latitude_t(0.), longitude_t(0.))
+  , start(p_start)
+  , stop(p_stop)
+{
+    vertices.reserve(polygon.size());
+    for (const auto& p : polygon) {
+        vertices.push_back(p.toLatLon());
+    }
+    if (!vertices.empty()) {
+        minVertex = maxVertex = vertices.front();
+        for (const auto& v : vertices) {
+            minVertex.first = std::min(minVertex.first, v.first);
+            minVertex.second = std::min(minVertex.second, v.second);
+            maxVertex.first = std::max(maxVertex.first, v.first);
+            maxVertex.second = std::max(maxVertex.second, v.second);
+        }
+    }
+}
+
+bool
+TimeObstacle::inside(const NVector& position) const noexcept
+{
+    auto p = position.toLatLon();
+    if (vertices.size() < 3 || p.first < minVertex.first ||
+        p.first > maxVertex.first || p.second < minVertex.second ||
+        p.second > maxVertex.second) {
+        return false;
+    }
+
+    // Count the edges crossed by a ray from p toward the east
+    double lat = p.first.t;
+    double lon = p.second.t;
+    bool res = false;
+    for (std::size_t i = 0, j = vertices.size() - 1; i < vertices.size();
+         j = i++) {
+        double latI = vertices[i].first.t;
+        double lonI = vertices[i].second.t;
+        double latJ = vertices[j].first.t;
+        double lonJ = vertices[j].second.t;
+        if ((latI > lat) != (latJ > lat) &&
+            lon < lonI + (lonJ - lonI) * (lat - latI) / (latJ - latI)) {
+            res = !res;
+        }
+    }
+    return res;
+}
+
+TimeObstacleIndex::TimeObstacleIndex(const NonUniformSpace<time_t>& timeSpace,
+                                     std::vector<TimeObstacle> obstacles)
+  : m_timeSpace(timeSpace)
+  , m_obstacles(std::move(obstacles))
+{
+    // Slices overlapping [start, stop[ of each zone
+    std::vector<std::pair<std::size_t, std::size_t>> ranges;
+    for (const auto& obstacle : m_obstacles) {
+        std::size_t first = m_timeSpace.safeIndex(obstacle.start);
+        std::size_t last = m_timeSpace.safeIndex(obstacle.stop);
+        if (last > first && obstacle.stop <= m_timeSpace.value(last)) {
+            --last;
+        }
+        ranges.emplace_back(first, last);
+    }
+
+    // Count zones by slice, then fill slices
+    m_offsets.assign(m_timeSpace.nrPoints() + 1, 0);
+    for (const auto& range : ranges) {
+        for (std::size_t s = range.first; s <= range.second; ++s) {
+            ++m_offsets[s + 1];
+        }
+    }
+    for (std::size_t s = 1; s < m_offsets.size(); ++s) {
+        m_offsets[s] += m_offsets[s - 1];
+    }
+
+    m_active.resize(m_offsets.back());
+    std::vector<std::uint32_t> next(m_offsets.begin(), m_offsets.end() - 1);
+    for (std::size_t i = 0; i < ranges.size(); ++i) {
+        for (std::size_t s = ranges[i].first; s <= ranges[i].second; ++s) {
+            m_active[next[s]++] = std::uint32_t(i);
+        }
+    }
+}
+
+bool
+TimeObstacleIndex::blocked(const NVector& from,
+                           const NVector& to,
+                           time_t t0,
+                           time_t t1) const noexcept
+{
+    std::size_t first = m_timeSpace.safeIndex(t0);
+    std::size_t last = m_timeSpace.safeIndex(t1);
+    for (std::size_t s = first; s <= last; ++s) {
+        for (std::size_t i = m_offsets[s]; i < m_offsets[s + 1]; ++i) {
+            const auto& obstacle = m_obstacles[m_active[i]];
+            // Already tested in a previous slice of the move
+            if (s > first && obstacle.start < m_timeSpace.value(s)) {
+                continue;
+            }
+            if (obstacle.active(t0, t1) &&
+                (obstacle.inside(from) || obstacle.inside(to) ||
+                 obstacle.edges.crossed(from, to))) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void
+TimeObstacleIndexBuilder::addZone(const std::vector<NVector>& polygon,
+                                  time_t start,
+                                  time_t stop)
+{
+    if (stop <= start) {
+        throw Exception("Zone stop time must be after its start time");
+    }
+    EdgeIndexBuilder builder(m_bucketSize);
+    builder.addPolygon(polygon);
+    m_obstacles.emplace_back(builder.build(), polygon, start, stop);
+}
+
+}
@@ -0,0 +1,163 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+// includes
+// std
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// tiny_sea
+#include <tiny_sea/core/edge_index.h>
+#include <tiny_sea/core/n_vector.h>
+#include <tiny_sea/core/non_uniform_space.h>
+#include <tiny_sea/core/units.h>
+
+namespace tiny_sea {
+
+/*! Exclusion zone active during a time window.
+ */
+struct TimeObstacle
+{
+    using vertex_type = std::pair<latitude_t, longitude_t>;
+
+    /// \param polygon Closed polygon of the zone, \see EdgeIndexBuilder
+    TimeObstacle(EdgeIndex p_edges,
+                 const std::vector<NVector>& polygon,
+                 time_t p_start,
+                 time_t p_stop);
+
+    /// \return true if [\p t0, \p t1] overlap the [start, stop[ window
+    bool active(time_t t0, time_t t1) const noexcept
+    {
+        return t0 < stop && t1 >= start;
+    }
+
+    /*! Even-odd point in polygon test on latitude and longitude.
+     * Edges are approximated by latitude and longitude segments, like the
+     * EdgeIndex buckets.
+     * \warning Zones crossing the antimeridian are not supported.
+     */
+    bool inside(const NVector& position) const noexcept;
+
+    EdgeIndex edges;
+    std::vector<vertex_type> vertices;
+    vertex_type minVertex; //< Bounding box south west corner
+    vertex_type maxVertex; //< Bounding box north east corner
+    time_t start;
+    time_t stop;
+};
+
+/*! Index of exclusion zones only active during a time window, like
+ * firing ranges, moving ice limits or other vessels predicted tracks.
+ *
+ * Zones are bucketed by TimeWorldMap slices: slice s bucket store the zones
+ * active in [value(s), value(s + 1)[, the last one the zones active after
+ * the last slice. A query only test the zones of the slices crossed by the
+ * move time interval, then their time window and their edges.
+ *
+ * A moving obstacle is a sequence of zones with consecutive windows.
+ */
+class TimeObstacleIndex
+{
+public:
+    /*!
+     * \param timeSpace Slices time space, \see TimeWorldMap::xSpace.
+     * \param obstacles Indexed zones.
+     */
+    TimeObstacleIndex(const NonUniformSpace<time_t>& timeSpace,
+                      std::vector<TimeObstacle> obstacles);
+
+    /*! Test a move against the zones active during the move.
+     * A zone activating around a boat block it, waiting in place is a move
+     * with \p from equal to \p to.
+     * \param[in] from Move start position.
+     * \param[in] to Move stop position.
+     * \param[in] t0 Move start time.
+     * \param[in] t1 Move stop time.
+     * \return true if the move cross an active zone edge, or start or stop
+     * inside an active zone
+     */
+    bool blocked(const NVector& from,
+                 const NVector& to,
+                 time_t t0,
+                 time_t t1) const noexcept;
+
+    const NonUniformSpace<time_t>& timeSpace() const noexcept
+    {
+        return m_timeSpace;
+    }
+
+    const std::vector<TimeObstacle>& obstacles() const noexcept
+    {
+        return m_obstacles;
+    }
+
+    /// Number of zones active in \p slice
+    std::size_t nrActive(std::size_t slice) const noexcept
+    {
+        return m_offsets[slice + 1] - m_offsets[slice];
+    }
+
+private:
+    NonUniformSpace<time_t> m_timeSpace;
+    std::vector<TimeObstacle> m_obstacles;
+    /// Slice s zones are in [m_offsets[s], m_offsets[s + 1][
+    std::vector<std::uint32_t> m_offsets;
+    std::vector<std::uint32_t> m_active;
+};
+
+/*! Helper class to build TimeObstacleIndex.
+ */
+class TimeObstacleIndexBuilder
+{
+public:
+    /*!
+     * \param timeSpace \see TimeObstacleIndex.
+     * \param bucketSize Bucket size of each zone EdgeIndex.
+     */
+    TimeObstacleIndexBuilder(const NonUniformSpace<time_t>& timeSpace,
+                             radian_t bucketSize)
+      : m_timeSpace(timeSpace)
+      , m_bucketSize(bucketSize)
+    {}
+
+    /*! Add a closed polygon active in [\p start, \p stop[.
+     * \throw Exception if \p stop is not after \p start.
+     */
+    void addZone(const std::vector<NVector>& polygon,
+                 time_t start,
+                 time_t stop);
+
+    TimeObstacleIndex build() const&
+    {
+        return TimeObstacleIndex(m_timeSpace, m_obstacles);
+    }
+
+    TimeObstacleIndex build() &&
+    {
+        return TimeObstacleIndex(m_timeSpace, std::move(m_obstacles));
+    }
+
+private:
+    NonUniformSpace<time_t> m_timeSpace;
+    radian_t m_bucketSize;
+    std::vector<TimeObstacle> m_obstacles;
+};
+
+}
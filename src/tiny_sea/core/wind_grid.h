@@ -0,0 +1,422 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+// includes
+// std
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// tiny_sea
+#include <tiny_sea/core/linear_grid.h>
+#include <tiny_sea/core/linear_space.h>
+#include <tiny_sea/core/simd_dispatch.h>
+#include <tiny_sea/core/units.h>
+#include <tiny_sea/core/wind_vector.h>
+#include <tiny_sea/core/world_map_grid.h>
+
+// Eigen
+#include <Eigen/Core>
+
+namespace tiny_sea {
+
+/*! Wind grid storing the wind as WindVector components.
+ * Components are stored as float in two planes (SoA), one for u (west to
+ * east) and one for v (south to north). Planes use the LinearGrid layout,
+ * last column and row are duplicated.
+ *
+ * An optional current is stored in two more planes with the same layout.
+ * Wind and current of a cell are interpolated by the same kernel.
+ *
+ * Planes are either owned by the grid or a view on an external storage (like
+ * a memory mapped file) kept alive by a shared owner.
+ *
+ * Components are linearly interpolated and converted into bearing and
+ * velocity at the end. Unlike WorldMapDataInterpolator, this don't need
+ * angle normalization and opposite winds interpolate toward a calm.
+ */
+class WindGrid
+{
+public:
+    using x_space_type = LinearSpace<latitude_t>;
+    using y_space_type = LinearSpace<longitude_t>;
+    using plane_type = std::vector<float>;
+
+    /// Number of points computed at once by the batch kernel
+    static constexpr std::size_t BATCH_SIZE = 64;
+
+public:
+    /*! Create a WindGrid from two LinearSpace and u/v planes.
+     * \warning \p u and \p v must have the \p (xSpace size + 1)*(ySpace size +
+     * 1) size. The last column and row should be duplicated.
+     */
+    WindGrid(const x_space_type& xSpace,
+             const y_space_type& ySpace,
+             const plane_type& u,
+             const plane_type& v)
+      : WindGrid(xSpace,
+                 ySpace,
+                 std::make_shared<planes_type>(planes_type{ u, v }))
+    {
+        assert(u.size() == planeSize());
+        assert(v.size() == planeSize());
+    }
+
+    /*! Create a WindGrid from wind and current u/v planes.
+     * \warning All planes must have the planeSize() size.
+     */
+    WindGrid(const x_space_type& xSpace,
+             const y_space_type& ySpace,
+             const plane_type& u,
+             const plane_type& v,
+             const plane_type& currentU,
+             const plane_type& currentV)
+      : WindGrid(xSpace,
+                 ySpace,
+                 std::make_shared<planes_type>(
+                   planes_type{ u, v, currentU, currentV }))
+    {
+        assert(u.size() == planeSize());
+        assert(v.size() == planeSize());
+        assert(currentU.size() == planeSize());
+        assert(currentV.size() == planeSize());
+    }
+
+    /*! Create a WindGrid view on external u/v planes.
+     * \param owner Keep \p u and \p v alive.
+     * \param currentU Current u plane, nullptr if there is no current.
+     * \param currentV Current v plane, nullptr if there is no current.
+     * \warning \p u and \p v must have the planeSize() size.
+     */
+    WindGrid(const x_space_type& xSpace,
+             const y_space_type& ySpace,
+             std::shared_ptr<const void> owner,
+             const float* u,
+             const float* v,
+             const float* currentU = nullptr,
+             const float* currentV = nullptr)
+      : m_xSpace(xSpace)
+      , m_ySpace(ySpace)
+      , m_owner(std::move(owner))
+      , m_planes{ u, v, currentU, currentV }
+      , m_nrPlanes(currentU && currentV ? 4 : 2)
+    {}
+
+    /// Convert a WorldMapGrid, current planes are only kept if not null
+    explicit WindGrid(const WorldMapGrid& grid)
+      : WindGrid(grid.xSpace(), grid.ySpace(), toPlanes(grid))
+    {}
+
+    /*! Getter from index.
+     * \warning \p x must be a valid index.
+     * \warning \p y must be a valid index.
+     */
+    WorldMapData operator()(std::size_t x, std::size_t y) const
+    {
+        assert(x < m_xSpace.nrPoints());
+        assert(y < m_ySpace.nrPoints());
+        std::size_t idx = internal::index2D(m_xSpace, m_ySpace, x, y);
+        return toWorldMapData(
+          value(0, idx), value(1, idx), value(2, idx), value(3, idx));
+    }
+
+    /*!
+     * \param[in] x Clamped between [start(), stop()].
+     * \param[in] y Clamped between [start(), stop()].
+     * \return Interpolated wind vector
+     */
+    WindVector safeInterpolatedVector(latitude_t x, longitude_t y) const
+      noexcept
+    {
+        // Interpolate u and v with the same weights
+        auto res = bilinear<2>(x, y);
+        return WindVector(velocity_t(res(0)), velocity_t(res(1)));
+    }
+
+    /*! Trilinear interpolation between two grids sharing the same spaces.
+     * Spatial weights and corner indexes are computed once for both grids.
+     * \param[in] next Grid blended with this one.
+     * \param[in] t Weight of \p next, 0 return this grid value.
+     * \param[in] x Clamped between [start(), stop()].
+     * \param[in] y Clamped between [start(), stop()].
+     * \warning \p next spaces must be equal to this grid spaces.
+     * \return Interpolated wind vector
+     */
+    WindVector safeInterpolatedVector(const WindGrid& next,
+                                      scale_t t,
+                                      latitude_t x,
+                                      longitude_t y) const noexcept
+    {
+        auto res = trilinear<2>(next, t, x, y);
+        return WindVector(velocity_t(res(0)), velocity_t(res(1)));
+    }
+
+    /*! Trilinear interpolation of wind and current, \see
+     * safeInterpolatedVector.
+     * A grid without current has a null current.
+     */
+    WorldMapData safeInterpolated(const WindGrid& next,
+                                  scale_t t,
+                                  latitude_t x,
+                                  longitude_t y) const noexcept
+    {
+        if (hasCurrent() || next.hasCurrent()) {
+            auto res = trilinear<4>(next, t, x, y);
+            return toWorldMapData(res(0), res(1), res(2), res(3));
+        }
+        auto res = trilinear<2>(next, t, x, y);
+        return toWorldMapData(res(0), res(1), 0.f, 0.f);
+    }
+
+    /*!
+     * \param[in] x Clamped between [start(), stop()].
+     * \param[in] y Clamped between [start(), stop()].
+     * \return Interpolated value
+     */
+    WorldMapData safeInterpolated(latitude_t x, longitude_t y) const noexcept
+    {
+        if (hasCurrent()) {
+            auto res = bilinear<4>(x, y);
+            return toWorldMapData(res(0), res(1), res(2), res(3));
+        }
+        auto res = bilinear<2>(x, y);
+        return toWorldMapData(res(0), res(1), 0.f, 0.f);
+    }
+
+    /*! Batch version of \see safeInterpolated.
+     * Points are processed by block of BATCH_SIZE. Corner indexes and
+     * weights of a block are computed first, then each plane is
+     * interpolated by the runtime dispatched simd::Kernels::bilinear.
+     * \param[in] x Array of \p size latitudes.
+     * \param[in] y Array of \p size longitudes.
+     * \param[in] size Number of points.
+     * \param[out] res Array of \p size interpolated values.
+     */
+    void safeInterpolated(const latitude_t* x,
+                          const longitude_t* y,
+                          std::size_t size,
+                          WorldMapData* res) const
+    {
+        const auto& kernels = simd::kernels();
+        std::array<std::size_t, BATCH_SIZE> idx00;
+        std::array<float, BATCH_SIZE> pX, pY;
+        std::array<std::array<float, BATCH_SIZE>, 4> planes;
+        planes[2].fill(0.f);
+        planes[3].fill(0.f);
+        std::size_t rowSize = m_xSpace.nrPoints() + 1;
+
+        for (std::size_t start = 0; start < size; start += BATCH_SIZE) {
+            std::size_t n = std::min(BATCH_SIZE, size - start);
+
+            for (std::size_t i = 0; i < n; ++i) {
+                auto resX = m_xSpace.safeInterpolationWeight(x[start + i]);
+                auto resY = m_ySpace.safeInterpolationWeight(y[start + i]);
+                idx00[i] = internal::index2D(
+                  m_xSpace, m_ySpace, resX.index, resY.index);
+                pX[i] = float(resX.percent.t);
+                pY[i] = float(resY.percent.t);
+            }
+
+            // Bilinear interpolation of all points of the block
+            for (std::size_t p = 0; p < m_nrPlanes; ++p) {
+                kernels.bilinear(m_planes[p],
+                                 rowSize,
+                                 idx00.data(),
+                                 pX.data(),
+                                 pY.data(),
+                                 n,
+                                 planes[p].data());
+            }
+
+            for (std::size_t i = 0; i < n; ++i) {
+                float u = planes[0][i];
+                float v = planes[1][i];
+                res[start + i] = WorldMapData(
+                  radian_t(std::atan2(-double(u), -double(v))),
+                  velocity_t(std::sqrt(u * u + v * v)),
+                  WindVector(velocity_t(planes[2][i]),
+                             velocity_t(planes[3][i])));
+            }
+        }
+    }
+
+    /// X linear space getter
+    const x_space_type& xSpace() const noexcept { return m_xSpace; }
+
+    /// Y linear space getter
+    const y_space_type& ySpace() const noexcept { return m_ySpace; }
+
+    /// West to east component plane of planeSize() values
+    const float* u() const noexcept { return m_planes[0]; }
+
+    /// South to north component plane of planeSize() values
+    const float* v() const noexcept { return m_planes[1]; }
+
+    /// Current west to east plane, nullptr if there is no current
+    const float* currentU() const noexcept
+    {
+        return hasCurrent() ? m_planes[2] : nullptr;
+    }
+
+    /// Current south to north plane, nullptr if there is no current
+    const float* currentV() const noexcept
+    {
+        return hasCurrent() ? m_planes[3] : nullptr;
+    }
+
+    /// \return true if current planes are stored
+    bool hasCurrent() const noexcept { return m_nrPlanes == 4; }
+
+    /// \return Number of values by plane, duplicated last row and column
+    std::size_t planeSize() const noexcept
+    {
+        return (m_xSpace.nrPoints() + 1) * (m_ySpace.nrPoints() + 1);
+    }
+
+private:
+    using planes_type = std::vector<plane_type>;
+
+    WindGrid(const x_space_type& xSpace,
+             const y_space_type& ySpace,
+             std::shared_ptr<planes_type> planes)
+      : WindGrid(xSpace,
+                 ySpace,
+                 planes,
+                 (*planes)[0].data(),
+                 (*planes)[1].data(),
+                 planes->size() == 4 ? (*planes)[2].data() : nullptr,
+                 planes->size() == 4 ? (*planes)[3].data() : nullptr)
+    {}
+
+    /// \return Plane \p p value at \p idx, 0 for a missing plane
+    float value(std::size_t p, std::size_t idx) const noexcept
+    {
+        return p < m_nrPlanes ? m_planes[p][idx] : 0.f;
+    }
+
+    /// Interpolate the N first planes with the same weights
+    template<int N>
+    Eigen::Array<float, N, 1> bilinear(latitude_t x, longitude_t y) const
+      noexcept
+    {
+        assert(std::size_t(N) <= m_nrPlanes);
+        auto resX = m_xSpace.safeInterpolationWeight(x);
+        auto resY = m_ySpace.safeInterpolationWeight(y);
+
+        std::size_t idx00 =
+          internal::index2D(m_xSpace, m_ySpace, resX.index, resY.index);
+        std::size_t idx01 = idx00 + m_xSpace.nrPoints() + 1;
+
+        Eigen::Array<float, N, 1> c00, c10, c01, c11;
+        for (int p = 0; p < N; ++p) {
+            c00(p) = m_planes[p][idx00];
+            c10(p) = m_planes[p][idx00 + 1];
+            c01(p) = m_planes[p][idx01];
+            c11(p) = m_planes[p][idx01 + 1];
+        }
+        float pX = float(resX.percent.t);
+        float pY = float(resY.percent.t);
+        Eigen::Array<float, N, 1> y0 = c00 + (c10 - c00) * pX;
+        Eigen::Array<float, N, 1> y1 = c01 + (c11 - c01) * pX;
+        return y0 + (y1 - y0) * pY;
+    }
+
+    /// Interpolate the N first planes of this grid and \p next
+    template<int N>
+    Eigen::Array<float, N, 1> trilinear(const WindGrid& next,
+                                        scale_t t,
+                                        latitude_t x,
+                                        longitude_t y) const noexcept
+    {
+        assert(m_xSpace == next.m_xSpace);
+        assert(m_ySpace == next.m_ySpace);
+        auto resX = m_xSpace.safeInterpolationWeight(x);
+        auto resY = m_ySpace.safeInterpolationWeight(y);
+
+        std::size_t idx00 =
+          internal::index2D(m_xSpace, m_ySpace, resX.index, resY.index);
+        std::size_t idx01 = idx00 + m_xSpace.nrPoints() + 1;
+
+        // Blend both slices corners, then interpolate like bilinear
+        float pT = float(t.t);
+        auto corner = [&](std::size_t idx) {
+            Eigen::Array<float, N, 1> c0, c1;
+            for (int p = 0; p < N; ++p) {
+                c0(p) = value(p, idx);
+                c1(p) = next.value(p, idx);
+            }
+            return Eigen::Array<float, N, 1>(c0 + (c1 - c0) * pT);
+        };
+        Eigen::Array<float, N, 1> c00 = corner(idx00);
+        Eigen::Array<float, N, 1> c10 = corner(idx00 + 1);
+        Eigen::Array<float, N, 1> c01 = corner(idx01);
+        Eigen::Array<float, N, 1> c11 = corner(idx01 + 1);
+        float pX = float(resX.percent.t);
+        float pY = float(resY.percent.t);
+        Eigen::Array<float, N, 1> y0 = c00 + (c10 - c00) * pX;
+        Eigen::Array<float, N, 1> y1 = c01 + (c11 - c01) * pX;
+        return y0 + (y1 - y0) * pY;
+    }
+
+    static std::shared_ptr<planes_type> toPlanes(const WorldMapGrid& grid)
+    {
+        const auto& values = grid.values();
+        bool current = std::any_of(
+          values.begin(), values.end(), [](const WorldMapData& data) {
+              return data.hasCurrent();
+          });
+        auto planes = std::make_shared<planes_type>(
+          current ? 4 : 2, plane_type(values.size()));
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            auto wind = WindVector::fromBearing(values[i].windBearing,
+                                                values[i].windVelocity);
+            (*planes)[0][i] = float(wind.m_x.t);
+            (*planes)[1][i] = float(wind.m_y.t);
+            if (current) {
+                (*planes)[2][i] = float(values[i].current.m_x.t);
+                (*planes)[3][i] = float(values[i].current.m_y.t);
+            }
+        }
+        return planes;
+    }
+
+    static WorldMapData toWorldMapData(float u,
+                                       float v,
+                                       float currentU,
+                                       float currentV) noexcept
+    {
+        WindVector wind{ velocity_t(u), velocity_t(v) };
+        return WorldMapData(
+          wind.bearing(),
+          wind.velocity(),
+          WindVector(velocity_t(currentU), velocity_t(currentV)));
+    }
+
+private:
+    x_space_type m_xSpace;
+    y_space_type m_ySpace;
+    std::shared_ptr<const void> m_owner;
+    /// u, v, current u and current v planes
+    std::array<const float*, 4> m_planes;
+    std::size_t m_nrPlanes;
+};
+}
@@ -17,6 +17,9 @@
 #pragma once
 
 // includes
+// std
+#include <cmath>
+
 // tiny_sea
 #include <tiny_sea/core/units.h>
 
@@ -25,6 +28,9 @@ namespace tiny_sea {
 /*! Wind velocity in longitude, latitude coordinate
  * X is west to east
  * Y is South to north
+ *
+ * The vector point where the wind blow to (u/v meteorological convention)
+ * while a wind bearing is where the wind come from.
  */
 struct WindVector
 {
@@ -34,6 +40,28 @@ struct WindVector
       , m_y(y)
     {}
 
+    /*! Create a WindVector from a wind bearing and a wind velocity.
+     * \param bearing Wind angle from north clockwise.
+     */
+    static WindVector fromBearing(radian_t bearing,
+                                  velocity_t velocity) noexcept
+    {
+        return WindVector(velocity_t(-velocity.t * std::sin(bearing.t)),
+                          velocity_t(-velocity.t * std::cos(bearing.t)));
+    }
+
+    /// \return Wind angle from north clockwise in [-PI, PI]
+    radian_t bearing() const noexcept
+    {
+        return radian_t(std::atan2(-m_x.t, -m_y.t));
+    }
+
+    /// \return Wind velocity
+    velocity_t velocity() const noexcept
+    {
+        return velocity_t(std::hypot(m_x.t, m_y.t));
+    }
+
     // TODO eigen conversion
 
     velocity_t m_x, m_y;
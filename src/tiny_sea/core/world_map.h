@@ -17,117 +17,281 @@
 #pragma once
 
 // includes
+// std
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
 // tiny_sea
 #include <tiny_sea/core/exception.h>
-#include <tiny_sea/core/linear_grid.h>
+#include <tiny_sea/core/interpolator.h>
 #include <tiny_sea/core/linear_list.h>
+#include <tiny_sea/core/non_uniform_space.h>
 #include <tiny_sea/core/numeric_constants.h>
+#include <tiny_sea/core/paged_wind_grid.h>
+#include <tiny_sea/core/quantized_wind_grid.h>
 #include <tiny_sea/core/units.h>
+#include <tiny_sea/core/wind_grid.h>
+#include <tiny_sea/core/wind_vector.h>
+#include <tiny_sea/core/world_map_grid.h>
 
 namespace tiny_sea {
 
-/*! Data stored at each world map cell.
+/*! World map data type.
+ * Hold either a WorldMapGrid, a WindGrid, a QuantizedWindGrid or a
+ * PagedWindGrid.
+ *
+ * The grid is immutable and shared between copies, copying a WorldMap don't
+ * copy the grid.
  */
-struct WorldMapData
+class WorldMap
 {
-    WorldMapData() = default;
-    WorldMapData(radian_t p_windBearing, velocity_t p_windVelocity)
-      : windBearing(p_windBearing)
-      , windVelocity(p_windVelocity)
+public:
+    using grid_type =
+      std::variant<WorldMapGrid, WindGrid, QuantizedWindGrid, PagedWindGrid>;
+
+public:
+    /// Copy or move \p grid in a new shared grid
+    template<typename Grid,
+             typename = std::enable_if_t<
+               std::is_constructible<grid_type, Grid&&>::value>>
+    WorldMap(Grid&& grid)
+      : m_grid(std::make_shared<const grid_type>(std::forward<Grid>(grid)))
     {}
 
-    radian_t windBearing;    // Wind angle from north clockwise
-    velocity_t windVelocity; // Wind velocity
-};
+    /*! WorldMapGrid getter.
+     * \throw std::bad_variant_access if the world map don't hold a
+     * WorldMapGrid.
+     */
+    const WorldMapGrid& worldGrid() const
+    {
+        return std::get<WorldMapGrid>(*m_grid);
+    }
 
-struct WorldMapDataInterpolator
-{
-    WorldMapData operator()(const WorldMapData& t0,
-                            const WorldMapData& t1,
-                            scale_t percent) const
+    /// Grid getter
+    const grid_type& grid() const noexcept { return *m_grid; }
+
+    /// Latitude space of the grid
+    const LinearSpace<latitude_t>& latSpace() const noexcept
     {
-        UnitsInterpolator<velocity_t> vel_interpolator;
+        return std::visit(
+          [](const auto& g) -> const LinearSpace<latitude_t>& {
+              return g.xSpace();
+          },
+          *m_grid);
+    }
 
-        // Returned wind bearing is not normalized between [0, 2PI]
-        return WorldMapData(
-          t0.windBearing +
-            minDistance(t0.windBearing, t1.windBearing) * percent,
-          vel_interpolator(t0.windVelocity, t1.windVelocity, percent));
+    /// Longitude space of the grid
+    const LinearSpace<longitude_t>& lonSpace() const noexcept
+    {
+        return std::visit(
+          [](const auto& g) -> const LinearSpace<longitude_t>& {
+              return g.ySpace();
+          },
+          *m_grid);
     }
-};
 
-/// World map grid
-using WorldMapGrid =
-  LinearGrid<latitude_t, longitude_t, WorldMapData, WorldMapDataInterpolator>;
+    /*! Getter from index.
+     * \warning \p lat must be a valid index.
+     * \warning \p lon must be a valid index.
+     */
+    WorldMapData operator()(std::size_t lat, std::size_t lon) const
+    {
+        return std::visit([&](const auto& g) { return g(lat, lon); },
+                          *m_grid);
+    }
 
-/// World map grid builder
-using WorldMapGridBuilder = LinearGridBuilder<latitude_t,
-                                              longitude_t,
-                                              WorldMapData,
-                                              WorldMapDataInterpolator>;
+    /*!
+     * \param[in] lat Clamped between [start(), stop()].
+     * \param[in] lon Clamped between [start(), stop()].
+     * \return Interpolated value
+     */
+    WorldMapData safeInterpolated(latitude_t lat, longitude_t lon) const
+    {
+        return std::visit(
+          [&](const auto& g) { return g.safeInterpolated(lat, lon); },
+          *m_grid);
+    }
 
-/// World map data type
-class WorldMap
-{
-public:
-    WorldMap(const WorldMapGrid& grid)
-      : m_worldGrid(grid)
-    {}
+    /*!
+     * \param[in] lat Clamped between [start(), stop()].
+     * \param[in] lon Clamped between [start(), stop()].
+     * \return Interpolated wind vector
+     */
+    WindVector safeInterpolatedVector(latitude_t lat, longitude_t lon) const
+    {
+        return std::visit(
+          [&](const auto& g) {
+              using G = std::decay_t<decltype(g)>;
+              if constexpr (std::is_same<G, WorldMapGrid>::value) {
+                  auto res = g.safeInterpolated(lat, lon);
+                  return WindVector::fromBearing(res.windBearing,
+                                                 res.windVelocity);
+              } else {
+                  return g.safeInterpolatedVector(lat, lon);
+              }
+          },
+          *m_grid);
+    }
 
-    const WorldMapGrid& worldGrid() const { return m_worldGrid; }
+    /*! Strongest current of the grid nodes.
+     * Interpolated currents are bounded by it.
+     */
+    velocity_t maxCurrentVelocity() const
+    {
+        // Paged forecasts don't store current
+        if (std::holds_alternative<PagedWindGrid>(*m_grid)) {
+            return velocity_t(0.);
+        }
+        velocity_t res(0.);
+        for (std::size_t lon = 0; lon < lonSpace().nrPoints(); ++lon) {
+            for (std::size_t lat = 0; lat < latSpace().nrPoints(); ++lat) {
+                res = std::max(res, (*this)(lat, lon).current.velocity());
+            }
+        }
+        return res;
+    }
 
 private:
-    WorldMapGrid m_worldGrid;
+    std::shared_ptr<const grid_type> m_grid;
 };
 
-/// World map by time
+/*! World map by time.
+ * Slices can be spaced non uniformly, like forecasts with hourly steps
+ * followed by 3-hourly steps. A LinearSpace is converted implicitly.
+ */
 class TimeWorldMap
-  : public LinearList<time_t, WorldMap, NullInterpolator<WorldMap>>
+  : public LinearList<time_t,
+                      WorldMap,
+                      NullInterpolator<WorldMap>,
+                      NonUniformSpace<time_t>>
 {
 public:
-    using parent_type =
-      LinearList<time_t, WorldMap, NullInterpolator<WorldMap>>;
+    using parent_type = LinearList<time_t,
+                                   WorldMap,
+                                   NullInterpolator<WorldMap>,
+                                   NonUniformSpace<time_t>>;
 
 public:
     // Using all parent constructors
     using parent_type::parent_type;
+
+    /*! Space-time interpolation.
+     * Wind vectors and currents of the two slices around \p time are
+     * bilinearly interpolated at (\p lat, \p lon) and linearly blended in
+     * time. When both slices are WindGrid on the same spaces, corners of
+     * both slices are blended in one trilinear kernel.
+     * \param[in] time Clamped between [start(), stop()].
+     * \param[in] lat Clamped between [start(), stop()].
+     * \param[in] lon Clamped between [start(), stop()].
+     * \return Interpolated value
+     */
+    WorldMapData safeInterpolated(time_t time,
+                                  latitude_t lat,
+                                  longitude_t lon) const
+    {
+        auto res = xSpace().safeInterpolationWeight(time);
+        const auto& w0 = values()[res.index];
+        const auto& w1 = values()[res.index + 1];
+
+        const auto* g0 = std::get_if<WindGrid>(&w0.grid());
+        const auto* g1 = std::get_if<WindGrid>(&w1.grid());
+        if (&w0.grid() == &w1.grid() || res.percent.t == 0.) {
+            // Same grid (like the duplicated last slice) or on a slice
+            auto data = w0.safeInterpolated(lat, lon);
+            if (std::holds_alternative<WorldMapGrid>(w0.grid())) {
+                data = normalized(data);
+            }
+            return data;
+        } else if (g0 && g1 && g0->xSpace() == g1->xSpace() &&
+                   g0->ySpace() == g1->ySpace()) {
+            return g0->safeInterpolated(*g1, res.percent, lat, lon);
+        }
+
+        auto d0 = w0.safeInterpolated(lat, lon);
+        auto d1 = w1.safeInterpolated(lat, lon);
+        auto v0 = WindVector::fromBearing(d0.windBearing, d0.windVelocity);
+        auto v1 = WindVector::fromBearing(d1.windBearing, d1.windVelocity);
+        UnitsInterpolator<velocity_t> interpolator;
+        WindVector wind(interpolator(v0.m_x, v1.m_x, res.percent),
+                        interpolator(v0.m_y, v1.m_y, res.percent));
+        WindVector current(
+          interpolator(d0.current.m_x, d1.current.m_x, res.percent),
+          interpolator(d0.current.m_y, d1.current.m_y, res.percent));
+        return WorldMapData(wind.bearing(), wind.velocity(), current);
+    }
+
+    /*! Strongest current of all the slices.
+     * Add it to the boat maximum velocity to bound the speed over ground,
+     * \see StateFactory.
+     */
+    velocity_t maxCurrentVelocity() const
+    {
+        velocity_t res(0.);
+        const WorldMap::grid_type* previous = nullptr;
+        for (const auto& worldMap : values()) {
+            // Last slice share the grid of the previous one
+            if (&worldMap.grid() != previous) {
+                res = std::max(res, worldMap.maxCurrentVelocity());
+            }
+            previous = &worldMap.grid();
+        }
+        return res;
+    }
+
+private:
+    /// WorldMapGrid wind bearing in the WindVector::bearing range
+    static WorldMapData normalized(const WorldMapData& data)
+    {
+        auto wind =
+          WindVector::fromBearing(data.windBearing, data.windVelocity);
+        return WorldMapData(wind.bearing(), wind.velocity(), data.current);
+    }
 };
 
 /// World map by time builder
 class TimeWorldMapBuilder
 {
 public:
-    TimeWorldMapBuilder(const LinearSpace<time_t>& xSpace)
+    TimeWorldMapBuilder(const NonUniformSpace<time_t>& xSpace)
       : m_xSpace(xSpace)
     {}
 
     /// Add new world map to next time
-    void add(const WorldMap& worldMap)
+    void add(WorldMap worldMap)
     {
         if (m_worldMaps.size() >= m_xSpace.nrPoints()) {
             throw Exception("Impossible to add one more WorldMap");
         }
-        m_worldMaps.emplace_back(worldMap);
+        m_worldMaps.emplace_back(std::move(worldMap));
+    }
+
+    /// Build a TimeWorldMap sharing the grids of the builder
+    TimeWorldMap build() const&
+    {
+        return TimeWorldMapBuilder(*this).build();
     }
 
-    TimeWorldMap build() const
+    /// Build a TimeWorldMap by moving the world maps out of the builder
+    TimeWorldMap build() &&
     {
         if (m_worldMaps.size() == m_xSpace.nrPoints()) {
-            // The last value of m_values is considered mutable.
-            // Since is not possible to do that in C++ we use const_cast.
-            const_cast<std::vector<WorldMap>&>(m_worldMaps)
-              .emplace_back(m_worldMaps.back());
+            // The last slice share the grid of the previous one
+            m_worldMaps.emplace_back(m_worldMaps.back());
         }
 
         if (m_worldMaps.size() != (m_xSpace.nrPoints() + 1)) {
             throw Exception("No enough WorldMap");
         }
 
-        return TimeWorldMap(m_xSpace, m_worldMaps);
+        return TimeWorldMap(m_xSpace, std::move(m_worldMaps));
     }
 
 private:
-    LinearSpace<time_t> m_xSpace;
+    NonUniformSpace<time_t> m_xSpace;
     std::vector<WorldMap> m_worldMaps;
 };
 
@@ -0,0 +1,86 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+// includes
+// tiny_sea
+#include <tiny_sea/core/interpolator.h>
+#include <tiny_sea/core/linear_grid.h>
+#include <tiny_sea/core/units.h>
+#include <tiny_sea/core/wind_vector.h>
+
+namespace tiny_sea {
+
+/*! Data stored at each world map cell.
+ */
+struct WorldMapData
+{
+    WorldMapData() = default;
+    WorldMapData(radian_t p_windBearing, velocity_t p_windVelocity)
+      : windBearing(p_windBearing)
+      , windVelocity(p_windVelocity)
+    {}
+    WorldMapData(radian_t p_windBearing,
+                 velocity_t p_windVelocity,
+                 const WindVector& p_current)
+      : windBearing(p_windBearing)
+      , windVelocity(p_windVelocity)
+      , current(p_current)
+    {}
+
+    /// \return true if the current is not null
+    bool hasCurrent() const noexcept
+    {
+        return current.m_x.t != 0. || current.m_y.t != 0.;
+    }
+
+    radian_t windBearing;    // Wind angle from north clockwise
+    velocity_t windVelocity; // Wind velocity
+    // Ocean or tidal current, u/v where the water flow to like WindVector
+    WindVector current{ velocity_t(0.), velocity_t(0.) };
+};
+
+struct WorldMapDataInterpolator
+{
+    WorldMapData operator()(const WorldMapData& t0,
+                            const WorldMapData& t1,
+                            scale_t percent) const
+    {
+        UnitsInterpolator<velocity_t> vel_interpolator;
+
+        // Returned wind bearing is not normalized between [0, 2PI]
+        return WorldMapData(
+          t0.windBearing +
+            minDistance(t0.windBearing, t1.windBearing) * percent,
+          vel_interpolator(t0.windVelocity, t1.windVelocity, percent),
+          WindVector(
+            vel_interpolator(t0.current.m_x, t1.current.m_x, percent),
+            vel_interpolator(t0.current.m_y, t1.current.m_y, percent)));
+    }
+};
+
+/// World map grid
+using WorldMapGrid =
+  LinearGrid<latitude_t, longitude_t, WorldMapData, WorldMapDataInterpolator>;
+
+/// World map grid builder
+using WorldMapGridBuilder = LinearGridBuilder<latitude_t,
+                                              longitude_t,
+                                              WorldMapData,
+                                              WorldMapDataInterpolator>;
+
+}
@@ -19,21 +19,41 @@
 namespace tiny_sea {
 
 struct BoatVelocity;
+class BoatVelocityRaster;
 class BoatVelocityTable;
 class BoatVelocityTableBuilder;
+class CompiledBoatVelocityTable;
+class EdgeIndex;
+class ForecastWriter;
+class LandMask;
 class NVector;
+class PagedForecast;
+class PagedWindGrid;
+class QuantizedWindGrid;
+class TidalCurrentGrid;
+class TimeObstacleIndex;
 class TimeWorldMap;
 class TimeWorldMapBuilder;
+class WindGrid;
 struct WorldMap;
 struct WorldMapData;
 
 namespace gsp {
 
 class CloseList;
+class Corridor;
+class CorridorPlanner;
+class DominanceTable;
+class Heuristic;
+class HeuristicField;
+class LandmarkHeuristic;
+class Landmarks;
 class NeighborsFinder;
 class OpenList;
 class State;
 class StateFactory;
+class VelocityLattice;
+class WorldMapSampleCache;
 
 }
 
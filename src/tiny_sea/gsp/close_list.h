@@ -18,8 +18,10 @@
 
 // includes
 // std
+#include <algorithm>
 #include <type_traits>
 #include <unordered_map>
+#include <vector>
 
 // tiny_sea
 #include <tiny_sea/gsp/state.h>
@@ -110,6 +112,19 @@ public:
 
     const State& at(const DiscretState& ds) const { return m_store.at(ds); }
 
+    /*! States from the start to \p state following the parent states.
+     * \throw std::out_of_range if a parent state is not in the list.
+     */
+    std::vector<State> route(const State& state) const
+    {
+        std::vector<State> res({ state });
+        while (res.back().parentState()) {
+            res.push_back(at(*res.back().parentState()));
+        }
+        std::reverse(res.begin(), res.end());
+        return res;
+    }
+
     std::size_t size() const { return m_store.size(); }
 
     const container_t store() const { return m_store; }
@@ -0,0 +1,192 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// associated header
+#include <tiny_sea/gsp/corridor.h>
+
+// includes
+// std
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+// tiny_sea
+#include <tiny_sea/core/exception.h>
+
+namespace tiny_sea {
+
+namespace gsp {
+
+namespace {
+
+/// Distance from \p pos to the great circle segment [\p a, \p b]
+meter_t
+segmentDistance(const NVector& pos, const NVector& a, const NVector& b)
+{
+    Eigen::Vector3d p = pos.toEigen();
+    Eigen::Vector3d normal = a.toEigen().cross(b.toEigen());
+    double norm = normal.norm();
+    if (norm > 1e-12) {
+        normal /= norm;
+        // Projection on the segment great circle, inside the segment if it's
+        // on the same side of both end points
+        Eigen::Vector3d c = p - p.dot(normal) * normal;
+        if (a.toEigen().cross(c).dot(normal) >= 0. &&
+            c.cross(b.toEigen()).dot(normal) >= 0.) {
+            return meter_t(EARTH_RADIUS *
+                           std::asin(std::min(std::abs(p.dot(normal)), 1.)));
+        }
+    }
+    return std::min(pos.distance(a), pos.distance(b));
+}
+
+/// Inclusive pixel range of \p space covering [\p min, \p max]
+template<typename Space>
+std::pair<std::size_t, std::size_t>
+pixelRange(const Space& space, double min, double max) noexcept
+{
+    double last = double(space.nrPoints() - 1);
+    double first = std::floor((min - space.start().t) / space.delta().t + 0.5);
+    double end = std::floor((max - space.start().t) / space.delta().t + 0.5);
+    return std::make_pair(std::size_t(std::clamp(first, 0., last)),
+                          std::size_t(std::clamp(end, 0., last)));
+}
+
+}
+
+Corridor::Corridor(const std::vector<NVector>& route,
+                   meter_t width,
+                   meter_t resolution)
+  : m_latSpace(latitude_t(0.), latitude_t(1.), 2)
+  , m_lonSpace(longitude_t(0.), longitude_t(1.), 2)
+{
+    if (route.empty()) {
+        throw Exception("Corridor route is empty");
+    }
+    if (width <= meter_t(0.) || resolution <= meter_t(0.)) {
+        throw Exception("Corridor width and resolution must be positive");
+    }
+
+    // Route bounding box, segment middles bound the great circles bulge
+    double minLat = std::numeric_limits<double>::max();
+    double maxLat = std::numeric_limits<double>::lowest();
+    double minLon = minLat;
+    double maxLon = maxLat;
+    auto extend = [&](const NVector& pos) {
+        auto latLon = pos.toLatLon();
+        minLat = std::min(minLat, latLon.first.t);
+        maxLat = std::max(maxLat, latLon.first.t);
+        minLon = std::min(minLon, latLon.second.t);
+        maxLon = std::max(maxLon, latLon.second.t);
+    };
+    for (std::size_t i = 0; i < route.size(); ++i) {
+        extend(route[i]);
+        if (i > 0) {
+            extend(NVector(
+              (route[i - 1].toEigen() + route[i].toEigen()).normalized()));
+        }
+    }
+
+    // Pixels are at most resolution wide, pixel longitudes are narrower
+    // than latitudes toward the poles
+    double margin = (width + resolution).t / EARTH_RADIUS;
+    double maxCos = std::cos(std::min(
+      std::max(std::abs(minLat), std::abs(maxLat)) + margin, PI / 2. - 1e-6));
+    double latDelta = resolution.t / EARTH_RADIUS;
+    double lonDelta = latDelta / maxCos;
+    double lonMargin = margin / maxCos;
+    minLat -= margin;
+    maxLat += margin;
+    minLon -= lonMargin;
+    maxLon += lonMargin;
+
+    m_latSpace = makeLinearSpace(
+      latitude_t(minLat),
+      latitude_t(latDelta),
+      std::size_t(std::ceil((maxLat - minLat) / latDelta)) + 1);
+    m_lonSpace = makeLinearSpace(
+      longitude_t(minLon),
+      longitude_t(lonDelta),
+      std::size_t(std::ceil((maxLon - minLon) / lonDelta)) + 1);
+
+    std::size_t nx = m_latSpace.nrPoints();
+    std::size_t ny = m_lonSpace.nrPoints();
+    m_bits.assign((nx * ny + 63) / 64, 0);
+
+    meter_t radius = width + resolution * scale_t(std::sqrt(0.5));
+    // A single position route is a null segment
+    std::size_t nrSegments = std::max(route.size() - 1, std::size_t(1));
+    for (std::size_t i = 0; i < nrSegments; ++i) {
+        const NVector& a = route[i];
+        const NVector& b = route[std::min(i + 1, route.size() - 1)];
+
+        // Segment bounding box extended by the margin
+        minLat = minLon = std::numeric_limits<double>::max();
+        maxLat = maxLon = std::numeric_limits<double>::lowest();
+        extend(a);
+        extend(b);
+        extend(NVector((a.toEigen() + b.toEigen()).normalized()));
+        auto xRange =
+          pixelRange(m_latSpace, minLat - margin, maxLat + margin);
+        auto yRange =
+          pixelRange(m_lonSpace, minLon - lonMargin, maxLon + lonMargin);
+
+        for (std::size_t y = yRange.first; y <= yRange.second; ++y) {
+            for (std::size_t x = xRange.first; x <= xRange.second; ++x) {
+                std::size_t bit = x + y * nx;
+                if ((m_bits[bit / 64] >> (bit % 64)) & 1u) {
+                    continue;
+                }
+                auto center = NVector::fromLatLon(m_latSpace.value(x),
+                                                  m_lonSpace.value(y));
+                if (segmentDistance(center, a, b) <= radius) {
+                    m_bits[bit / 64] |= std::uint64_t(1) << (bit % 64);
+                }
+            }
+        }
+    }
+}
+
+bool
+Corridor::inside(const NVector& pos) const noexcept
+{
+    auto latLon = pos.toLatLon();
+    double x =
+      ((latLon.first - m_latSpace.start()) / m_latSpace.delta()).t + 0.5;
+    double y =
+      ((latLon.second - m_lonSpace.start()) / m_lonSpace.delta()).t + 0.5;
+    if (x < 0. || x >= double(m_latSpace.nrPoints()) || y < 0. ||
+        y >= double(m_lonSpace.nrPoints())) {
+        return false;
+    }
+    return (*this)(std::size_t(x), std::size_t(y));
+}
+
+std::size_t
+Corridor::nrInside() const noexcept
+{
+    std::size_t res = 0;
+    for (auto word : m_bits) {
+        res += std::bitset<64>(word).count();
+    }
+    return res;
+}
+
+}
+
+}
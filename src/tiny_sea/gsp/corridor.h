@@ -0,0 +1,99 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+// includes
+// std
+#include <cstdint>
+#include <vector>
+
+// tiny_sea
+#include <tiny_sea/core/linear_space.h>
+#include <tiny_sea/core/n_vector.h>
+#include <tiny_sea/core/units.h>
+
+namespace tiny_sea {
+
+namespace gsp {
+
+/*! Raster of the pixels around a route.
+ *
+ * Pixel (x, y) is centered on the node (latSpace.value(x),
+ * lonSpace.value(y)) and cover half a delta around it, like LandMask.
+ * A pixel is inside the corridor if its center is closer to one of the
+ * route great circle segments than the corridor width plus half the pixel
+ * diagonal, so all positions closer than the width are inside.
+ *
+ * Pixels are bit-packed, a position test cost one pixel index computation
+ * and one word read.
+ *
+ * \warning Routes crossing the antimeridian are not supported.
+ */
+class Corridor
+{
+public:
+    /*!
+     * \param route Route positions, segments link consecutive positions.
+     * \param width Distance kept on each side of the route.
+     * \param resolution Pixel size.
+     * \throw Exception if \p route is empty or if \p width or \p resolution
+     * are not strictly positive.
+     */
+    Corridor(const std::vector<NVector>& route,
+             meter_t width,
+             meter_t resolution);
+
+    /*! Getter from pixel index.
+     * \warning \p x and \p y must be valid index.
+     */
+    bool operator()(std::size_t x, std::size_t y) const noexcept
+    {
+        std::size_t bit = x + y * m_latSpace.nrPoints();
+        return (m_bits[bit / 64] >> (bit % 64)) & 1u;
+    }
+
+    /// \return true if the pixel containing \p pos is inside the corridor
+    bool inside(const NVector& pos) const noexcept;
+
+    const LinearSpace<latitude_t>& latSpace() const noexcept
+    {
+        return m_latSpace;
+    }
+
+    const LinearSpace<longitude_t>& lonSpace() const noexcept
+    {
+        return m_lonSpace;
+    }
+
+    /// Number of pixels inside the corridor
+    std::size_t nrInside() const noexcept;
+
+    /// Memory used by the raster in bytes
+    std::size_t memory() const noexcept
+    {
+        return m_bits.size() * sizeof(std::uint64_t);
+    }
+
+private:
+    LinearSpace<latitude_t> m_latSpace;
+    LinearSpace<longitude_t> m_lonSpace;
+    std::vector<std::uint64_t> m_bits;
+};
+
+}
+
+}
@@ -0,0 +1,135 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// associated header
+#include <tiny_sea/gsp/corridor_planner.h>
+
+// includes
+// std
+#include <algorithm>
+
+// tiny_sea
+#include <tiny_sea/core/exception.h>
+#include <tiny_sea/core/world_map.h>
+#include <tiny_sea/gsp/binary_heap_open_list.h>
+#include <tiny_sea/gsp/close_list.h>
+#include <tiny_sea/gsp/corridor.h>
+#include <tiny_sea/gsp/dominance_table.h>
+#include <tiny_sea/gsp/global_shortest_path.h>
+#include <tiny_sea/gsp/neighbors_finder.h>
+#include <tiny_sea/gsp/state_factory.h>
+
+namespace tiny_sea {
+
+namespace gsp {
+
+CorridorPlanner::CorridorPlanner(const TimeWorldMap* timeWorldMap,
+                                 const CompiledBoatVelocityTable& speedTable,
+                                 velocity_t maxVelocity,
+                                 PlannerResolution coarse,
+                                 PlannerResolution fine,
+                                 meter_t corridorWidth)
+  : m_timeWorldMap(timeWorldMap)
+  , m_speedTable(speedTable)
+  , m_maxVelocity(maxVelocity)
+  , m_coarse(coarse)
+  , m_fine(fine)
+  , m_corridorWidth(corridorWidth)
+{
+    if (corridorWidth <= meter_t(0.)) {
+        throw Exception("Corridor width must be positive");
+    }
+}
+
+std::optional<PlannerResult>
+CorridorPlanner::find(const NVector& start,
+                      time_t startTime,
+                      const NVector& target) const
+{
+    std::vector<State> coarseRoute;
+    std::size_t nrCoarseExpanded =
+      search(m_coarse, nullptr, start, startTime, target, coarseRoute);
+    if (coarseRoute.empty()) {
+        return std::nullopt;
+    }
+
+    // Coarse final state is in the target discret cell, not on the target
+    std::vector<NVector> positions;
+    positions.reserve(coarseRoute.size() + 1);
+    for (const auto& state : coarseRoute) {
+        positions.push_back(state.position());
+    }
+    positions.push_back(target);
+
+    // Pixels at the fine discretisation are enough to follow the route
+    Corridor corridor(positions,
+                      m_corridorWidth,
+                      std::min(m_fine.discretDistance, m_corridorWidth));
+    std::vector<State> route;
+    std::size_t nrFineExpanded =
+      search(m_fine, &corridor, start, startTime, target, route);
+    if (route.empty()) {
+        return std::nullopt;
+    }
+
+    return PlannerResult{ route.back(),
+                          std::move(route),
+                          std::move(coarseRoute),
+                          nrCoarseExpanded,
+                          nrFineExpanded };
+}
+
+std::size_t
+CorridorPlanner::search(const PlannerResolution& resolution,
+                        const Corridor* corridor,
+                        const NVector& start,
+                        time_t startTime,
+                        const NVector& target,
+                        std::vector<State>& route) const
+{
+    StateFactory factory(resolution.discretTime,
+                         resolution.discretDistance,
+                         startTime,
+                         meter_t(EARTH_RADIUS),
+                         target,
+                         m_maxVelocity);
+    NeighborsFinder neighborsFinder(
+      &factory, m_timeWorldMap, m_speedTable, resolution.moveDistance);
+    if (m_setup) {
+        m_setup(neighborsFinder);
+    }
+    neighborsFinder.setCorridor(corridor);
+    DominanceTable dominanceTable;
+    if (m_dominance) {
+        neighborsFinder.setDominanceTable(&dominanceTable);
+    }
+
+    CloseList closeList;
+    std::vector<State> startState({ factory.build(start, startTime) });
+    BinaryHeapOpenList openList(startState.begin(), startState.end());
+    auto path = findGlobalShortestPath(factory.build(target, startTime),
+                                       openList,
+                                       closeList,
+                                       neighborsFinder);
+    if (path) {
+        route = closeList.route(path->state);
+    }
+    return closeList.size();
+}
+
+}
+
+}
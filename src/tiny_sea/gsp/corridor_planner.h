@@ -0,0 +1,147 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+// includes
+// std
+#include <functional>
+#include <optional>
+#include <vector>
+
+// tiny_sea
+#include <tiny_sea/core/compiled_boat_velocity_table.h>
+#include <tiny_sea/core/n_vector.h>
+#include <tiny_sea/core/units.h>
+#include <tiny_sea/fwd.h>
+#include <tiny_sea/gsp/state.h>
+
+namespace tiny_sea {
+
+namespace gsp {
+
+/// Discretisation of one CorridorPlanner phase
+struct PlannerResolution
+{
+    PlannerResolution(time_t p_discretTime,
+                      meter_t p_discretDistance,
+                      meter_t p_moveDistance)
+      : discretTime(p_discretTime)
+      , discretDistance(p_discretDistance)
+      , moveDistance(p_moveDistance)
+    {}
+
+    time_t discretTime;      //< StateFactory discretisation time.
+    meter_t discretDistance; //< StateFactory discretisation distance.
+    meter_t moveDistance;    //< NeighborsFinder move distance.
+};
+
+/// Result of CorridorPlanner::find
+struct PlannerResult
+{
+    State state;                     //< Fine search final state.
+    std::vector<State> route;        //< Fine route from start to target.
+    std::vector<State> coarseRoute;  //< Coarse route from start to target.
+    std::size_t nrCoarseExpanded;    //< Coarse search expanded states.
+    std::size_t nrFineExpanded;      //< Fine search expanded states.
+};
+
+/*! Two phases coarse to fine planner.
+ *
+ * A first search with a coarse discretisation and long moves find a coarse
+ * route. A second search with the fine discretisation only keep the moves
+ * ending in a Corridor around the coarse route, so it expand the states of
+ * a narrow band instead of the whole area explored by the heuristic.
+ *
+ * The fine route is optimal inside the corridor only, a wider corridor
+ * trade expansions for quality.
+ */
+class CorridorPlanner
+{
+public:
+    /// Called on the NeighborsFinder of both phases before the search
+    using setup_type = std::function<void(NeighborsFinder&)>;
+
+public:
+    /*!
+     * \param timeWorldMap Must outlive the planner.
+     * \param speedTable Boat velocity table of both phases.
+     * \param maxVelocity Maximum speed over ground, including the currents,
+     * use to compute the heuristic. \see StateFactory
+     * \param coarse Coarse phase discretisation.
+     * \param fine Fine phase discretisation.
+     * \param corridorWidth Distance kept on each side of the coarse route.
+     * \throw Exception if \p corridorWidth is not strictly positive.
+     */
+    CorridorPlanner(const TimeWorldMap* timeWorldMap,
+                    const CompiledBoatVelocityTable& speedTable,
+                    velocity_t maxVelocity,
+                    PlannerResolution coarse,
+                    PlannerResolution fine,
+                    meter_t corridorWidth);
+
+    /*! Configure the NeighborsFinder of both phases (land mask, obstacles,
+     * raster, ...).
+     * \param setup Empty to disable it.
+     * \warning \p setup is called for both phases, so it must not install a
+     * per search state like a DominanceTable, use setDominance.
+     */
+    void setSetup(setup_type setup) { m_setup = std::move(setup); }
+
+    /*! Prune dominated moves in both phases.
+     * Each phase use its own empty DominanceTable, coarse arrivals never
+     * prune fine states. \see NeighborsFinder::setDominanceTable
+     */
+    void setDominance(bool dominance) noexcept { m_dominance = dominance; }
+
+    /*! Find a route from \p start at \p startTime to \p target.
+     * \return std::nullopt if the coarse search fail or if the fine search
+     * fail inside the corridor
+     */
+    std::optional<PlannerResult> find(const NVector& start,
+                                      time_t startTime,
+                                      const NVector& target) const;
+
+    const PlannerResolution& coarse() const noexcept { return m_coarse; }
+    const PlannerResolution& fine() const noexcept { return m_fine; }
+    meter_t corridorWidth() const noexcept { return m_corridorWidth; }
+    bool dominance() const noexcept { return m_dominance; }
+
+private:
+    /*! Search a route with \p resolution restricted to \p corridor.
+     * \return Expanded states number
+     */
+    std::size_t search(const PlannerResolution& resolution,
+                       const Corridor* corridor,
+                       const NVector& start,
+                       time_t startTime,
+                       const NVector& target,
+                       std::vector<State>& route) const;
+
+private:
+    const TimeWorldMap* m_timeWorldMap;
+    CompiledBoatVelocityTable m_speedTable;
+    velocity_t m_maxVelocity;
+    PlannerResolution m_coarse;
+    PlannerResolution m_fine;
+    meter_t m_corridorWidth;
+    setup_type m_setup;
+    bool m_dominance = false;
+};
+
+}
+
+}
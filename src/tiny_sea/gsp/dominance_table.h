@@ -0,0 +1,105 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+// includes
+// std
+#include <unordered_map>
+
+// tiny_sea
+#include <tiny_sea/core/units.h>
+#include <tiny_sea/gsp/discret_state.h>
+#include <tiny_sea/gsp/state.h>
+
+namespace tiny_sea {
+
+namespace gsp {
+
+/*! Earliest known arrival time of each spatial cell.
+ *
+ * DiscretState include the time bucket, so the same cell reached later is
+ * a different state. Travel times are FIFO since a boat can always wait:
+ * a state reaching a cell later than a known arrival can never be better.
+ *
+ * States are keyed on the spatial part of their DiscretState, like
+ * State::same.
+ *
+ * \warning The pruning is approximate. A cell cover many positions and only
+ * the first one reached is kept, a later state at another position of the
+ * cell can lead to a shorter path. The found travel time can differ from
+ * the search without table by up to the time to cross a cell.
+ * \see NeighborsFinder::setDominanceTable
+ */
+class DominanceTable
+{
+public:
+    /// (0, x, y, z) key
+    using key_type = DiscretState;
+    using container_t = std::unordered_map<key_type, time_t, DiscretStateHash>;
+
+public:
+    /*! Record the arrival of \p state in its cell.
+     * \return false if \p state reach its cell at or after the earliest known
+     * arrival
+     */
+    bool insert(const State& state)
+    {
+        auto res = m_store.emplace(key(state), state.time());
+        if (!res.second) {
+            if (res.first->second <= state.time()) {
+                ++m_nrDominated;
+                return false;
+            }
+            res.first->second = state.time();
+        }
+        return true;
+    }
+
+    /// \return true if \p state reach its cell at or after a known arrival
+    bool dominated(const State& state) const
+    {
+        auto it = m_store.find(key(state));
+        return it != m_store.end() && it->second <= state.time();
+    }
+
+    /// Remove all arrivals and reset the counter
+    void clear()
+    {
+        m_store.clear();
+        m_nrDominated = 0;
+    }
+
+    /// Number of states rejected by insert
+    std::size_t nrDominated() const noexcept { return m_nrDominated; }
+    std::size_t size() const noexcept { return m_store.size(); }
+
+private:
+    static key_type key(const State& state)
+    {
+        const auto& ds = state.discretState();
+        return std::make_tuple(
+          std::uint64_t(0), std::get<1>(ds), std::get<2>(ds), std::get<3>(ds));
+    }
+
+private:
+    container_t m_store;
+    std::size_t m_nrDominated = 0;
+};
+
+}
+
+}
@@ -0,0 +1,45 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+// includes
+// tiny_sea
+#include <tiny_sea/core/n_vector.h>
+#include <tiny_sea/core/units.h>
+
+namespace tiny_sea {
+
+namespace gsp {
+
+/*! Heuristic policy used by StateFactory to tighten the distance / max
+ * velocity heuristic.
+ * \see StateFactory::setHeuristic
+ */
+class Heuristic
+{
+public:
+    virtual ~Heuristic() = default;
+
+    /*! \return Lower bound of the travel time from \p position to the
+     * target, must be admissible.
+     */
+    virtual cost_t heuristic(const NVector& position) const noexcept = 0;
+};
+
+}
+
+}
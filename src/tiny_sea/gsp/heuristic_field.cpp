@@ -0,0 +1,104 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// associated header
+#include <tiny_sea/gsp/heuristic_field.h>
+
+// includes
+// std
+#include <algorithm>
+#include <utility>
+
+// tiny_sea
+#include <tiny_sea/core/exception.h>
+
+namespace tiny_sea {
+
+namespace gsp {
+
+HeuristicField::HeuristicField(const TimeWorldMap& timeWorldMap,
+                               const CompiledBoatVelocityTable& speedTable,
+                               const LinearSpace<latitude_t>& latSpace,
+                               const LinearSpace<longitude_t>& lonSpace,
+                               const NVector& target,
+                               const TidalCurrentGrid* tidalCurrentGrid)
+  : m_lattice(timeWorldMap, speedTable, latSpace, lonSpace, tidalCurrentGrid)
+{
+    auto start = std::chrono::steady_clock::now();
+    computeTimes(target);
+    m_buildTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start);
+}
+
+HeuristicField::HeuristicField(VelocityLattice lattice, const NVector& target)
+  : m_lattice(std::move(lattice))
+{
+    auto start = std::chrono::steady_clock::now();
+    computeTimes(target);
+    m_buildTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start);
+}
+
+cost_t
+HeuristicField::heuristic(const NVector& position) const noexcept
+{
+    const auto& latLon = position.toLatLon();
+    std::size_t x, y;
+    if (!m_lattice.cellIndex(latLon.first, latLon.second, x, y)) {
+        return cost_t(0.);
+    }
+
+    double velocity = m_lattice.cellVelocity(x, y).t;
+    if (velocity <= 0.) {
+        return cost_t(0.);
+    }
+
+    double res = 0.;
+    for (std::size_t n = 0; n < 4; ++n) {
+        std::size_t idx = m_lattice.node(x + n % 2, y + n / 2);
+        res = std::max(res,
+                       m_times[idx] -
+                         position.distance(m_lattice.position(idx)).t /
+                           velocity);
+    }
+    return cost_t(res);
+}
+
+void
+HeuristicField::computeTimes(const NVector& target)
+{
+    const auto& targetLatLon = target.toLatLon();
+    std::size_t tx, ty;
+    if (!m_lattice.cellIndex(targetLatLon.first, targetLatLon.second, tx, ty)) {
+        throw Exception("HeuristicField target is outside the lattice");
+    }
+
+    // Target cell nodes can reach the target by leaving the cell
+    std::vector<VelocityLattice::source_type> sources;
+    double maxVelocity = m_lattice.maxVelocity().t;
+    if (maxVelocity > 0.) {
+        for (std::size_t n = 0; n < 4; ++n) {
+            std::size_t idx = m_lattice.node(tx + n % 2, ty + n / 2);
+            sources.emplace_back(
+              idx, m_lattice.position(idx).distance(target).t / maxVelocity);
+        }
+    }
+    m_times = m_lattice.times(sources, m_lattice.lengthFactor());
+}
+
+}
+
+}
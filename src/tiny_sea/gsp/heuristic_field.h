@@ -0,0 +1,130 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+// includes
+// std
+#include <chrono>
+#include <vector>
+
+// tiny_sea
+#include <tiny_sea/core/linear_space.h>
+#include <tiny_sea/core/n_vector.h>
+#include <tiny_sea/core/units.h>
+#include <tiny_sea/fwd.h>
+#include <tiny_sea/gsp/heuristic.h>
+#include <tiny_sea/gsp/velocity_lattice.h>
+
+namespace tiny_sea {
+
+namespace gsp {
+
+/*! Lower bound of the travel time to a target precomputed on a coarse
+ * latitude and longitude lattice.
+ *
+ * A backward Dijkstra from the target compute a lower bound of the travel
+ * time to the target for each node of a VelocityLattice. Edge times are
+ * scaled by VelocityLattice::lengthFactor so lattice paths never
+ * overestimate great circle paths.
+ *
+ * A position use the nodes of its cell: moving from a node to a position of
+ * the cell take at least distance / cell velocity, so
+ * h(p) = max_n(t(n) - d(p, n) / v(cell)) is still a lower bound.
+ *
+ * \warning The lattice should cover the sailing area, positions outside of
+ * it have a null lower bound.
+ */
+class HeuristicField : public Heuristic
+{
+public:
+    /*! Compute a VelocityLattice and the field.
+     * \param latSpace Lattice latitude nodes, at least 2.
+     * \param lonSpace Lattice longitude nodes, at least 2.
+     * \param target Target position, must be inside the lattice.
+     * \param tidalCurrentGrid \see VelocityLattice.
+     * \throw Exception if the lattice is too small or if the target is
+     * outside the lattice.
+     */
+    HeuristicField(const TimeWorldMap& timeWorldMap,
+                   const CompiledBoatVelocityTable& speedTable,
+                   const LinearSpace<latitude_t>& latSpace,
+                   const LinearSpace<longitude_t>& lonSpace,
+                   const NVector& target,
+                   const TidalCurrentGrid* tidalCurrentGrid = nullptr);
+
+    /*! Compute the field on an existing lattice.
+     * \throw Exception if the target is outside the lattice.
+     */
+    HeuristicField(VelocityLattice lattice, const NVector& target);
+
+    /// \return Lower bound of the travel time from \p position to the target
+    cost_t heuristic(const NVector& position) const noexcept override;
+
+    /*! Lower bound of the travel time from node (\p x, \p y).
+     * \warning \p x and \p y must be valid index.
+     */
+    cost_t operator()(std::size_t x, std::size_t y) const noexcept
+    {
+        return cost_t(m_times[m_lattice.node(x, y)]);
+    }
+
+    /// \see VelocityLattice::cellVelocity
+    velocity_t cellVelocity(std::size_t x, std::size_t y) const noexcept
+    {
+        return m_lattice.cellVelocity(x, y);
+    }
+
+    /// \see VelocityLattice::maxVelocity
+    velocity_t maxVelocity() const noexcept
+    {
+        return m_lattice.maxVelocity();
+    }
+
+    const VelocityLattice& lattice() const noexcept { return m_lattice; }
+
+    const LinearSpace<latitude_t>& latSpace() const noexcept
+    {
+        return m_lattice.latSpace();
+    }
+
+    const LinearSpace<longitude_t>& lonSpace() const noexcept
+    {
+        return m_lattice.lonSpace();
+    }
+
+    /// Time spent to precompute the field
+    std::chrono::nanoseconds buildTime() const noexcept { return m_buildTime; }
+
+    /// Memory used by the field in bytes
+    std::size_t memory() const noexcept
+    {
+        return m_times.size() * sizeof(double) + m_lattice.memory();
+    }
+
+private:
+    /// Backward Dijkstra from the target
+    void computeTimes(const NVector& target);
+
+private:
+    VelocityLattice m_lattice;
+    std::vector<double> m_times;
+    std::chrono::nanoseconds m_buildTime;
+};
+
+}
+
+}
@@ -0,0 +1,222 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// associated header
+#include <tiny_sea/gsp/landmarks.h>
+
+// includes
+// std
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+// tiny_sea
+#include <tiny_sea/core/exception.h>
+
+namespace tiny_sea {
+
+namespace gsp {
+
+Landmarks::Landmarks(VelocityLattice lattice,
+                     std::size_t nrLandmarks,
+                     std::size_t nrThreads)
+  : m_lattice(std::move(lattice))
+{
+    if (nrLandmarks == 0) {
+        throw Exception("Landmarks needs at least one landmark");
+    }
+
+    // Border nodes in counterclockwise order
+    std::size_t nx = m_lattice.latSpace().nrPoints();
+    std::size_t ny = m_lattice.lonSpace().nrPoints();
+    std::vector<std::size_t> border;
+    border.reserve(2 * (nx + ny) - 4);
+    for (std::size_t y = 0; y < ny - 1; ++y) {
+        border.push_back(m_lattice.node(0, y));
+    }
+    for (std::size_t x = 0; x < nx - 1; ++x) {
+        border.push_back(m_lattice.node(x, ny - 1));
+    }
+    for (std::size_t y = ny - 1; y > 0; --y) {
+        border.push_back(m_lattice.node(nx - 1, y));
+    }
+    for (std::size_t x = nx - 1; x > 0; --x) {
+        border.push_back(m_lattice.node(x, 0));
+    }
+
+    nrLandmarks = std::min(nrLandmarks, border.size());
+    for (std::size_t l = 0; l < nrLandmarks; ++l) {
+        m_landmarks.push_back(border[(l * border.size()) / nrLandmarks]);
+    }
+    computeTimes(nrThreads);
+}
+
+Landmarks::Landmarks(VelocityLattice lattice,
+                     const std::vector<NVector>& positions,
+                     std::size_t nrThreads)
+  : m_lattice(std::move(lattice))
+{
+    if (positions.empty()) {
+        throw Exception("Landmarks needs at least one landmark");
+    }
+
+    const auto& latSpace = m_lattice.latSpace();
+    const auto& lonSpace = m_lattice.lonSpace();
+    for (const auto& position : positions) {
+        const auto& latLon = position.toLatLon();
+        if (!latSpace.inside(latLon.first) || !lonSpace.inside(latLon.second)) {
+            throw Exception("Landmark is outside the lattice");
+        }
+        auto x = std::lround((latLon.first - latSpace.start()).t /
+                             latSpace.delta().t);
+        auto y = std::lround((latLon.second - lonSpace.start()).t /
+                             lonSpace.delta().t);
+        m_landmarks.push_back(m_lattice.node(
+          std::min(std::size_t(x), latSpace.nrPoints() - 1),
+          std::min(std::size_t(y), lonSpace.nrPoints() - 1)));
+    }
+    computeTimes(nrThreads);
+}
+
+void
+Landmarks::computeTimes(std::size_t nrThreads)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    std::size_t nrNodes = m_lattice.nrNodes();
+    m_times.resize(m_landmarks.size() * nrNodes);
+
+    // Each thread take the next landmark to compute
+    if (nrThreads == 0) {
+        nrThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    nrThreads = std::min(nrThreads, m_landmarks.size());
+
+    std::atomic<std::size_t> nextLandmark(0);
+    auto worker = [&]() {
+        for (std::size_t l = nextLandmark++; l < m_landmarks.size();
+             l = nextLandmark++) {
+            auto times = m_lattice.times({ { m_landmarks[l], 0. } }, 1.);
+            std::copy(times.begin(),
+                      times.end(),
+                      m_times.begin() + std::ptrdiff_t(l * nrNodes));
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (std::size_t i = 1; i < nrThreads; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    m_buildTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start);
+}
+
+LandmarkHeuristic::LandmarkHeuristic(const Landmarks& landmarks,
+                                     const NVector& target)
+  : m_landmarks(&landmarks)
+{
+    const auto& latLon = target.toLatLon();
+    std::size_t x, y;
+    if (!landmarks.lattice().cellIndex(latLon.first, latLon.second, x, y)) {
+        throw Exception("LandmarkHeuristic target is outside the lattice");
+    }
+
+    // A target in a cell without speed give no bound
+    cell_type nodes;
+    if (!cell(target, nodes)) {
+        return;
+    }
+    for (std::size_t l = 0; l < landmarks.nrLandmarks(); ++l) {
+        auto res = bounds(l, nodes);
+        m_targetLow.push_back(res.first);
+        m_targetUp.push_back(res.second);
+    }
+}
+
+cost_t
+LandmarkHeuristic::heuristic(const NVector& position) const noexcept
+{
+    cell_type nodes;
+    if (m_targetLow.empty() || !cell(position, nodes)) {
+        return cost_t(0.);
+    }
+
+    double res = 0.;
+    for (std::size_t l = 0; l < m_targetLow.size(); ++l) {
+        auto pos = bounds(l, nodes);
+        // Landmarks that can't reach one of the positions give no bound
+        double forward = m_targetLow[l] - pos.second;
+        double backward = pos.first - m_targetUp[l];
+        if (std::isfinite(forward)) {
+            res = std::max(res, forward);
+        }
+        if (std::isfinite(backward)) {
+            res = std::max(res, backward);
+        }
+    }
+    return cost_t(res);
+}
+
+bool
+LandmarkHeuristic::cell(const NVector& position,
+                        cell_type& nodes) const noexcept
+{
+    const auto& lattice = m_landmarks->lattice();
+    const auto& latLon = position.toLatLon();
+    std::size_t x, y;
+    if (!lattice.cellIndex(latLon.first, latLon.second, x, y)) {
+        return false;
+    }
+
+    double velocity = lattice.cellVelocity(x, y).t;
+    if (velocity <= 0.) {
+        return false;
+    }
+
+    for (std::size_t n = 0; n < 4; ++n) {
+        std::size_t idx = lattice.node(x + n % 2, y + n / 2);
+        nodes[n] = std::make_pair(
+          idx, position.distance(lattice.position(idx)).t / velocity);
+    }
+    return true;
+}
+
+std::pair<double, double>
+LandmarkHeuristic::bounds(std::size_t l, const cell_type& nodes) const noexcept
+{
+    double factor = m_landmarks->lattice().lengthFactor();
+    double low = -std::numeric_limits<double>::infinity();
+    double up = std::numeric_limits<double>::infinity();
+    for (const auto& node : nodes) {
+        double time = m_landmarks->time(l, node.first);
+        if (std::isfinite(time)) {
+            low = std::max(low, factor * time - node.second);
+            up = std::min(up, time + node.second);
+        }
+    }
+    return std::make_pair(low, up);
+}
+
+}
+
+}
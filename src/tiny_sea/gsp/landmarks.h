@@ -0,0 +1,154 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+// includes
+// std
+#include <array>
+#include <chrono>
+#include <utility>
+#include <vector>
+
+// tiny_sea
+#include <tiny_sea/core/n_vector.h>
+#include <tiny_sea/core/units.h>
+#include <tiny_sea/fwd.h>
+#include <tiny_sea/gsp/heuristic.h>
+#include <tiny_sea/gsp/velocity_lattice.h>
+
+namespace tiny_sea {
+
+namespace gsp {
+
+/*! ALT landmarks precomputed on a VelocityLattice.
+ *
+ * Store the lattice time Λ(l, n) between each landmark l and each lattice
+ * node n. Lattice times don't depend on the target, so one Landmarks can be
+ * shared by all the queries on the same forecast.
+ * \see LandmarkHeuristic
+ */
+class Landmarks
+{
+public:
+    /*! Select \p nrLandmarks nodes evenly spaced on the lattice border.
+     * Border landmarks are behind most of the start and target positions,
+     * that give tight triangle inequality bounds.
+     * \param nrThreads Number of threads, 0 to use all hardware threads.
+     * \throw Exception if \p nrLandmarks is 0.
+     */
+    Landmarks(VelocityLattice lattice,
+              std::size_t nrLandmarks,
+              std::size_t nrThreads = 0);
+
+    /*! Use the lattice nodes nearest to \p positions as landmarks.
+     * \param nrThreads Number of threads, 0 to use all hardware threads.
+     * \throw Exception if \p positions is empty or if a position is outside
+     * the lattice.
+     */
+    Landmarks(VelocityLattice lattice,
+              const std::vector<NVector>& positions,
+              std::size_t nrThreads = 0);
+
+    const VelocityLattice& lattice() const noexcept { return m_lattice; }
+
+    std::size_t nrLandmarks() const noexcept { return m_landmarks.size(); }
+
+    /// Lattice node index of landmark \p l
+    std::size_t landmark(std::size_t l) const noexcept
+    {
+        return m_landmarks[l];
+    }
+
+    /*! Lattice time between landmark \p l and node \p node.
+     * \return Infinity if \p node is unreachable
+     */
+    double time(std::size_t l, std::size_t node) const noexcept
+    {
+        return m_times[node + l * m_lattice.nrNodes()];
+    }
+
+    /// Time spent to precompute the landmarks
+    std::chrono::nanoseconds buildTime() const noexcept { return m_buildTime; }
+
+    /// Memory used by the landmarks in bytes
+    std::size_t memory() const noexcept
+    {
+        return m_times.size() * sizeof(double) + m_lattice.memory();
+    }
+
+private:
+    /// Compute the landmarks times in parallel
+    void computeTimes(std::size_t nrThreads);
+
+private:
+    VelocityLattice m_lattice;
+    std::vector<std::size_t> m_landmarks;
+    std::vector<double> m_times;
+    std::chrono::nanoseconds m_buildTime;
+};
+
+/*! Heuristic policy using the ALT landmarks triangle inequality.
+ *
+ * Lattice times Λ are an upper bound of the relaxed travel time R (boat
+ * speed upper bound in each cell, no time dependency) and f·Λ is a lower
+ * bound of it, f being VelocityLattice::lengthFactor. A position p of a
+ * cell with velocity v is bounded by the cell nodes n:
+ * max_n(f·Λ(l, n) - d(p, n) / v) <= R(l, p) <= min_n(Λ(l, n) + d(p, n) / v).
+ *
+ * Since R(p, target) >= |R(l, target) - R(l, p)|, the heuristic is the
+ * maximum over all landmarks of the lower bound of this difference.
+ *
+ * \warning Positions outside of the lattice have a null lower bound.
+ */
+class LandmarkHeuristic : public Heuristic
+{
+public:
+    /*!
+     * \param landmarks Must outlive the heuristic.
+     * \param target Target position, must be inside the lattice.
+     * \throw Exception if the target is outside the lattice.
+     */
+    LandmarkHeuristic(const Landmarks& landmarks, const NVector& target);
+
+    /// \return Lower bound of the travel time from \p position to the target
+    cost_t heuristic(const NVector& position) const noexcept override;
+
+    const Landmarks& landmarks() const noexcept { return *m_landmarks; }
+
+private:
+    /// Nodes of a cell and the time to reach a position from them
+    using cell_type = std::array<std::pair<std::size_t, double>, 4>;
+
+    /*! Nodes of the cell containing \p position.
+     * \return false if \p position is outside the lattice or in a cell
+     * without speed
+     */
+    bool cell(const NVector& position, cell_type& nodes) const noexcept;
+
+    /// Relaxed time bounds between landmark \p l and a position of \p nodes
+    std::pair<double, double> bounds(std::size_t l,
+                                     const cell_type& nodes) const noexcept;
+
+private:
+    const Landmarks* m_landmarks;
+    std::vector<double> m_targetLow;
+    std::vector<double> m_targetUp;
+};
+
+}
+
+}
@@ -18,15 +18,47 @@
 #include <tiny_sea/gsp/neighbors_finder.h>
 
 // includes
+// std
+#include <algorithm>
+#include <cmath>
+
 // tiny_sea
-#include <tiny_sea/core/boat_velocity_table.h>
+#include <tiny_sea/core/boat_velocity_raster.h>
+#include <tiny_sea/core/edge_index.h>
+#include <tiny_sea/core/land_mask.h>
+#include <tiny_sea/core/tidal_current_grid.h>
+#include <tiny_sea/core/time_obstacle_index.h>
 #include <tiny_sea/core/world_map.h>
+#include <tiny_sea/gsp/corridor.h>
+#include <tiny_sea/gsp/dominance_table.h>
 #include <tiny_sea/gsp/state_factory.h>
+#include <tiny_sea/gsp/world_map_sample_cache.h>
 
 namespace tiny_sea {
 
 namespace gsp {
 
+namespace {
+
+/*! Best velocity made good toward \p bearing of all the relative wind
+ * bearings. A track in a no-go zone is sailed by tacks or gybes.
+ */
+double
+bestVmg(const CompiledBoatVelocityTable::array_type& relativeWindBearings,
+        const CompiledBoatVelocityTable::array_type& velocities,
+        double windBearing,
+        double bearing) noexcept
+{
+    double res = 0.;
+    for (Eigen::Index i = 0; i < velocities.size(); ++i) {
+        double cos = std::cos(windBearing + relativeWindBearings(i) - bearing);
+        res = std::max(res, velocities(i) * cos);
+    }
+    return res;
+}
+
+}
+
 void
 NeighborsFinder::search(CloseList::iterator it,
                         std::vector<State>& neighbors) const
@@ -36,43 +68,207 @@ NeighborsFinder::search(CloseList::iterator it,
         return;
     }
 
-    // Take WorldMap at current time
+    if (m_dominanceTable) {
+        m_dominanceTable->insert(*it);
+    }
+
+    // Take WorldMap index at current time
     auto world_index = m_timeWorldMap->xSpace().index(it->time());
-    const auto& worldMap = (*m_timeWorldMap)(world_index);
 
-    // Take WorldMap data at current position
-    const auto& latLon = it->position().toLatLon();
-    const auto& worldMapData =
-      worldMap.worldGrid().safeInterpolated(latLon.first, latLon.second);
+    // Compute wind bearing and boat velocities of all relative wind bearings
+    radian_t windBearing;
+    WindVector current;
+    const CompiledBoatVelocityTable::array_type* relativeWindBearings;
+    sample(
+      it->position(), it->time(), windBearing, current, relativeWindBearings);
 
-    // Add a static configuration at the next time
+    // Add a static configuration at the next time, unless a zone activate
+    // around the boat
     auto next_time = m_timeWorldMap->xSpace().value(world_index + 1);
-    neighbors.push_back(
-      m_stateFactory->build(it->position(), next_time, it->discretState()));
+    if (!m_timeObstacleIndex ||
+        !m_timeObstacleIndex->blocked(
+          it->position(), it->position(), it->time(), next_time)) {
+        neighbors.push_back(
+          m_stateFactory->build(it->position(), next_time, it->discretState()));
+    }
 
     // Take minimal distance between hard coded move distance and remaining
     // distance
     auto distToGo =
       std::min(m_moveDistance, m_stateFactory->distanceToTarget(*it));
-    for (const auto& boatSpeed : m_speedTable->velocityTable()) {
+    bool hasCurrent = current.m_x.t != 0. || current.m_y.t != 0.;
+    m_targetBearings.clear();
+    m_targetVelocities.clear();
+    for (Eigen::Index i = 0; i < m_boatVelocities.size(); ++i) {
         // Compute target velocity
-        velocity_t targetVelocity =
-          boatSpeed.windVelocityToBoatVelocity.safeInterpolated(
-            worldMapData.windVelocity);
+        velocity_t targetVelocity(m_boatVelocities(i));
 
-        // If velocity is not null we compute the new position and time
+        // If velocity is not null we keep the target bearing, relative wind
+        // + current wind
         if (targetVelocity > velocity_t(0.)) {
-            // Compute target bearing, relative wind + current wind
-            radian_t targetBearing =
-              worldMapData.windBearing + boatSpeed.relativeWindBearing;
+            radian_t heading =
+              windBearing + radian_t((*relativeWindBearings)(i));
+            if (hasCurrent) {
+                // Speed and course over ground: water velocity + current
+                double east =
+                  targetVelocity.t * std::sin(heading.t) + current.m_x.t;
+                double north =
+                  targetVelocity.t * std::cos(heading.t) + current.m_y.t;
+                targetVelocity = velocity_t(std::hypot(east, north));
+                if (targetVelocity <= velocity_t(0.)) {
+                    continue;
+                }
+                heading = radian_t(std::atan2(east, north));
+            }
+            m_targetBearings.push_back(heading);
+            m_targetVelocities.push_back(targetVelocity);
+        }
+    }
+
+    // Compute all new positions at once
+    m_targetPositions.resize(m_targetBearings.size());
+    it->position().destinations(m_targetBearings.data(),
+                                distToGo,
+                                m_targetBearings.size(),
+                                m_targetPositions.data());
+    for (std::size_t i = 0; i < m_targetPositions.size(); ++i) {
+        auto timeOffset = (distToGo / m_targetVelocities[i]);
+        auto targetTime = it->time() + timeOffset;
+        if (pruned(
+              it->position(), m_targetPositions[i], it->time(), targetTime)) {
+            continue;
+        }
+        auto neighbor = m_stateFactory->build(
+          m_targetPositions[i], targetTime, it->discretState());
+        if (m_dominanceTable && !m_dominanceTable->insert(neighbor)) {
+            continue;
+        }
+        neighbors.push_back(neighbor);
+    }
 
-            auto newPos = it->position().destination(targetBearing, distToGo);
-            auto timeOffset = (distToGo / targetVelocity);
+    // Direct leg to the target from its neighborhood
+    time_t arrival;
+    if (m_directShotRadius > meter_t(0.) &&
+        m_stateFactory->distanceToTarget(*it) <= m_directShotRadius &&
+        directShot(*it, arrival)) {
+        auto neighbor = m_stateFactory->build(
+          m_stateFactory->targetPosition(), arrival, it->discretState());
+        if (!m_dominanceTable || m_dominanceTable->insert(neighbor)) {
+            neighbors.push_back(neighbor);
+        }
+    }
+}
+
+void
+NeighborsFinder::sample(
+  const NVector& position,
+  time_t time,
+  radian_t& windBearing,
+  WindVector& current,
+  const CompiledBoatVelocityTable::array_type*& relativeWindBearings) const
+{
+    auto world_index = m_timeWorldMap->xSpace().index(time);
+    if (m_boatVelocityRaster) {
+        const auto& latLon = position.toLatLon();
+        m_boatVelocityRaster->interpolated(world_index,
+                                           latLon.first,
+                                           latLon.second,
+                                           windBearing,
+                                           m_boatVelocities,
+                                           current);
+        relativeWindBearings = &m_boatVelocityRaster->relativeWindBearings();
+    } else {
+        // Take WorldMap data at current position
+        WorldMapData worldMapData;
+        if (m_timeInterpolation) {
+            const auto& latLon = position.toLatLon();
+            worldMapData = m_timeWorldMap->safeInterpolated(
+              time, latLon.first, latLon.second);
+        } else if (m_sampleCache) {
+            worldMapData = m_sampleCache->sample(world_index, position);
+        } else {
+            const auto& latLon = position.toLatLon();
+            const auto& worldMap = m_timeWorldMap->values()[world_index];
+            worldMapData =
+              worldMap.safeInterpolated(latLon.first, latLon.second);
+        }
+
+        // Compute boat velocities of all relative wind bearings in one pass
+        windBearing = worldMapData.windBearing;
+        current = worldMapData.current;
+        m_speedTable.velocities(worldMapData.windVelocity, m_boatVelocities);
+        relativeWindBearings = &m_speedTable.relativeWindBearings();
+    }
+
+    // Harmonic tidal current use the same hook than the gridded one
+    if (m_tidalCurrentGrid) {
+        const auto& latLon = position.toLatLon();
+        auto tide =
+          m_tidalCurrentGrid->current(time, latLon.first, latLon.second);
+        current = WindVector(current.m_x + tide.m_x, current.m_y + tide.m_y);
+    }
+}
+
+bool
+NeighborsFinder::pruned(const NVector& from,
+                        const NVector& to,
+                        time_t fromTime,
+                        time_t toTime) const
+{
+    return (m_corridor && !m_corridor->inside(to)) ||
+           (m_landMask && m_landMask->blocked(from, to)) ||
+           (m_edgeIndex && m_edgeIndex->crossed(from, to)) ||
+           (m_timeObstacleIndex &&
+            m_timeObstacleIndex->blocked(from, to, fromTime, toTime));
+}
+
+bool
+NeighborsFinder::directShot(const State& state, time_t& arrival) const
+{
+    const NVector& target = m_stateFactory->targetPosition();
+    NVector position = state.position();
+    arrival = state.time();
+    meter_t remaining = position.distance(target);
+
+    radian_t windBearing;
+    WindVector current;
+    const CompiledBoatVelocityTable::array_type* relativeWindBearings;
+    while (remaining > meter_t(0.)) {
+        if (arrival >= m_timeWorldMap->xSpace().stop()) {
+            return false;
+        }
+        sample(position, arrival, windBearing, current, relativeWindBearings);
+
+        // Sail along the great circle at the best velocity made good, that
+        // must compensate the cross track current
+        double bearing = position.bearing(target).t;
+        double velocity = bestVmg(
+          *relativeWindBearings, m_boatVelocities, windBearing.t, bearing);
+        double along = current.m_x.t * std::sin(bearing) +
+                       current.m_y.t * std::cos(bearing);
+        double cross = current.m_x.t * std::cos(bearing) -
+                       current.m_y.t * std::sin(bearing);
+        if (std::abs(cross) >= velocity) {
+            return false;
+        }
+        velocity_t sog(std::sqrt(velocity * velocity - cross * cross) + along);
+        if (sog <= velocity_t(0.)) {
+            return false;
+        }
 
-            neighbors.push_back(m_stateFactory->build(
-              newPos, it->time() + timeOffset, it->discretState()));
+        meter_t step = std::min(m_moveDistance, remaining);
+        NVector next = step < remaining
+                         ? position.destination(radian_t(bearing), step)
+                         : target;
+        time_t nextTime = arrival + step / sog;
+        if (pruned(position, next, arrival, nextTime)) {
+            return false;
         }
+        position = next;
+        arrival = nextTime;
+        remaining = remaining - step;
     }
+    return true;
 }
 
 }
@@ -17,7 +17,13 @@
 #pragma once
 
 // includes
+// std
+#include <vector>
+
 // tiny_sea
+#include <tiny_sea/core/compiled_boat_velocity_table.h>
+#include <tiny_sea/core/n_vector.h>
+#include <tiny_sea/core/wind_vector.h>
 #include <tiny_sea/fwd.h>
 #include <tiny_sea/gsp/close_list.h>
 #include <tiny_sea/gsp/state.h>
@@ -33,19 +39,167 @@ public:
                     const TimeWorldMap* timeWorldMap,
                     const BoatVelocityTable* speedStable,
                     meter_t moveDistance)
+      : NeighborsFinder(state_factory,
+                        timeWorldMap,
+                        CompiledBoatVelocityTable(*speedStable),
+                        moveDistance)
+    {}
+
+    /*! Use an already compiled boat velocity table.
+     * This allow to use a resampled table with more relative wind bearings.
+     */
+    NeighborsFinder(const StateFactory* state_factory,
+                    const TimeWorldMap* timeWorldMap,
+                    const CompiledBoatVelocityTable& speedTable,
+                    meter_t moveDistance)
       : m_stateFactory(state_factory)
       , m_timeWorldMap(timeWorldMap)
-      , m_speedTable(speedStable)
+      , m_speedTable(speedTable)
       , m_moveDistance(moveDistance)
     {}
 
+    /*! Use precomputed boat velocities instead of interpolating the wind
+     * and the boat velocity table.
+     * \param raster Must be built from the same TimeWorldMap, nullptr to
+     * disable it.
+     */
+    void setBoatVelocityRaster(const BoatVelocityRaster* raster) noexcept
+    {
+        m_boatVelocityRaster = raster;
+    }
+
+    /*! Sample the world map through a cache instead of interpolating it at
+     * each search.
+     * \param cache Must sample the same TimeWorldMap, nullptr to disable it.
+     * Not used when a BoatVelocityRaster is set.
+     */
+    void setSampleCache(WorldMapSampleCache* cache) noexcept
+    {
+        m_sampleCache = cache;
+    }
+
+    /*! Blend the two slices around the state time instead of taking the
+     * slice at the state time.
+     * Wind is sampled with TimeWorldMap::safeInterpolated(time, lat, lon),
+     * the sample cache is not used. Not used when a BoatVelocityRaster is
+     * set.
+     */
+    void setTimeInterpolation(bool enable) noexcept
+    {
+        m_timeInterpolation = enable;
+    }
+
+    /*! Prune moves crossing a blocked pixel before they are built.
+     * The static neighbor is always kept.
+     * \param mask nullptr to disable it.
+     */
+    void setLandMask(const LandMask* mask) noexcept { m_landMask = mask; }
+
+    /*! Prune moves crossing a coastline or an exclusion polygon edge.
+     * \param index nullptr to disable it.
+     */
+    void setEdgeIndex(const EdgeIndex* index) noexcept { m_edgeIndex = index; }
+
+    /*! Prune moves crossing, starting or ending in a zone active during the
+     * move time interval. Waiting in a zone activating is also pruned.
+     * \param index Must use the TimeWorldMap time space, nullptr to disable
+     * it.
+     */
+    void setTimeObstacleIndex(const TimeObstacleIndex* index) noexcept
+    {
+        m_timeObstacleIndex = index;
+    }
+
+    /*! Add a tidal current evaluated at the state time and position to the
+     * gridded current.
+     * \param grid nullptr to disable it.
+     */
+    void setTidalCurrentGrid(const TidalCurrentGrid* grid) noexcept
+    {
+        m_tidalCurrentGrid = grid;
+    }
+
+    /*! Prune moves ending outside of a corridor.
+     * The static neighbor is always kept.
+     * \param corridor nullptr to disable it.
+     */
+    void setCorridor(const Corridor* corridor) noexcept
+    {
+        m_corridor = corridor;
+    }
+
+    /*! Prune moves reaching a spatial cell at or after its earliest known
+     * arrival.
+     * Expanded states are recorded as arrivals. The static neighbor is
+     * always kept, waiting is what make a later arrival useless.
+     * The result is approximate, \see DominanceTable.
+     * \param table Must be cleared between two searches, nullptr to disable
+     * it.
+     */
+    void setDominanceTable(DominanceTable* table) noexcept
+    {
+        m_dominanceTable = table;
+    }
+
+    /*! Add a direct great circle leg to the target from states closer than
+     * \p radius.
+     * The leg is simulated by steps of the move distance through the wind
+     * field and the polar, and must respect the other pruning rules. Its
+     * arrival time is continuous and its heuristic null, so the search end
+     * on it as soon as no state has a better f.
+     * \param radius meter_t(0.) to disable it.
+     */
+    void setDirectShot(meter_t radius) noexcept { m_directShotRadius = radius; }
+
     void search(CloseList::iterator it, std::vector<State>& neighbors) const;
 
+private:
+    /*! Sample the wind at \p position and \p time and fill
+     * m_boatVelocities.
+     * \param[out] relativeWindBearings Relative wind bearing of each
+     * m_boatVelocities value.
+     */
+    void sample(const NVector& position,
+                time_t time,
+                radian_t& windBearing,
+                WindVector& current,
+                const CompiledBoatVelocityTable::array_type*&
+                  relativeWindBearings) const;
+
+    /// \return true if a move from \p from to \p to is pruned
+    bool pruned(const NVector& from,
+                const NVector& to,
+                time_t fromTime,
+                time_t toTime) const;
+
+    /*! Simulate a direct leg from \p state to the target.
+     * \param[out] arrival Arrival time on the target.
+     * \return false if the leg is not feasible
+     */
+    bool directShot(const State& state, time_t& arrival) const;
+
 private:
     const StateFactory* m_stateFactory;
     const TimeWorldMap* m_timeWorldMap;
-    const BoatVelocityTable* m_speedTable;
+    CompiledBoatVelocityTable m_speedTable;
     meter_t m_moveDistance;
+    const BoatVelocityRaster* m_boatVelocityRaster = nullptr;
+    WorldMapSampleCache* m_sampleCache = nullptr;
+    bool m_timeInterpolation = false;
+    const LandMask* m_landMask = nullptr;
+    const EdgeIndex* m_edgeIndex = nullptr;
+    const TimeObstacleIndex* m_timeObstacleIndex = nullptr;
+    const TidalCurrentGrid* m_tidalCurrentGrid = nullptr;
+    const Corridor* m_corridor = nullptr;
+    DominanceTable* m_dominanceTable = nullptr;
+    meter_t m_directShotRadius = meter_t(0.);
+
+    /// Boat velocities buffer, avoid an allocation at each search
+    mutable CompiledBoatVelocityTable::array_type m_boatVelocities;
+    /// Moving bearings, velocities and destinations buffers
+    mutable std::vector<radian_t> m_targetBearings;
+    mutable std::vector<velocity_t> m_targetVelocities;
+    mutable std::vector<NVector> m_targetPositions;
 };
 
 }
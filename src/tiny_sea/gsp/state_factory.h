@@ -18,12 +18,14 @@
 
 // includes
 // std
+#include <algorithm>
 #include <chrono>
 #include <tuple>
 
 // tiny_sea
 #include <tiny_sea/core/n_vector.h>
 #include <tiny_sea/core/units.h>
+#include <tiny_sea/gsp/heuristic.h>
 #include <tiny_sea/gsp/state.h>
 
 namespace tiny_sea {
@@ -40,6 +42,11 @@ public:
      * cost. \param earthRadius Earth radius, use to compute the heuristic.
      * \param targetPas Target position, use to compute the heuristic.
      * \param maxVelocity Maximum velocity, use to computeHeuristic.
+     * \warning \p maxVelocity must bound the speed over ground: the boat
+     * maximum velocity plus TimeWorldMap::maxCurrentVelocity and
+     * TidalCurrentGrid::maxSpeedBound when the NeighborsFinder add currents.
+     * A smaller value overestimate the heuristic and the route is not
+     * optimal.
      */
     StateFactory(time_t discretTime,
                  meter_t discretDistance,
@@ -103,9 +110,25 @@ public:
         return build(position, fromChrono(time));
     }
 
+    const NVector& targetPosition() const noexcept { return m_targetPos; }
+
     meter_t distanceToTarget(const State& state) const
     {
-        return meter_t(state.h().t * m_maxVelocity.t);
+        return state.position().distance(m_targetPos);
+    }
+
+    /*! Tighten the heuristic with a precomputed policy (HeuristicField,
+     * LandmarkHeuristic, ...).
+     * The heuristic is the maximum of the policy and of the distance / max
+     * velocity bound.
+     * \param heuristic Must be computed for the same target, nullptr to
+     * disable it. Must outlive the factory.
+     * \warning A policy built on a VelocityLattice must be given the
+     * TidalCurrentGrid set on the NeighborsFinder, else it can overestimate.
+     */
+    void setHeuristic(const Heuristic* heuristic) noexcept
+    {
+        m_heuristic = heuristic;
     }
 
 private:
@@ -125,7 +148,11 @@ private:
     cost_t computeHeuristic(const NVector& position) const
     {
         auto dist = position.distance(m_targetPos);
-        return cost_t((dist / m_maxVelocity).t);
+        cost_t h((dist / m_maxVelocity).t);
+        if (m_heuristic) {
+            h = std::max(h, m_heuristic->heuristic(position));
+        }
+        return h;
     }
 
 private:
@@ -135,6 +162,7 @@ private:
     meter_t m_earthRadius;
     NVector m_targetPos;
     velocity_t m_maxVelocity;
+    const Heuristic* m_heuristic = nullptr;
 };
 
 }
@@ -0,0 +1,284 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// associated header
+#include <tiny_sea/gsp/velocity_lattice.h>
+
+// includes
+// std
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+
+// tiny_sea
+#include <tiny_sea/core/compiled_boat_velocity_table.h>
+#include <tiny_sea/core/exception.h>
+#include <tiny_sea/core/tidal_current_grid.h>
+#include <tiny_sea/core/world_map.h>
+
+namespace tiny_sea {
+
+namespace gsp {
+
+namespace {
+
+/// Best boat velocity for all wind velocities up to each table column
+std::vector<double>
+bestVelocities(const CompiledBoatVelocityTable& speedTable)
+{
+    const auto& values = speedTable.values();
+    std::vector<double> best(std::size_t(values.cols()));
+    double velocity = 0.;
+    for (Eigen::Index c = 0; c < values.cols(); ++c) {
+        velocity = std::max(velocity, values.col(c).maxCoeff());
+        best[std::size_t(c)] = velocity;
+    }
+    return best;
+}
+
+/// Inclusive node range of \p space covering [\p min, \p max]
+template<typename Space>
+std::pair<std::size_t, std::size_t>
+nodeRange(const Space& space, double min, double max) noexcept
+{
+    double last = double(space.nrPoints() - 1);
+    double first_node = std::floor((min - space.start().t) / space.delta().t);
+    double last_node = std::ceil((max - space.start().t) / space.delta().t);
+    return std::make_pair(std::size_t(std::clamp(first_node, 0., last)),
+                          std::size_t(std::clamp(last_node, 0., last)));
+}
+
+}
+
+VelocityLattice::VelocityLattice(const TimeWorldMap& timeWorldMap,
+                                 const CompiledBoatVelocityTable& speedTable,
+                                 const LinearSpace<latitude_t>& latSpace,
+                                 const LinearSpace<longitude_t>& lonSpace,
+                                 const TidalCurrentGrid* tidalCurrentGrid)
+  : m_latSpace(latSpace)
+  , m_lonSpace(lonSpace)
+  , m_maxVelocity(0.)
+{
+    std::size_t nx = latSpace.nrPoints();
+    std::size_t ny = lonSpace.nrPoints();
+    if (nx < 2 || ny < 2) {
+        throw Exception("Lattice needs at least 2x2 nodes");
+    }
+
+    auto best = bestVelocities(speedTable);
+    const auto& windSpace = speedTable.windVelocitySpace();
+    m_cellVelocities.assign((nx - 1) * (ny - 1), 0.);
+
+    const WorldMap::grid_type* previous = nullptr;
+    std::vector<double> bounds;
+    CompiledBoatVelocityTable::array_type velocities;
+    for (const auto& worldMap : timeWorldMap.values()) {
+        // Last slice share the grid of the previous one
+        if (&worldMap.grid() == previous) {
+            continue;
+        }
+        previous = &worldMap.grid();
+
+        // Speed upper bound of each world map node
+        const auto& wLat = worldMap.latSpace();
+        const auto& wLon = worldMap.lonSpace();
+        bounds.resize(wLat.nrPoints() * wLon.nrPoints());
+        for (std::size_t lon = 0; lon < wLon.nrPoints(); ++lon) {
+            for (std::size_t lat = 0; lat < wLat.nrPoints(); ++lat) {
+                auto data = worldMap(lat, lon);
+                // Boat velocities are linear between two table columns, so
+                // their maximum is on a column or on the node wind
+                auto res = windSpace.safeInterpolationWeight(data.windVelocity);
+                speedTable.velocities(data.windVelocity, velocities);
+                double bound =
+                  std::max(best[res.index], velocities.maxCoeff()) +
+                  data.current.velocity().t;
+                bounds[lat + lon * wLat.nrPoints()] = bound;
+                m_maxVelocity = std::max(m_maxVelocity, velocity_t(bound));
+            }
+        }
+
+        // Interpolated winds are bounded by the nodes around them, so a
+        // cell is bounded by the world map nodes covering it
+        for (std::size_t y = 0; y < ny - 1; ++y) {
+            auto lonRange =
+              nodeRange(wLon, lonSpace.value(y).t, lonSpace.value(y + 1).t);
+            for (std::size_t x = 0; x < nx - 1; ++x) {
+                auto latRange = nodeRange(
+                  wLat, latSpace.value(x).t, latSpace.value(x + 1).t);
+                double& velocity = m_cellVelocities[x + y * (nx - 1)];
+                for (std::size_t lon = lonRange.first; lon <= lonRange.second;
+                     ++lon) {
+                    for (std::size_t lat = latRange.first;
+                         lat <= latRange.second;
+                         ++lat) {
+                        velocity = std::max(
+                          velocity, bounds[lat + lon * wLat.nrPoints()]);
+                    }
+                }
+            }
+        }
+    }
+
+    // Tidal currents are added to the world map current, a cell is bounded
+    // by the tidal nodes covering it
+    if (tidalCurrentGrid) {
+        const auto& tLat = tidalCurrentGrid->latSpace();
+        const auto& tLon = tidalCurrentGrid->lonSpace();
+        m_maxVelocity += tidalCurrentGrid->maxSpeedBound();
+
+        for (std::size_t y = 0; y < ny - 1; ++y) {
+            auto lonRange =
+              nodeRange(tLon, lonSpace.value(y).t, lonSpace.value(y + 1).t);
+            for (std::size_t x = 0; x < nx - 1; ++x) {
+                auto latRange = nodeRange(
+                  tLat, latSpace.value(x).t, latSpace.value(x + 1).t);
+                double tidal = 0.;
+                for (std::size_t lon = lonRange.first; lon <= lonRange.second;
+                     ++lon) {
+                    for (std::size_t lat = latRange.first;
+                         lat <= latRange.second;
+                         ++lat) {
+                        tidal = std::max(
+                          tidal, tidalCurrentGrid->speedBound(lat, lon).t);
+                    }
+                }
+                m_cellVelocities[x + y * (nx - 1)] += tidal;
+            }
+        }
+    }
+
+    // Widest angle between an axis and a cell diagonal
+    double cosMin =
+      std::min(std::cos(latSpace.start().t), std::cos(latSpace.stop().t));
+    double cosMax =
+      std::max(std::cos(latSpace.start().t), std::cos(latSpace.stop().t));
+    if (latSpace.start().t <= 0. && latSpace.stop().t >= 0.) {
+        cosMax = 1.;
+    }
+    double ratio = lonSpace.delta().t / latSpace.delta().t;
+    double theta =
+      std::max(std::atan(ratio * cosMax), std::atan2(1., ratio * cosMin));
+    m_lengthFactor = std::cos(theta / 2.);
+
+    m_positions.reserve(nx * ny);
+    for (std::size_t y = 0; y < ny; ++y) {
+        for (std::size_t x = 0; x < nx; ++x) {
+            m_positions.push_back(
+              NVector::fromLatLon(latSpace.value(x), lonSpace.value(y)));
+        }
+    }
+}
+
+std::vector<double>
+VelocityLattice::times(const std::vector<source_type>& sources,
+                       double scale) const
+{
+    std::size_t nx = m_latSpace.nrPoints();
+    std::size_t ny = m_lonSpace.nrPoints();
+    std::vector<double> res(nx * ny, std::numeric_limits<double>::infinity());
+
+    using item_type = std::pair<double, std::size_t>;
+    std::priority_queue<item_type,
+                        std::vector<item_type>,
+                        std::greater<item_type>>
+      queue;
+    for (const auto& source : sources) {
+        if (source.second < res[source.first]) {
+            res[source.first] = source.second;
+            queue.emplace(source.second, source.first);
+        }
+    }
+
+    while (!queue.empty()) {
+        auto item = queue.top();
+        queue.pop();
+        if (item.first > res[item.second]) {
+            continue;
+        }
+
+        std::size_t x = item.second % nx;
+        std::size_t y = item.second / nx;
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                if ((dx == 0 && dy == 0) || (dx < 0 && x == 0) ||
+                    (dy < 0 && y == 0) || (dx > 0 && x + 1 == nx) ||
+                    (dy > 0 && y + 1 == ny)) {
+                    continue;
+                }
+                std::size_t x2 = std::size_t(int(x) + dx);
+                std::size_t y2 = std::size_t(int(y) + dy);
+                std::size_t cx = std::min(x, x2);
+                std::size_t cy = std::min(y, y2);
+
+                // Fastest cell bordering the edge
+                double velocity = 0.;
+                if (dx != 0 && dy != 0) {
+                    velocity = cellVelocity(cx, cy).t;
+                } else if (dx != 0) {
+                    if (y > 0) {
+                        velocity = cellVelocity(cx, y - 1).t;
+                    }
+                    if (y + 1 < ny) {
+                        velocity = std::max(velocity, cellVelocity(cx, y).t);
+                    }
+                } else {
+                    if (x > 0) {
+                        velocity = cellVelocity(x - 1, cy).t;
+                    }
+                    if (x + 1 < nx) {
+                        velocity = std::max(velocity, cellVelocity(x, cy).t);
+                    }
+                }
+                if (velocity <= 0.) {
+                    continue;
+                }
+
+                std::size_t idx2 = node(x2, y2);
+                double time =
+                  item.first +
+                  scale *
+                    m_positions[item.second].distance(m_positions[idx2]).t /
+                    velocity;
+                if (time < res[idx2]) {
+                    res[idx2] = time;
+                    queue.emplace(time, idx2);
+                }
+            }
+        }
+    }
+    return res;
+}
+
+bool
+VelocityLattice::cellIndex(latitude_t lat,
+                           longitude_t lon,
+                           std::size_t& x,
+                           std::size_t& y) const noexcept
+{
+    if (!m_latSpace.inside(lat) || !m_lonSpace.inside(lon)) {
+        return false;
+    }
+    x = std::min(m_latSpace.index(lat), m_latSpace.nrPoints() - 2);
+    y = std::min(m_lonSpace.index(lon), m_lonSpace.nrPoints() - 2);
+    return true;
+}
+
+}
+
+}
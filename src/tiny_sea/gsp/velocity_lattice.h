@@ -0,0 +1,143 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+// includes
+// std
+#include <utility>
+#include <vector>
+
+// tiny_sea
+#include <tiny_sea/core/linear_space.h>
+#include <tiny_sea/core/n_vector.h>
+#include <tiny_sea/core/units.h>
+#include <tiny_sea/fwd.h>
+
+namespace tiny_sea {
+
+namespace gsp {
+
+/*! Coarse latitude and longitude lattice of boat speed upper bounds.
+ *
+ * Each lattice cell store an upper bound of the boat speed over ground in
+ * the cell for all the TimeWorldMap slices: the best boat velocity of the
+ * polar for all wind velocities up to the strongest wind of the world map
+ * nodes covering the cell, plus the strongest current. An optional
+ * TidalCurrentGrid add the tidal speed bound of its nodes covering the cell.
+ *
+ * Lattice edges link the 8 neighbors of a node, an edge use the fastest
+ * cell it border. Shortest lattice times are computed by a Dijkstra.
+ * Lattice paths are longer than great circle paths by at most
+ * 1 / lengthFactor(), lengthFactor() being cos(theta / 2) with theta the
+ * widest angle between an axis and a cell diagonal.
+ *
+ * \warning The lattice should cover the sailing area.
+ */
+class VelocityLattice
+{
+public:
+    /// Dijkstra source node index and its initial time
+    using source_type = std::pair<std::size_t, double>;
+
+public:
+    /*!
+     * \param latSpace Lattice latitude nodes, at least 2.
+     * \param lonSpace Lattice longitude nodes, at least 2.
+     * \param tidalCurrentGrid Tidal current added by the NeighborsFinder,
+     * nullptr if there is none.
+     * \throw Exception if the lattice is too small.
+     */
+    VelocityLattice(const TimeWorldMap& timeWorldMap,
+                    const CompiledBoatVelocityTable& speedTable,
+                    const LinearSpace<latitude_t>& latSpace,
+                    const LinearSpace<longitude_t>& lonSpace,
+                    const TidalCurrentGrid* tidalCurrentGrid = nullptr);
+
+    /*! Shortest lattice time from \p sources to all the nodes.
+     * \param sources Source nodes and their initial time.
+     * \param scale Edge times are multiplied by \p scale.
+     * \return Time of each node, infinity for unreachable nodes
+     */
+    std::vector<double> times(const std::vector<source_type>& sources,
+                              double scale) const;
+
+    /*! Cell containing (\p lat, \p lon).
+     * \return false if the position is outside the lattice
+     */
+    bool cellIndex(latitude_t lat,
+                   longitude_t lon,
+                   std::size_t& x,
+                   std::size_t& y) const noexcept;
+
+    /*! Speed upper bound of cell (\p x, \p y), between nodes x, x + 1 and
+     * y, y + 1.
+     * \warning \p x and \p y must be lower than the nodes number - 1.
+     */
+    velocity_t cellVelocity(std::size_t x, std::size_t y) const noexcept
+    {
+        return velocity_t(
+          m_cellVelocities[x + y * (m_latSpace.nrPoints() - 1)]);
+    }
+
+    /// Speed upper bound over all the world map and tidal nodes
+    velocity_t maxVelocity() const noexcept { return m_maxVelocity; }
+
+    /// Lattice to great circle length ratio lower bound
+    double lengthFactor() const noexcept { return m_lengthFactor; }
+
+    std::size_t nrNodes() const noexcept { return m_positions.size(); }
+
+    /// Node index of (\p x, \p y)
+    std::size_t node(std::size_t x, std::size_t y) const noexcept
+    {
+        return x + y * m_latSpace.nrPoints();
+    }
+
+    /// Node position
+    const NVector& position(std::size_t node) const noexcept
+    {
+        return m_positions[node];
+    }
+
+    const LinearSpace<latitude_t>& latSpace() const noexcept
+    {
+        return m_latSpace;
+    }
+
+    const LinearSpace<longitude_t>& lonSpace() const noexcept
+    {
+        return m_lonSpace;
+    }
+
+    /// Memory used by the cells in bytes
+    std::size_t memory() const noexcept
+    {
+        return m_cellVelocities.size() * sizeof(double);
+    }
+
+private:
+    LinearSpace<latitude_t> m_latSpace;
+    LinearSpace<longitude_t> m_lonSpace;
+    velocity_t m_maxVelocity;
+    double m_lengthFactor;
+    std::vector<double> m_cellVelocities;
+    std::vector<NVector> m_positions;
+};
+
+}
+
+}
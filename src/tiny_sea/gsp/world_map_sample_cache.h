@@ -0,0 +1,109 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+// includes
+// std
+#include <cmath>
+#include <unordered_map>
+
+// tiny_sea
+#include <tiny_sea/core/n_vector.h>
+#include <tiny_sea/core/numeric_constants.h>
+#include <tiny_sea/core/units.h>
+#include <tiny_sea/core/world_map.h>
+#include <tiny_sea/gsp/discret_state.h>
+
+namespace tiny_sea {
+
+namespace gsp {
+
+/*! Memoize TimeWorldMap samples.
+ * Positions are quantized in cubes of \p tolerance size in the NVector space,
+ * like StateFactory does for DiscretState. All positions of the same cube and
+ * time slice share the sample of the first position that was requested.
+ *
+ * Two positions in the same cube are at most tolerance * sqrt(3) away, so
+ * the sample error is bounded by the wind gradient on this distance.
+ */
+class WorldMapSampleCache
+{
+public:
+    /// (slice, x, y, z) key
+    using key_type = DiscretState;
+    using container_t =
+      std::unordered_map<key_type, WorldMapData, DiscretStateHash>;
+
+public:
+    /*!
+     * \param timeWorldMap World map to sample.
+     * \param tolerance Quantization size.
+     * \param earthRadius Earth radius, use to quantize positions.
+     */
+    WorldMapSampleCache(const TimeWorldMap* timeWorldMap,
+                        meter_t tolerance,
+                        meter_t earthRadius = meter_t(EARTH_RADIUS))
+      : m_timeWorldMap(timeWorldMap)
+      , m_scale((earthRadius / tolerance).t)
+    {}
+
+    /// \return WorldMapData of \p slice at \p position
+    WorldMapData sample(std::size_t slice, const NVector& position)
+    {
+        key_type key = std::make_tuple(
+          std::uint64_t(slice),
+          std::int64_t(std::floor(position.x() * m_scale)),
+          std::int64_t(std::floor(position.y() * m_scale)),
+          std::int64_t(std::floor(position.z() * m_scale)));
+
+        auto it = m_store.find(key);
+        if (it != m_store.end()) {
+            ++m_nrHit;
+            return it->second;
+        }
+
+        ++m_nrMiss;
+        const auto& latLon = position.toLatLon();
+        const auto& data = m_timeWorldMap->values()[slice].safeInterpolated(
+          latLon.first, latLon.second);
+        m_store.emplace(key, data);
+        return data;
+    }
+
+    /// Remove all samples and reset counters
+    void clear()
+    {
+        m_store.clear();
+        m_nrHit = 0;
+        m_nrMiss = 0;
+    }
+
+    std::size_t nrHit() const noexcept { return m_nrHit; }
+    std::size_t nrMiss() const noexcept { return m_nrMiss; }
+    std::size_t size() const noexcept { return m_store.size(); }
+
+private:
+    const TimeWorldMap* m_timeWorldMap;
+    double m_scale;
+    container_t m_store;
+    std::size_t m_nrHit = 0;
+    std::size_t m_nrMiss = 0;
+};
+
+}
+
+}
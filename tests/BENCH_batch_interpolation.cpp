@@ -0,0 +1,148 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// includes
+// std
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// GTest
+#include <gtest/gtest.h>
+
+// tiny_sea
+#include <tiny_sea/core/linear_grid.h>
+#include <tiny_sea/core/linear_list.h>
+#include <tiny_sea/core/world_map_grid.h>
+
+using namespace tiny_sea;
+
+namespace {
+
+const std::size_t NR_POINTS = 1023;
+const std::size_t NR_LOOKUPS = 4000000;
+
+/// \return Points by second of \p f called on NR_LOOKUPS points
+template<typename F>
+double
+pointsBySecond(F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return double(NR_LOOKUPS) /
+           std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+             .count();
+}
+
+void
+report(const std::string& name, double scalar, double batch)
+{
+    std::cout << name << " scalar: " << scalar * 1e-6
+              << " Mpoints/s batch: " << batch * 1e-6
+              << " Mpoints/s speedup: " << batch / scalar << "\n";
+}
+
+struct Points
+{
+    Points()
+      : lat(NR_LOOKUPS)
+      , lon(NR_LOOKUPS)
+    {
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<double> dist(0., double(NR_POINTS - 1));
+        for (std::size_t i = 0; i < NR_LOOKUPS; ++i) {
+            lat[i] = latitude_t(dist(gen));
+            lon[i] = longitude_t(dist(gen));
+        }
+    }
+
+    std::vector<latitude_t> lat;
+    std::vector<longitude_t> lon;
+};
+
+template<typename Grid, typename Value>
+void
+run(const std::string& name, const Grid& grid, const Points& points)
+{
+    std::vector<Value> scalarRes(NR_LOOKUPS);
+    std::vector<Value> batchRes(NR_LOOKUPS);
+    double scalar = pointsBySecond([&]() {
+        for (std::size_t i = 0; i < NR_LOOKUPS; ++i) {
+            scalarRes[i] = grid.safeInterpolated(points.lat[i], points.lon[i]);
+        }
+    });
+    double batch = pointsBySecond([&]() {
+        grid.safeInterpolated(
+          points.lat.data(), points.lon.data(), NR_LOOKUPS, batchRes.data());
+    });
+    report(name, scalar, batch);
+}
+
+}
+
+/// Scalar and batch bilinear interpolation on a 4 MB float grid
+TEST(BatchInterpolationBench, linear_grid)
+{
+    Points points;
+    auto xSpace = makeLinearSpace(latitude_t(0.), latitude_t(1.), NR_POINTS);
+    auto ySpace = makeLinearSpace(longitude_t(0.), longitude_t(1.), NR_POINTS);
+
+    LinearGridBuilder<latitude_t, longitude_t, float> floatBuilder(xSpace,
+                                                                   ySpace);
+    WorldMapGridBuilder worldBuilder(xSpace, ySpace);
+    for (std::size_t y = 0; y < NR_POINTS; ++y) {
+        for (std::size_t x = 0; x < NR_POINTS; ++x) {
+            double v = std::sin(0.01 * double(x)) + std::cos(0.013 * double(y));
+            floatBuilder(x, y) = float(v);
+            worldBuilder(x, y) = WorldMapData(radian_t(v), velocity_t(v + 2.));
+        }
+    }
+    run<LinearGrid<latitude_t, longitude_t, float>, float>(
+      "LinearGrid<float>", floatBuilder.build(), points);
+    run<WorldMapGrid, WorldMapData>(
+      "WorldMapGrid     ", worldBuilder.build(), points);
+}
+
+/// Scalar and batch linear interpolation of a boat velocity like list
+TEST(BatchInterpolationBench, linear_list)
+{
+    Points points;
+    LinearListBuilder<latitude_t, double> builder(
+      makeLinearSpace(latitude_t(0.), latitude_t(1.), NR_POINTS));
+    for (std::size_t x = 0; x < NR_POINTS; ++x) {
+        builder(x) = std::sin(0.01 * double(x));
+    }
+    auto list = builder.build();
+
+    std::vector<double> scalarRes(NR_LOOKUPS);
+    std::vector<double> batchRes(NR_LOOKUPS);
+    double scalar = pointsBySecond([&]() {
+        for (std::size_t i = 0; i < NR_LOOKUPS; ++i) {
+            scalarRes[i] = list.safeInterpolated(points.lat[i]);
+        }
+    });
+    double batch = pointsBySecond([&]() {
+        list.safeInterpolated(points.lat.data(), NR_LOOKUPS, batchRes.data());
+    });
+    report("LinearList<double>", scalar, batch);
+    for (std::size_t i = 0; i < NR_LOOKUPS; i += 1000) {
+        EXPECT_NEAR(scalarRes[i], batchRes[i], 1e-9);
+    }
+}
@@ -0,0 +1,100 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// includes
+// std
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// GTest
+#include <gtest/gtest.h>
+
+// tiny_sea
+#include <tiny_sea/core/edge_index.h>
+
+using namespace tiny_sea;
+
+namespace {
+
+const std::size_t NR_EDGES = 1000000;
+const std::size_t NR_MOVES = 2000000;
+const meter_t MOVE_DISTANCE(1000.);
+
+/// Coast latitude at \p lon
+double
+coastLat(double lon)
+{
+    return 0.7 + 0.05 * std::sin(20. * lon);
+}
+
+}
+
+/// Moves near a 1M edges coastline of about 6 m edges
+TEST(EdgeIndexBench, coastline)
+{
+    std::mt19937 gen(42);
+    std::normal_distribution<double> noise(0., 2e-6);
+    std::vector<NVector> coast;
+    coast.reserve(NR_EDGES + 1);
+    for (std::size_t i = 0; i <= NR_EDGES; ++i) {
+        double lon = -0.5 + double(i) / double(NR_EDGES);
+        coast.push_back(NVector::fromLatLon(
+          latitude_t(coastLat(lon) + noise(gen)), longitude_t(lon)));
+    }
+
+    std::uniform_real_distribution<double> lonDist(-0.49, 0.49);
+    std::uniform_real_distribution<double> latDist(-0.002, 0.002);
+    std::uniform_real_distribution<double> bearingDist(-PI, PI);
+    std::vector<NVector> from, to;
+    for (std::size_t i = 0; i < NR_MOVES; ++i) {
+        double lon = lonDist(gen);
+        from.push_back(NVector::fromLatLon(
+          latitude_t(coastLat(lon) + latDist(gen)), longitude_t(lon)));
+        to.push_back(
+          from.back().destination(radian_t(bearingDist(gen)), MOVE_DISTANCE));
+    }
+
+    for (double bucketSize : { 5e-5, 1e-4, 2e-4 }) {
+        EdgeIndexBuilder builder{ radian_t(bucketSize) };
+        builder.addPolyline(coast);
+        auto buildStart = std::chrono::steady_clock::now();
+        EdgeIndex index = builder.build();
+        double buildTime = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - buildStart)
+                             .count();
+
+        std::size_t nrCrossed = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < NR_MOVES; ++i) {
+            nrCrossed += index.crossed(from[i], to[i]);
+        }
+        double time = std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+
+        std::cout << "bucket " << bucketSize << " rad: "
+                  << time / double(NR_MOVES) * 1e9 << " ns/move, "
+                  << double(nrCrossed) / double(NR_MOVES) * 100.
+                  << " % crossed, "
+                  << double(index.nrBucketEdges()) / double(NR_EDGES)
+                  << " copies/edge, " << index.memory() / (1024 * 1024)
+                  << " MB, build " << buildTime << " s\n";
+        EXPECT_GT(nrCrossed, 0);
+    }
+}
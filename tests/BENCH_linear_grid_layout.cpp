@@ -0,0 +1,149 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// includes
+// std
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// GTest
+#include <gtest/gtest.h>
+
+// tiny_sea
+#include <tiny_sea/core/linear_grid.h>
+#include <tiny_sea/core/numeric_constants.h>
+
+using namespace tiny_sea;
+
+namespace {
+
+const std::size_t NR_POINTS = 2047;
+const std::size_t NR_LOOKUPS = 4000000;
+
+using point_type = std::pair<latitude_t, longitude_t>;
+
+template<typename Layout>
+using grid_type = LinearGrid<latitude_t,
+                             longitude_t,
+                             float,
+                             NumericInterpolator<float>,
+                             Layout>;
+
+template<typename Layout>
+grid_type<Layout>
+makeGrid()
+{
+    LinearGridBuilder<latitude_t,
+                      longitude_t,
+                      float,
+                      NumericInterpolator<float>,
+                      Layout>
+      builder(makeLinearSpace(latitude_t(0.), latitude_t(1.), NR_POINTS),
+              makeLinearSpace(longitude_t(0.), longitude_t(1.), NR_POINTS));
+    for (std::size_t y = 0; y < NR_POINTS; ++y) {
+        for (std::size_t x = 0; x < NR_POINTS; ++x) {
+            builder(x, y) = float(std::sin(0.01 * double(x)) +
+                                  std::cos(0.013 * double(y)));
+        }
+    }
+    return builder.build();
+}
+
+/// Uniformly distributed points
+std::vector<point_type>
+randomPoints()
+{
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(0., double(NR_POINTS - 1));
+    std::vector<point_type> points(NR_LOOKUPS);
+    for (auto& p : points) {
+        p = point_type(latitude_t(dist(gen)), longitude_t(dist(gen)));
+    }
+    return points;
+}
+
+/*! Points of a search frontier moving diagonally across the grid.
+ * Each step expand 64 bearings on a ring around a center that move along
+ * the grid diagonal.
+ */
+std::vector<point_type>
+frontierPoints()
+{
+    const std::size_t NR_BEARINGS = 64;
+    std::vector<point_type> points;
+    points.reserve(NR_LOOKUPS);
+    for (std::size_t step = 0; points.size() < NR_LOOKUPS; ++step) {
+        double center = double((step / 8) % (NR_POINTS - 1));
+        double radius = 2. + double(step % 8) * 4.;
+        for (std::size_t b = 0; b < NR_BEARINGS && points.size() < NR_LOOKUPS;
+             ++b) {
+            double angle = 2. * PI * double(b) / double(NR_BEARINGS);
+            points.emplace_back(latitude_t(center + radius * std::cos(angle)),
+                                longitude_t(center + radius * std::sin(angle)));
+        }
+    }
+    return points;
+}
+
+template<typename Layout>
+double
+run(const std::string& name,
+    const std::vector<point_type>& random,
+    const std::vector<point_type>& frontier)
+{
+    auto grid = makeGrid<Layout>();
+    auto measure = [&](const std::vector<point_type>& points, double& sum) {
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& p : points) {
+            sum += double(grid.safeInterpolated(p.first, p.second));
+        }
+        return std::chrono::duration<double, std::nano>(
+                 std::chrono::steady_clock::now() - start)
+                 .count() /
+               double(points.size());
+    };
+
+    double sum = 0.;
+    double randomTime = measure(random, sum);
+    double frontierTime = measure(frontier, sum);
+    std::cout << name << " memory: " << grid.values().size() * sizeof(float)
+              << " B random: " << randomTime
+              << " ns/lookup frontier: " << frontierTime << " ns/lookup\n";
+    return sum;
+}
+
+}
+
+/// Bilinear lookup cost of each LinearGrid layout on a 16 MB float grid
+TEST(LinearGridLayoutBench, lookup)
+{
+    auto random = randomPoints();
+    auto frontier = frontierPoints();
+
+    double rowMajor = run<RowMajorLayout>("RowMajor   ", random, frontier);
+    double blocked8 = run<BlockedLayout<8>>("Blocked<8> ", random, frontier);
+    double blocked16 =
+      run<BlockedLayout<16>>("Blocked<16>", random, frontier);
+    double morton = run<MortonLayout>("Morton     ", random, frontier);
+
+    EXPECT_EQ(rowMajor, blocked8);
+    EXPECT_EQ(rowMajor, blocked16);
+    EXPECT_EQ(rowMajor, morton);
+}
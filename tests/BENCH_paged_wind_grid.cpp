@@ -0,0 +1,140 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// includes
+// std
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+
+// GTest
+#include <gtest/gtest.h>
+
+// tiny_sea
+#include <tiny_sea/core/forecast_file.h>
+#include <tiny_sea/core/paged_wind_grid.h>
+#include <tiny_sea/core/wind_grid.h>
+#include <tiny_sea/core/world_map.h>
+
+using namespace tiny_sea;
+
+namespace {
+
+const double DEG_TO_RAD = PI / 180.;
+const std::size_t NR_SLICES = 8;
+const std::size_t NR_SAMPLES = 100000;
+
+double
+elapsed(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+/// Sample a 3x3 degrees region in all slices
+double
+sampleRegion(const TimeWorldMap& timeWorldMap)
+{
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> lat(45. * DEG_TO_RAD,
+                                               48. * DEG_TO_RAD);
+    std::uniform_real_distribution<double> lon(-6. * DEG_TO_RAD,
+                                               -3. * DEG_TO_RAD);
+    double sum = 0.;
+    for (std::size_t i = 0; i < NR_SAMPLES; ++i) {
+        const auto& worldMap = timeWorldMap.values()[i % NR_SLICES];
+        sum += worldMap.safeInterpolated(latitude_t(lat(gen)),
+                                         longitude_t(lon(gen)))
+                 .windVelocity.t;
+    }
+    return sum;
+}
+
+}
+
+/*! Time to first samples and resident memory of a regional query on a 0.5
+ * degree global forecast, fully loaded in memory or paged.
+ */
+TEST(PagedWindGridBench, regional)
+{
+    const std::size_t NR_LAT = 361;
+    const std::size_t NR_LON = 720;
+    std::string path = testing::TempDir() + "tiny_sea_paged_bench.tsf";
+    {
+        ForecastWriter writer(
+          path,
+          makeLinearSpace(tiny_sea::time_t(0.),
+                          tiny_sea::time_t(3. * 3600.),
+                          NR_SLICES),
+          makeLinearSpace(latitude_t(-90. * DEG_TO_RAD),
+                          latitude_t(0.5 * DEG_TO_RAD),
+                          NR_LAT),
+          makeLinearSpace(longitude_t(-180. * DEG_TO_RAD),
+                          longitude_t(0.5 * DEG_TO_RAD),
+                          NR_LON));
+        std::vector<float> u(NR_LAT * NR_LON), v(NR_LAT * NR_LON);
+        for (std::size_t t = 0; t < NR_SLICES; ++t) {
+            for (std::size_t i = 0; i < u.size(); ++i) {
+                u[i] = float(10. * std::sin(0.01 * double(i + t)));
+                v[i] = float(7. * std::cos(0.013 * double(i + 3 * t)));
+            }
+            writer.write(t, ForecastWriter::Component::U, u.data());
+            writer.write(t, ForecastWriter::Component::V, v.data());
+        }
+        writer.close();
+    }
+
+    // Full load: all planes are copied in memory
+    auto start = std::chrono::steady_clock::now();
+    auto mapped = mapForecast(path);
+    TimeWorldMapBuilder builder(mapped.xSpace());
+    std::size_t fullMemory = 0;
+    for (std::size_t t = 0; t < NR_SLICES; ++t) {
+        const auto& grid = std::get<WindGrid>(mapped.values()[t].grid());
+        WindGrid::plane_type u(grid.u(), grid.u() + grid.planeSize());
+        WindGrid::plane_type v(grid.v(), grid.v() + grid.planeSize());
+        builder.add(WorldMap(WindGrid(grid.xSpace(), grid.ySpace(), u, v)));
+        fullMemory += 2 * grid.planeSize() * sizeof(float);
+    }
+    auto full = builder.build();
+    double fullSum = sampleRegion(full);
+    double fullTime = elapsed(start);
+
+    // Paged: only touched tiles are loaded
+    start = std::chrono::steady_clock::now();
+    auto forecast = std::make_shared<PagedForecast>(path, 32);
+    auto paged = pagedTimeWorldMap(forecast);
+    double pagedSum = sampleRegion(paged);
+    double pagedTime = elapsed(start);
+    auto stats = forecast->stats();
+
+    std::cout << "Full  time: " << fullTime << " ms memory: " << fullMemory
+              << " B\n";
+    std::cout << "Paged time: " << pagedTime << " ms memory: " << stats.memory
+              << " B (" << double(fullMemory) / double(stats.memory)
+              << "x) hit: " << stats.nrHit << " miss: " << stats.nrMiss
+              << " load time: "
+              << std::chrono::duration<double, std::milli>(stats.loadTime)
+                   .count()
+              << " ms\n";
+
+    EXPECT_NEAR(fullSum, pagedSum, 1e-3 * std::abs(fullSum));
+    EXPECT_LT(stats.memory, fullMemory);
+    std::remove(path.c_str());
+}
@@ -0,0 +1,79 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// includes
+// std
+#include <iostream>
+
+// GTest
+#include <gtest/gtest.h>
+
+// tiny_sea
+#include <tiny_sea/core/quantized_wind_grid.h>
+#include <tiny_sea/core/wind_grid.h>
+
+using namespace tiny_sea;
+
+namespace {
+
+const double DEG_TO_RAD = PI / 180.;
+
+}
+
+/*! Report memory and accuracy of WindGrid and QuantizedWindGrid against a
+ * 0.25 degree WorldMapGrid of 40x60 degrees with a synthetic wind field.
+ */
+TEST(QuantizedWindGridBench, report)
+{
+    const std::size_t NR_LAT = 161;
+    const std::size_t NR_LON = 241;
+    WorldMapGridBuilder builder(
+      makeLinearSpace(latitude_t(20. * DEG_TO_RAD),
+                      latitude_t(0.25 * DEG_TO_RAD),
+                      NR_LAT),
+      makeLinearSpace(longitude_t(-40. * DEG_TO_RAD),
+                      longitude_t(0.25 * DEG_TO_RAD),
+                      NR_LON));
+    for (std::size_t lat = 0; lat < NR_LAT; ++lat) {
+        for (std::size_t lon = 0; lon < NR_LON; ++lon) {
+            double u = 12. * std::sin(0.05 * double(lat)) +
+                       3. * std::cos(0.11 * double(lon));
+            double v = 9. * std::cos(0.07 * double(lat + lon));
+            WindVector wind{ velocity_t(u), velocity_t(v) };
+            builder(lat, lon) = WorldMapData(wind.bearing(), wind.velocity());
+        }
+    }
+    WorldMapGrid worldGrid(builder.build());
+    WindGrid windGrid(worldGrid);
+    QuantizedWindGrid quantizedGrid(worldGrid);
+
+    std::size_t worldMemory = worldGrid.values().size() * sizeof(WorldMapData);
+    std::size_t windMemory = 2 * windGrid.planeSize() * sizeof(float);
+    auto windError = measureError(worldGrid, windGrid);
+    auto quantizedError = measureError(worldGrid, quantizedGrid);
+
+    std::cout << "WorldMapGrid      memory: " << worldMemory << " B\n";
+    std::cout << "WindGrid          memory: " << windMemory << " B ("
+              << double(worldMemory) / double(windMemory) << "x) max error "
+              << windError.maxVelocity << " m/s rms error "
+              << windError.rmsVelocity << " m/s\n";
+    std::cout << "QuantizedWindGrid memory: " << quantizedGrid.memory()
+              << " B (" << double(worldMemory) / double(quantizedGrid.memory())
+              << "x) max error " << quantizedError.maxVelocity
+              << " m/s rms error " << quantizedError.rmsVelocity << " m/s\n";
+
+    EXPECT_LT(quantizedError.maxVelocity, velocity_t(1e-3));
+}
@@ -0,0 +1,165 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// includes
+// GTest
+#include <gtest/gtest.h>
+
+// tiny_sea
+#include <tiny_sea/core/boat_velocity_raster.h>
+#include <tiny_sea/core/world_map.h>
+#include <tiny_sea/gsp/close_list.h>
+#include <tiny_sea/gsp/neighbors_finder.h>
+#include <tiny_sea/gsp/state_factory.h>
+
+using namespace tiny_sea;
+using namespace tiny_sea::gsp;
+
+/*! Create a word map with 3 time step and a wind velocity growing with
+ * latitude and longitude.
+ * Wind bearing is PI / 2 in the first time step and PI in the others.
+ */
+class BoatVelocityRasterFixture : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        TimeWorldMapBuilder timeWorldMapBuilder(
+          makeLinearSpace(fromChrono(std::chrono::seconds(0)),
+                          fromChrono(std::chrono::hours(1)),
+                          3));
+
+        WorldMapGridBuilder gridBuilder(
+          makeLinearSpace(latitude_t(0.), latitude_t(PI / 16.), 5),
+          makeLinearSpace(longitude_t(0.), longitude_t(PI / 16.), 4));
+
+        for (std::size_t i = 0; i < 3; ++i) {
+            for (std::size_t lat = 0; lat < 5; ++lat) {
+                for (std::size_t lon = 0; lon < 4; ++lon) {
+                    gridBuilder(lat, lon) = WorldMapData(
+                      radian_t(i == 0 ? PI / 2. : PI),
+                      velocity_t(double(i + lat + lon) * 1.5));
+                }
+            }
+            timeWorldMapBuilder.add(WorldMap(gridBuilder.build()));
+        }
+        m_timeWorldMap.reset(new TimeWorldMap(timeWorldMapBuilder.build()));
+
+        BoatVelocityTableBuilder velocityTableBuilder(
+          makeLinearSpace(velocity_t(0.), velocity_t(10.), 3));
+        velocityTableBuilder.addSymetric(
+          radian_t(PI / 4.),
+          { velocity_t(0.), velocity_t(5.), velocity_t(0.) });
+        velocityTableBuilder.add(
+          radian_t(PI), { velocity_t(0.), velocity_t(3.), velocity_t(4.) });
+        m_boatVelocityTable.reset(
+          new BoatVelocityTable(velocityTableBuilder.build()));
+        m_speedTable.reset(
+          new CompiledBoatVelocityTable(*m_boatVelocityTable));
+    }
+
+    std::unique_ptr<TimeWorldMap> m_timeWorldMap;
+    std::unique_ptr<BoatVelocityTable> m_boatVelocityTable;
+    std::unique_ptr<CompiledBoatVelocityTable> m_speedTable;
+};
+
+/*! Raster values on grid nodes must be the same than the boat velocity
+ * table applied on the node wind.
+ */
+TEST_F(BoatVelocityRasterFixture, TEST_nodes)
+{
+    BoatVelocityRaster raster(*m_timeWorldMap, *m_speedTable, 2);
+    ASSERT_EQ(raster.nrSlices(), 3);
+    ASSERT_EQ(raster.nrBearings(), 3);
+    EXPECT_EQ(raster.memory(), 3 * (6 * 5) * (3 + 2) * sizeof(float));
+
+    CompiledBoatVelocityTable::array_type expected;
+    CompiledBoatVelocityTable::array_type res;
+    radian_t windBearing;
+    for (std::size_t i = 0; i < 3; ++i) {
+        const auto& grid = m_timeWorldMap->values()[i].worldGrid();
+        for (std::size_t lat = 0; lat < 5; ++lat) {
+            for (std::size_t lon = 0; lon < 4; ++lon) {
+                auto data = grid(lat, lon);
+                m_speedTable->velocities(data.windVelocity, expected);
+                raster.interpolated(i,
+                                    grid.xSpace().value(lat),
+                                    grid.ySpace().value(lon),
+                                    windBearing,
+                                    res);
+                EXPECT_NEAR(windBearing.t, data.windBearing.t, 1e-6);
+                ASSERT_EQ(res.size(), expected.size());
+                EXPECT_TRUE(res.isApprox(expected, 1e-6));
+            }
+        }
+    }
+}
+
+/*! Between nodes, boat velocities are bilinearly interpolated
+ */
+TEST_F(BoatVelocityRasterFixture, TEST_interpolated)
+{
+    BoatVelocityRaster raster(*m_timeWorldMap, *m_speedTable);
+
+    // Wind velocity is 0. and 1.5 on (0, 0) and (0, 1) nodes
+    CompiledBoatVelocityTable::array_type res;
+    radian_t windBearing;
+    raster.interpolated(
+      0, latitude_t(0.), longitude_t(PI / 32.), windBearing, res);
+    EXPECT_NEAR(windBearing.t, PI / 2., 1e-6);
+    EXPECT_NEAR(res(0), 0.75 / 2., 1e-6);
+    EXPECT_NEAR(res(2), 0.45 / 2., 1e-6);
+
+    // Clamped outside the grid
+    raster.interpolated(
+      2, latitude_t(-1.), longitude_t(-1.), windBearing, res);
+    EXPECT_NEAR(res(0), 1.5, 1e-6);
+}
+
+/*! NeighborsFinder must find the same neighbors with and without the raster
+ * on grid nodes
+ */
+TEST_F(BoatVelocityRasterFixture, TEST_neighbors_finder)
+{
+    BoatVelocityRaster raster(*m_timeWorldMap, *m_speedTable);
+    NVector target = NVector::fromLatLon(latitude_t(0.), longitude_t(0.));
+    StateFactory factory(std::chrono::minutes(10),
+                         meter_t(50.),
+                         std::chrono::seconds(0),
+                         meter_t(EARTH_RADIUS),
+                         target,
+                         m_boatVelocityTable->maxVelocity());
+    NeighborsFinder finder(
+      &factory, m_timeWorldMap.get(), m_boatVelocityTable.get(), meter_t(100));
+
+    CloseList closeList;
+    auto it = closeList.insert(factory.build(
+      NVector::fromLatLon(latitude_t(PI / 8.), longitude_t(PI / 16.)),
+      std::chrono::hours(1)));
+
+    std::vector<State> expected;
+    finder.search(it.first, expected);
+
+    std::vector<State> res;
+    finder.setBoatVelocityRaster(&raster);
+    finder.search(it.first, res);
+
+    ASSERT_EQ(res.size(), expected.size());
+    for (std::size_t i = 0; i < res.size(); ++i) {
+        EXPECT_LT(res[i].position().distance(expected[i].position()).t, 1e-3);
+        EXPECT_NEAR(res[i].time().t, expected[i].time().t, 1e-3);
+    }
+}
@@ -0,0 +1,109 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// includes
+// GTest
+#include <gtest/gtest.h>
+
+// tiny_sea
+#include <tiny_sea/core/compiled_boat_velocity_table.h>
+
+using namespace tiny_sea;
+
+/*! Boat velocity table with 3 wind velocities and 4 bearings
+ * wind velocity :   0.        5.     10.
+ * bearing PI/4  :   0.        2.     3.
+ * bearing PI/2  :   0.        4.     6.
+ * bearing PI    :   0.        3.     5.
+ * bearing 7PI/4 :   0.        2.     3.
+ */
+class CompiledBoatVelocityTableFixture : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        BoatVelocityTableBuilder builder(
+          makeLinearSpace(velocity_t(0.), velocity_t(5.), 3));
+        builder.addSymetric(radian_t(PI / 4.),
+                            { velocity_t(0.), velocity_t(2.), velocity_t(3.) });
+        builder.add(radian_t(PI / 2.),
+                    { velocity_t(0.), velocity_t(4.), velocity_t(6.) });
+        builder.add(radian_t(PI),
+                    { velocity_t(0.), velocity_t(3.), velocity_t(5.) });
+        m_table.reset(new BoatVelocityTable(builder.build()));
+    }
+
+    std::unique_ptr<BoatVelocityTable> m_table;
+};
+
+/*! Compiled table must give the same result than the table
+ */
+TEST_F(CompiledBoatVelocityTableFixture, TEST_velocities)
+{
+    CompiledBoatVelocityTable compiled(*m_table);
+    ASSERT_EQ(compiled.nrBearings(), m_table->velocityTable().size());
+    EXPECT_EQ(compiled.maxVelocity(), m_table->maxVelocity());
+
+    CompiledBoatVelocityTable::array_type res;
+    for (double wind : { -1., 0., 1.2, 5., 7.7, 10., 12. }) {
+        compiled.velocities(velocity_t(wind), res);
+        ASSERT_EQ(res.size(), compiled.nrBearings());
+        for (std::size_t i = 0; i < compiled.nrBearings(); ++i) {
+            const auto& boatVelocity = m_table->velocityTable()[i];
+            EXPECT_EQ(compiled.relativeWindBearings()(i),
+                      boatVelocity.relativeWindBearing.t);
+            double expected =
+              boatVelocity.windVelocityToBoatVelocity
+                .safeInterpolated(velocity_t(wind))
+                .t;
+            EXPECT_NEAR(res(i), expected, 1e-12);
+            EXPECT_NEAR(
+              compiled.velocity(i, velocity_t(wind)).t, expected, 1e-12);
+        }
+    }
+}
+
+/*! Resample the table on 8 bearings: 0, PI/4, PI/2, ..., 7PI/4
+ */
+TEST_F(CompiledBoatVelocityTableFixture, TEST_resampled)
+{
+    CompiledBoatVelocityTable compiled(*m_table, 8);
+    ASSERT_EQ(compiled.nrBearings(), 8);
+
+    CompiledBoatVelocityTable::array_type res;
+    compiled.velocities(velocity_t(10.), res);
+    for (std::size_t i = 0; i < 8; ++i) {
+        EXPECT_NEAR(compiled.relativeWindBearings()(i), i * PI / 4., 1e-12);
+    }
+    // 0 is between 7PI/4 and PI/4
+    EXPECT_NEAR(res(0), 3., 1e-12);
+    EXPECT_NEAR(res(1), 3., 1e-12);
+    EXPECT_NEAR(res(2), 6., 1e-12);
+    // 3PI/4 is between PI/2 and PI
+    EXPECT_NEAR(res(3), 5.5, 1e-12);
+    EXPECT_NEAR(res(4), 5., 1e-12);
+    // 5PI/4 is between PI and 7PI/4
+    EXPECT_NEAR(res(5), 5. - 2. / 3., 1e-12);
+    EXPECT_NEAR(res(6), 5. - 4. / 3., 1e-12);
+    EXPECT_NEAR(res(7), 3., 1e-12);
+}
+
+TEST(COMPILED_BOAT_VELOCITY_TABLE_TESTS, TEST_empty)
+{
+    BoatVelocityTableBuilder builder(
+      makeLinearSpace(velocity_t(0.), velocity_t(5.), 3));
+    EXPECT_THROW(CompiledBoatVelocityTable(builder.build()), Exception);
+}
@@ -0,0 +1,136 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// includes
+// std
+#include <cmath>
+#include <random>
+#include <vector>
+
+// GTest
+#include <gtest/gtest.h>
+
+// tiny_sea
+#include <tiny_sea/core/edge_index.h>
+
+using namespace tiny_sea;
+
+namespace {
+
+NVector
+pos(double lat, double lon)
+{
+    return NVector::fromLatLon(latitude_t(lat), longitude_t(lon));
+}
+
+/// Polygon approximating a circle of \p radius around (lat, lon)
+std::vector<NVector>
+circle(double lat, double lon, double radius, std::size_t size)
+{
+    std::vector<NVector> points;
+    for (std::size_t i = 0; i < size; ++i) {
+        double a = 2. * PI * double(i) / double(size);
+        points.push_back(
+          pos(lat + radius * std::cos(a), lon + radius * std::sin(a)));
+    }
+    return points;
+}
+
+}
+
+TEST(EDGE_INDEX_TESTS, TEST_edge)
+{
+    GreatCircleEdge edge(pos(0.5, 0.1), pos(0.5, 0.2));
+
+    // Cross in the middle
+    EXPECT_TRUE(
+      edge.crossed(pos(0.49, 0.15).toEigen(), pos(0.51, 0.15).toEigen()));
+    EXPECT_TRUE(
+      edge.crossed(pos(0.51, 0.12).toEigen(), pos(0.49, 0.18).toEigen()));
+    // Cross the edge great circle outside of the edge
+    EXPECT_FALSE(
+      edge.crossed(pos(0.49, 0.25).toEigen(), pos(0.51, 0.25).toEigen()));
+    // Don't reach the edge
+    EXPECT_FALSE(
+      edge.crossed(pos(0.49, 0.15).toEigen(), pos(0.495, 0.15).toEigen()));
+    // Cross the edge on the antipodal side
+    EXPECT_FALSE(
+      edge.crossed(pos(-0.49, 0.15 + PI).toEigen(),
+                   pos(-0.51, 0.15 + PI).toEigen()));
+}
+
+/*! Index a coastline and an exclusion zone, compare with a brute force test
+ * of all edges
+ */
+TEST(EDGE_INDEX_TESTS, TEST_index)
+{
+    EdgeIndexBuilder builder(radian_t(0.002));
+    std::vector<NVector> coast;
+    for (std::size_t i = 0; i <= 200; ++i) {
+        double lon = -0.1 + 0.001 * double(i);
+        coast.push_back(pos(0.7 + 0.005 * std::sin(40. * lon), lon));
+    }
+    builder.addPolyline(coast);
+    auto zone = circle(0.68, 0.02, 0.004, 32);
+    builder.addPolygon(zone);
+    EdgeIndex index = builder.build();
+    EXPECT_EQ(index.nrEdges(), 200 + 32);
+    EXPECT_GE(index.nrBucketEdges(), index.nrEdges());
+
+    std::vector<GreatCircleEdge> edges;
+    for (std::size_t i = 1; i < coast.size(); ++i) {
+        edges.emplace_back(coast[i - 1], coast[i]);
+    }
+    for (std::size_t i = 0; i < zone.size(); ++i) {
+        edges.emplace_back(zone[i], zone[(i + 1) % zone.size()]);
+    }
+
+    // Cross the coast, enter the zone, stay at sea
+    EXPECT_TRUE(index.crossed(pos(0.69, 0.), pos(0.71, 0.)));
+    EXPECT_TRUE(index.crossed(pos(0.68, 0.01), pos(0.68, 0.02)));
+    EXPECT_FALSE(index.crossed(pos(0.68, 0.02), pos(0.681, 0.021)));
+    EXPECT_FALSE(index.crossed(pos(0.69, -0.05), pos(0.69, -0.04)));
+    // Outside of the index
+    EXPECT_FALSE(index.crossed(pos(0.2, 0.), pos(0.21, 0.)));
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> latDist(0.66, 0.72);
+    std::uniform_real_distribution<double> lonDist(-0.12, 0.12);
+    std::uniform_real_distribution<double> stepDist(-0.005, 0.005);
+    std::size_t nrCrossed = 0;
+    for (int i = 0; i < 2000; ++i) {
+        double lat = latDist(gen);
+        double lon = lonDist(gen);
+        NVector from = pos(lat, lon);
+        NVector to = pos(lat + stepDist(gen), lon + stepDist(gen));
+
+        bool expected = false;
+        for (const auto& edge : edges) {
+            expected =
+              expected || edge.crossed(from.toEigen(), to.toEigen());
+        }
+        EXPECT_EQ(index.crossed(from, to), expected);
+        nrCrossed += expected;
+    }
+    EXPECT_GT(nrCrossed, 0);
+}
+
+TEST(EDGE_INDEX_TESTS, TEST_empty)
+{
+    EdgeIndex index = EdgeIndexBuilder(radian_t(0.01)).build();
+    EXPECT_EQ(index.nrEdges(), 0);
+    EXPECT_FALSE(index.crossed(pos(0.69, 0.), pos(0.71, 0.)));
+}
@@ -0,0 +1,298 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// includes
+// std
+#include <cstdio>
+#include <fstream>
+#include <limits>
+
+// GTest
+#include <gtest/gtest.h>
+
+// tiny_sea
+#include <tiny_sea/core/exception.h>
+#include <tiny_sea/core/forecast_file.h>
+#include <tiny_sea/core/wind_grid.h>
+#include <tiny_sea/core/world_map.h>
+
+using namespace tiny_sea;
+
+class ForecastFileFixture : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_path = testing::TempDir() + "tiny_sea_forecast.tsf";
+
+        auto latSpace = makeLinearSpace(latitude_t(2.), latitude_t(1.), 3);
+        auto lonSpace = makeLinearSpace(longitude_t(10.), longitude_t(1.), 2);
+        TimeWorldMapBuilder builder(m_timeSpace);
+        for (std::size_t t = 0; t < 2; ++t) {
+            WorldMapGridBuilder gridBuilder(latSpace, lonSpace);
+            for (std::size_t lat = 0; lat < 3; ++lat) {
+                for (std::size_t lon = 0; lon < 2; ++lon) {
+                    gridBuilder(lat, lon) = WorldMapData(
+                      radian_t(double(lat + lon + t) * PI / 4.),
+                      velocity_t(double(1 + lat + 2 * lon + 3 * t)));
+                }
+            }
+            builder.add(WorldMap(gridBuilder.build()));
+        }
+        m_timeWorldMap.reset(new TimeWorldMap(builder.build()));
+    }
+
+    void TearDown() override { std::remove(m_path.c_str()); }
+
+    std::string m_path;
+    LinearSpace<tiny_sea::time_t> m_timeSpace =
+      makeLinearSpace(tiny_sea::time_t(0.), tiny_sea::time_t(3600.), 2);
+    std::unique_ptr<TimeWorldMap> m_timeWorldMap;
+};
+
+TEST_F(ForecastFileFixture, TEST_header)
+{
+    auto header = ForecastHeader::make(m_timeSpace,
+                                       makeLinearSpace(
+                                         latitude_t(2.), latitude_t(1.), 3),
+                                       makeLinearSpace(
+                                         longitude_t(10.), longitude_t(1.), 2));
+    EXPECT_EQ(header.planeOffset % ForecastHeader::PLANE_ALIGNMENT, 0);
+    EXPECT_EQ(header.planeStride % ForecastHeader::PLANE_ALIGNMENT, 0);
+    EXPECT_GE(header.planeOffset, sizeof(ForecastHeader));
+    EXPECT_GE(header.planeStride, header.planeSize() * sizeof(float));
+    EXPECT_EQ(header.planeSize(), 12);
+    EXPECT_EQ(header.fileSize(), header.offset(2, 0));
+    EXPECT_EQ(header.latSpace().nrPoints(), 3);
+    EXPECT_EQ(header.lonSpace().start(), longitude_t(10.));
+    EXPECT_EQ(header.timeSpace().delta(), tiny_sea::time_t(3600.));
+}
+
+TEST_F(ForecastFileFixture, TEST_round_trip)
+{
+    writeForecast(m_path, *m_timeWorldMap);
+    auto mapped = mapForecast(m_path);
+
+    ASSERT_EQ(mapped.xSpace().nrPoints(), 2);
+    EXPECT_EQ(mapped.xSpace().start(), tiny_sea::time_t(0.));
+    EXPECT_EQ(mapped.xSpace().delta(0), tiny_sea::time_t(3600.));
+    ASSERT_EQ(mapped.values().size(), 3);
+
+    for (std::size_t t = 0; t < 2; ++t) {
+        const auto& expected = m_timeWorldMap->values()[t];
+        const auto& res = mapped.values()[t];
+        WindGrid windGrid(expected.worldGrid());
+        EXPECT_EQ(res.latSpace().nrPoints(), 3);
+        EXPECT_EQ(res.lonSpace().nrPoints(), 2);
+        for (double lat = 1.5; lat <= 4.5; lat += 0.25) {
+            for (double lon = 9.5; lon <= 11.5; lon += 0.25) {
+                auto e =
+                  windGrid.safeInterpolated(latitude_t(lat), longitude_t(lon));
+                auto r =
+                  res.safeInterpolated(latitude_t(lat), longitude_t(lon));
+                EXPECT_EQ(r.windBearing, e.windBearing);
+                EXPECT_EQ(r.windVelocity, e.windVelocity);
+            }
+        }
+    }
+
+    // Mapping stay alive after the source TimeWorldMap is destroyed
+    auto slice = mapped.values()[1];
+    mapped = mapForecast(m_path);
+    auto res = slice(2, 1);
+    auto expected = m_timeWorldMap->values()[1](2, 1);
+    EXPECT_NEAR(res.windVelocity.t, expected.windVelocity.t, 1e-5);
+}
+
+TEST_F(ForecastFileFixture, TEST_current)
+{
+    // A file without current planes refuse a WorldMap with current
+    const auto& worldMap = m_timeWorldMap->values()[0];
+    {
+        ForecastWriter writer(
+          m_path, m_timeSpace, worldMap.latSpace(), worldMap.lonSpace());
+        float u[] = { 1.f, 2.f, 3.f, 4.f, 5.f, 6.f };
+        EXPECT_THROW(writer.write(0, ForecastWriter::Component::CURRENT_U, u),
+                     Exception);
+        writer.write(0, worldMap);
+    }
+
+    TimeWorldMapBuilder builder(m_timeSpace);
+    for (std::size_t t = 0; t < 2; ++t) {
+        WorldMapGridBuilder gridBuilder(worldMap.latSpace(),
+                                        worldMap.lonSpace());
+        for (std::size_t lat = 0; lat < 3; ++lat) {
+            for (std::size_t lon = 0; lon < 2; ++lon) {
+                auto data = m_timeWorldMap->values()[t](lat, lon);
+                // Only one node of the last slice has a current
+                data.current = WindVector(
+                  velocity_t(t == 1 && lat == 2 ? 0.5 : 0.),
+                  velocity_t(t == 1 && lat == 2 ? -double(lon + 1) : 0.));
+                gridBuilder(lat, lon) = data;
+            }
+        }
+        builder.add(WorldMap(gridBuilder.build()));
+    }
+    auto withCurrent = builder.build();
+    {
+        ForecastWriter writer(
+          m_path, m_timeSpace, worldMap.latSpace(), worldMap.lonSpace());
+        EXPECT_THROW(writer.write(1, withCurrent.values()[1]), Exception);
+    }
+
+    writeForecast(m_path, withCurrent);
+    auto mapped = mapForecast(m_path);
+    for (std::size_t t = 0; t < 2; ++t) {
+        const auto& grid = std::get<WindGrid>(mapped.values()[t].grid());
+        EXPECT_TRUE(grid.hasCurrent());
+        for (std::size_t lat = 0; lat < 3; ++lat) {
+            for (std::size_t lon = 0; lon < 2; ++lon) {
+                auto e = withCurrent.values()[t](lat, lon);
+                auto r = mapped.values()[t](lat, lon);
+                EXPECT_NEAR(r.current.m_x.t, e.current.m_x.t, 1e-6);
+                EXPECT_NEAR(r.current.m_y.t, e.current.m_y.t, 1e-6);
+                EXPECT_NEAR(r.windVelocity.t, e.windVelocity.t, 1e-5);
+            }
+        }
+    }
+    auto res = mapped.values()[1].safeInterpolated(latitude_t(4.),
+                                                   longitude_t(10.5));
+    EXPECT_NEAR(res.current.m_x.t, 0.5, 1e-6);
+    EXPECT_NEAR(res.current.m_y.t, -1.5, 1e-6);
+
+    // Wind only forecasts keep the smaller layout
+    writeForecast(m_path, *m_timeWorldMap);
+    EXPECT_FALSE(
+      std::get<WindGrid>(mapForecast(m_path).values()[0].grid()).hasCurrent());
+}
+
+TEST_F(ForecastFileFixture, TEST_writer)
+{
+    {
+        ForecastWriter writer(
+          m_path,
+          m_timeSpace,
+          makeLinearSpace(latitude_t(0.), latitude_t(1.), 2),
+          makeLinearSpace(longitude_t(0.), longitude_t(1.), 2));
+        float u[] = { 1.f, 2.f, 3.f, 4.f };
+        float v[] = { -1.f, -2.f, -3.f, -4.f };
+        writer.write(1, ForecastWriter::Component::V, v);
+        writer.write(1, ForecastWriter::Component::U, u);
+        EXPECT_THROW(writer.write(2, ForecastWriter::Component::U, u),
+                     Exception);
+        writer.close();
+    }
+
+    auto mapped = mapForecast(m_path);
+    const auto& grid = std::get<WindGrid>(mapped.values()[1].grid());
+    EXPECT_EQ(grid.u()[1 + 1 * 3], 4.f);
+    EXPECT_EQ(grid.v()[0 + 1 * 3], -3.f);
+    // Duplicated last row and column
+    EXPECT_EQ(grid.u()[2 + 2 * 3], 4.f);
+    EXPECT_EQ(grid.u()[2 + 0 * 3], 2.f);
+    // Unwritten slice is calm
+    const auto& calm = std::get<WindGrid>(mapped.values()[0].grid());
+    EXPECT_EQ(calm.u()[4], 0.f);
+    EXPECT_EQ(calm.v()[4], 0.f);
+}
+
+TEST_F(ForecastFileFixture, TEST_invalid)
+{
+    EXPECT_THROW(mapForecast(m_path + ".missing"), Exception);
+
+    {
+        std::ofstream file(m_path, std::ios::binary);
+        file << "not a forecast file, not a forecast file, not a forecast "
+                "file, not a forecast file, not a forecast file";
+    }
+    EXPECT_THROW(mapForecast(m_path), Exception);
+
+    // Truncated file
+    writeForecast(m_path, *m_timeWorldMap);
+    auto header = ForecastHeader::make(m_timeSpace,
+                                       m_timeWorldMap->values()[0].latSpace(),
+                                       m_timeWorldMap->values()[0].lonSpace());
+    {
+        std::ifstream in(m_path, std::ios::binary);
+        std::string content(header.fileSize() - 4, '\0');
+        in.read(&content[0], std::streamsize(content.size()));
+        in.close();
+        std::ofstream out(m_path, std::ios::binary | std::ios::trunc);
+        out.write(content.data(), std::streamsize(content.size()));
+    }
+    EXPECT_THROW(mapForecast(m_path), Exception);
+}
+
+TEST_F(ForecastFileFixture, TEST_corrupted_header)
+{
+    writeForecast(m_path, *m_timeWorldMap);
+    ForecastHeader valid;
+    {
+        std::ifstream in(m_path, std::ios::binary);
+        in.read(reinterpret_cast<char*>(&valid), sizeof(valid));
+    }
+    auto corrupt = [this](const ForecastHeader& header) {
+        std::fstream file(m_path,
+                          std::ios::binary | std::ios::in | std::ios::out);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    };
+
+    // Overlapping planes
+    auto header = valid;
+    header.planeStride -= ForecastHeader::PLANE_ALIGNMENT;
+    corrupt(header);
+    EXPECT_THROW(mapForecast(m_path), Exception);
+
+    // Planes over the header
+    header = valid;
+    header.planeOffset = 0;
+    corrupt(header);
+    EXPECT_THROW(mapForecast(m_path), Exception);
+
+    // Layout past the file end with a small file size
+    header = valid;
+    header.planeStride *= 2;
+    corrupt(header);
+    EXPECT_THROW(mapForecast(m_path), Exception);
+
+    // Overflowing point counts
+    header = valid;
+    header.latNrPoints = std::uint64_t(1) << 40;
+    header.lonNrPoints = std::uint64_t(1) << 40;
+    corrupt(header);
+    EXPECT_THROW(mapForecast(m_path), Exception);
+    header = valid;
+    header.timeNrPoints = std::numeric_limits<std::uint64_t>::max() / 2;
+    corrupt(header);
+    EXPECT_THROW(mapForecast(m_path), Exception);
+    EXPECT_THROW(header.check(std::numeric_limits<std::uint64_t>::max()),
+                 Exception);
+
+    corrupt(valid);
+    EXPECT_NO_THROW(mapForecast(m_path));
+}
+
+TEST_F(ForecastFileFixture, TEST_non_uniform)
+{
+    TimeWorldMapBuilder builder(makeNonUniformSpace(
+      std::vector<tiny_sea::time_t>{ tiny_sea::time_t(0.),
+                                     tiny_sea::time_t(3600.),
+                                     tiny_sea::time_t(10800.) }));
+    for (std::size_t t = 0; t < 3; ++t) {
+        builder.add(m_timeWorldMap->values()[0]);
+    }
+    EXPECT_THROW(writeForecast(m_path, builder.build()), Exception);
+}
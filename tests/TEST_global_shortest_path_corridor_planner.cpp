@@ -0,0 +1,255 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// includes
+// GTest
+#include <gtest/gtest.h>
+
+// tiny_sea
+#include <tiny_sea/core/boat_velocity_table.h>
+#include <tiny_sea/core/compiled_boat_velocity_table.h>
+#include <tiny_sea/core/exception.h>
+#include <tiny_sea/core/world_map.h>
+#include <tiny_sea/gsp/binary_heap_open_list.h>
+#include <tiny_sea/gsp/close_list.h>
+#include <tiny_sea/gsp/corridor.h>
+#include <tiny_sea/gsp/corridor_planner.h>
+#include <tiny_sea/gsp/global_shortest_path.h>
+#include <tiny_sea/gsp/neighbors_finder.h>
+#include <tiny_sea/gsp/state_factory.h>
+
+using namespace tiny_sea;
+using namespace tiny_sea::gsp;
+
+namespace {
+
+const double KNOT_TO_MS = 0.51444;
+const double DEG_TO_RAD = PI / 180.;
+
+}
+
+/*! Steady light air beam reach over a 53km passage, 24 hours.
+ * The distance / max velocity heuristic is loose in light air, the full
+ * search expand a wide area around the route.
+ * Same boat than ShortestPathFullFixture.
+ */
+class CorridorPlannerFixture : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        const std::size_t NR_WORLD = 24;
+
+        TimeWorldMapBuilder timeWorldMapBuilder(
+          makeLinearSpace(fromChrono(std::chrono::seconds(0)),
+                          fromChrono(std::chrono::hours(1)),
+                          NR_WORLD));
+
+        WorldMapGridBuilder gridBuilder(m_latSpace, m_lonSpace);
+        for (std::size_t i = 0; i < NR_WORLD; ++i) {
+            for (std::size_t lat = 0; lat < 12; ++lat) {
+                for (std::size_t lon = 0; lon < 12; ++lon) {
+                    gridBuilder(lat, lon) = WorldMapData(
+                      radian_t(7. * PI / 4.), velocity_t(3. * KNOT_TO_MS));
+                }
+            }
+            timeWorldMapBuilder.add(WorldMap(gridBuilder.build()));
+        }
+
+        BoatVelocityTableBuilder velocityTableBuilder(
+          makeLinearSpace(velocity_t(0.), velocity_t(6. * KNOT_TO_MS), 4));
+        velocityTableBuilder.addSymetric(radian_t(40. * DEG_TO_RAD),
+                                         { velocity_t(0.),
+                                           velocity_t(4.05 * KNOT_TO_MS),
+                                           velocity_t(6.27 * KNOT_TO_MS),
+                                           velocity_t(0.) });
+        velocityTableBuilder.addSymetric(radian_t(90. * DEG_TO_RAD),
+                                         { velocity_t(0.),
+                                           velocity_t(6.14 * KNOT_TO_MS),
+                                           velocity_t(7.47 * KNOT_TO_MS),
+                                           velocity_t(0.) });
+        velocityTableBuilder.add(radian_t(180. * DEG_TO_RAD),
+                                 { velocity_t(0.),
+                                   velocity_t(2.99 * KNOT_TO_MS),
+                                   velocity_t(5.75 * KNOT_TO_MS),
+                                   velocity_t(0.) });
+        m_boatVelocityTable.reset(
+          new BoatVelocityTable(velocityTableBuilder.build()));
+        m_speedTable.reset(
+          new CompiledBoatVelocityTable(*m_boatVelocityTable));
+
+        m_start =
+          NVector::fromLatLon(latitude_t(0.75520397), longitude_t(0.06126106));
+        m_target =
+          NVector::fromLatLon(latitude_t(0.76120397), longitude_t(0.06926106));
+        m_timeWorldMap.reset(new TimeWorldMap(timeWorldMapBuilder.build()));
+    }
+
+    /// Run a full fine search and return the number of expanded states
+    std::size_t find(State& res) const
+    {
+        StateFactory factory(std::chrono::minutes(10),
+                             meter_t(500.),
+                             std::chrono::seconds(0),
+                             meter_t(EARTH_RADIUS),
+                             m_target,
+                             m_boatVelocityTable->maxVelocity());
+        NeighborsFinder neighborsFinder(
+          &factory, m_timeWorldMap.get(), *m_speedTable, meter_t(1000.));
+
+        CloseList closeList;
+        std::vector<State> start(
+          { factory.build(m_start, std::chrono::seconds(0)) });
+        BinaryHeapOpenList openList(start.begin(), start.end());
+        auto target = factory.build(m_target, std::chrono::seconds(0));
+        auto path =
+          findGlobalShortestPath(target, openList, closeList, neighborsFinder);
+        EXPECT_TRUE(path);
+        if (path) {
+            res = path->state;
+        }
+        return closeList.size();
+    }
+
+    CorridorPlanner buildPlanner(meter_t corridorWidth) const
+    {
+        return CorridorPlanner(
+          m_timeWorldMap.get(),
+          *m_speedTable,
+          m_boatVelocityTable->maxVelocity(),
+          PlannerResolution(
+            fromChrono(std::chrono::hours(1)), meter_t(2000.), meter_t(4000.)),
+          PlannerResolution(fromChrono(std::chrono::minutes(10)),
+                            meter_t(500.),
+                            meter_t(1000.)),
+          corridorWidth);
+    }
+
+    LinearSpace<latitude_t> m_latSpace{
+        makeLinearSpace(latitude_t(0.75520397), latitude_t(0.00087266), 12)
+    };
+    LinearSpace<longitude_t> m_lonSpace{
+        makeLinearSpace(longitude_t(0.06126106), longitude_t(0.00087266), 12)
+    };
+    NVector m_start;
+    NVector m_target;
+    std::unique_ptr<TimeWorldMap> m_timeWorldMap;
+    std::unique_ptr<BoatVelocityTable> m_boatVelocityTable;
+    std::unique_ptr<CompiledBoatVelocityTable> m_speedTable;
+};
+
+TEST_F(CorridorPlannerFixture, TEST_corridor)
+{
+    Corridor corridor({ m_start, m_target }, meter_t(1000.), meter_t(250.));
+    EXPECT_TRUE(corridor.inside(m_start));
+    EXPECT_TRUE(corridor.inside(m_target));
+    EXPECT_GT(corridor.nrInside(), 0);
+    EXPECT_LT(corridor.nrInside(),
+              corridor.latSpace().nrPoints() * corridor.lonSpace().nrPoints());
+    EXPECT_EQ(
+      corridor.memory(),
+      ((corridor.latSpace().nrPoints() * corridor.lonSpace().nrPoints() + 63) /
+       64) *
+        sizeof(std::uint64_t));
+
+    // Positions on both sides of the route middle
+    radian_t bearing = m_start.bearing(m_target);
+    auto middle =
+      m_start.destination(bearing, m_start.distance(m_target) / scale_t(2.));
+    radian_t normal = middle.bearing(m_target) + radian_t(PI / 2.);
+    EXPECT_TRUE(corridor.inside(middle));
+    EXPECT_TRUE(corridor.inside(middle.destination(normal, meter_t(900.))));
+    EXPECT_TRUE(corridor.inside(middle.destination(normal, meter_t(-900.))));
+    EXPECT_FALSE(corridor.inside(middle.destination(normal, meter_t(2000.))));
+    EXPECT_FALSE(corridor.inside(middle.destination(normal, meter_t(-2000.))));
+    // Behind the start
+    EXPECT_TRUE(corridor.inside(m_start.destination(bearing, meter_t(-900.))));
+    EXPECT_FALSE(
+      corridor.inside(m_start.destination(bearing, meter_t(-2000.))));
+    // Outside of the raster
+    EXPECT_FALSE(
+      corridor.inside(NVector::fromLatLon(latitude_t(0.7), longitude_t(0.))));
+
+    // Single position route
+    Corridor point({ m_start }, meter_t(1000.), meter_t(250.));
+    EXPECT_TRUE(point.inside(m_start));
+    EXPECT_TRUE(point.inside(m_start.destination(bearing, meter_t(900.))));
+    EXPECT_FALSE(point.inside(m_start.destination(bearing, meter_t(2000.))));
+
+    EXPECT_THROW(Corridor({}, meter_t(1000.), meter_t(250.)), Exception);
+    EXPECT_THROW(Corridor({ m_start }, meter_t(0.), meter_t(250.)), Exception);
+    EXPECT_THROW(Corridor({ m_start }, meter_t(1000.), meter_t(0.)),
+                 Exception);
+    EXPECT_THROW(buildPlanner(meter_t(0.)), Exception);
+}
+
+/*! The fine search restricted to the corridor must expand far less states
+ * than the full fine search, for a close travel time.
+ */
+TEST_F(CorridorPlannerFixture, TEST_find)
+{
+    State res(m_start, std::chrono::seconds(0), DiscretState(0, 0, 0, 0));
+    std::size_t nrExpanded = find(res);
+
+    auto planner = buildPlanner(meter_t(1000.));
+    auto plan = planner.find(m_start, tiny_sea::time_t(0.), m_target);
+    ASSERT_TRUE(plan);
+    // 171k full expansions against 1.6k coarse and 19k fine ones
+    EXPECT_LT((plan->nrCoarseExpanded + plan->nrFineExpanded) * 5,
+              nrExpanded);
+    EXPECT_LT(plan->state.position().distance(m_target),
+              meter_t(std::sqrt(2. * (500 * 500))));
+    EXPECT_GE(plan->state.g().t, res.g().t - 600.);
+    EXPECT_LE(plan->state.g().t, res.g().t * 1.05);
+
+    // Routes follow the parent states from the start
+    ASSERT_GE(plan->coarseRoute.size(), 2);
+    ASSERT_GE(plan->route.size(), plan->coarseRoute.size());
+    EXPECT_EQ(plan->route.front().position(), m_start);
+    EXPECT_FALSE(plan->route.front().parentState());
+    EXPECT_EQ(plan->route.back().discretState(), plan->state.discretState());
+    for (std::size_t i = 1; i < plan->route.size(); ++i) {
+        EXPECT_EQ(*plan->route[i].parentState(),
+                  plan->route[i - 1].discretState());
+    }
+    EXPECT_EQ(plan->coarseRoute.front().position(), m_start);
+}
+
+/*! Each phase use its own dominance table, so the fine search still reach
+ * the target and expand less states.
+ */
+TEST_F(CorridorPlannerFixture, TEST_dominance)
+{
+    auto planner = buildPlanner(meter_t(1000.));
+    auto plan = planner.find(m_start, tiny_sea::time_t(0.), m_target);
+    ASSERT_TRUE(plan);
+
+    EXPECT_FALSE(planner.dominance());
+    planner.setDominance(true);
+    auto dominancePlan = planner.find(m_start, tiny_sea::time_t(0.), m_target);
+    ASSERT_TRUE(dominancePlan);
+    EXPECT_LE(dominancePlan->nrCoarseExpanded, plan->nrCoarseExpanded);
+    EXPECT_LT(dominancePlan->nrFineExpanded, plan->nrFineExpanded);
+    EXPECT_LT(dominancePlan->state.position().distance(m_target),
+              meter_t(std::sqrt(2. * (500 * 500))));
+    EXPECT_NEAR(dominancePlan->state.g().t, plan->state.g().t, 600.);
+
+    // Same result on a second call
+    auto again = planner.find(m_start, tiny_sea::time_t(0.), m_target);
+    ASSERT_TRUE(again);
+    EXPECT_EQ(again->nrFineExpanded, dominancePlan->nrFineExpanded);
+    EXPECT_EQ(again->state.g(), dominancePlan->state.g());
+}
@@ -0,0 +1,83 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// includes
+// GTest
+#include <gtest/gtest.h>
+
+// std
+#include <memory>
+
+// tiny_sea
+#include <tiny_sea/gsp/dominance_table.h>
+#include <tiny_sea/gsp/state_factory.h>
+
+using namespace tiny_sea;
+using namespace tiny_sea::gsp;
+
+class DominanceTableFixture : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_factory.reset(new StateFactory(std::chrono::hours(1),
+                                         meter_t(100.),
+                                         std::chrono::seconds(0),
+                                         meter_t(1000.),
+                                         NVector(1., 0., 0.),
+                                         velocity_t(2.)));
+    }
+
+    std::unique_ptr<StateFactory> m_factory;
+};
+
+TEST_F(DominanceTableFixture, TEST_insert)
+{
+    NVector pos(Eigen::Vector3d(10, 200, 300).normalized());
+    auto state1 = m_factory->build(pos, std::chrono::minutes(45));
+    // Same cell, later time bucket
+    auto state2 = m_factory->build(pos, std::chrono::minutes(130));
+    // Same cell, earlier time bucket
+    auto state3 = m_factory->build(pos, std::chrono::minutes(12));
+    auto other = m_factory->build(
+      NVector(Eigen::Vector3d(-10, 230, 350).normalized()),
+      std::chrono::minutes(130));
+    ASSERT_TRUE(state1.same(state2));
+    ASSERT_FALSE(state1 == state2);
+
+    DominanceTable table;
+    EXPECT_FALSE(table.dominated(state1));
+    EXPECT_TRUE(table.insert(state1));
+    EXPECT_TRUE(table.dominated(state1));
+    EXPECT_TRUE(table.dominated(state2));
+    EXPECT_FALSE(table.dominated(state3));
+    EXPECT_FALSE(table.dominated(other));
+
+    EXPECT_FALSE(table.insert(state2));
+    EXPECT_FALSE(table.insert(state1));
+    EXPECT_EQ(table.nrDominated(), 2);
+
+    // An earlier arrival replace the known one
+    EXPECT_TRUE(table.insert(state3));
+    EXPECT_TRUE(table.dominated(state1));
+    EXPECT_TRUE(table.insert(other));
+    EXPECT_EQ(table.size(), 2);
+
+    table.clear();
+    EXPECT_EQ(table.size(), 0);
+    EXPECT_EQ(table.nrDominated(), 0);
+    EXPECT_TRUE(table.insert(state2));
+}
@@ -23,6 +23,7 @@
 #include <tiny_sea/core/world_map.h>
 #include <tiny_sea/gsp/binary_heap_open_list.h>
 #include <tiny_sea/gsp/close_list.h>
+#include <tiny_sea/gsp/dominance_table.h>
 #include <tiny_sea/gsp/global_shortest_path.h>
 #include <tiny_sea/gsp/neighbors_finder.h>
 #include <tiny_sea/gsp/state_factory.h>
@@ -109,6 +110,23 @@ protected:
                                                     meter_t(1000.)));
     }
 
+    /// Run a search and return the number of expanded states
+    std::size_t find(State& res) const
+    {
+        CloseList closeList;
+        std::vector<State> start(
+          { m_factory->build(m_start, std::chrono::seconds(0)) });
+        BinaryHeapOpenList openList(start.begin(), start.end());
+        auto target = m_factory->build(m_target, std::chrono::seconds(0));
+        auto path = findGlobalShortestPath(
+          target, openList, closeList, *m_neighborsFinder);
+        EXPECT_TRUE(path);
+        if (path) {
+            res = path->state;
+        }
+        return closeList.size();
+    }
+
     NVector m_start;
     NVector m_target;
     std::unique_ptr<StateFactory> m_factory;
@@ -135,3 +153,43 @@ TEST_F(ShortestPathFullFixture, TEST_find1)
     EXPECT_LT(state.position().distance(m_target),
               meter_t(std::sqrt(2. * (500 * 500))));
 }
+
+/*! Later arrivals in the same cell are pruned, the search must expand less
+ * states and find a close travel time.
+ */
+TEST_F(ShortestPathFullFixture, TEST_dominance)
+{
+    State res = m_factory->build(m_start, std::chrono::seconds(0));
+    std::size_t nrExpanded = find(res);
+
+    DominanceTable table;
+    m_neighborsFinder->setDominanceTable(&table);
+    State dominanceRes = res;
+    std::size_t nrDominanceExpanded = find(dominanceRes);
+    // 6569 states without the table, 2399 with it
+    EXPECT_LT(nrDominanceExpanded, nrExpanded / 2);
+    EXPECT_GT(table.nrDominated(), 0);
+    EXPECT_LT(dominanceRes.position().distance(m_target),
+              meter_t(std::sqrt(2. * (500 * 500))));
+    // Pruning is approximate, 10342.723068s with the table and
+    // 10342.723074s without it
+    EXPECT_NEAR(dominanceRes.g().t, res.g().t, 1.);
+}
+
+/*! States close to the target try a direct leg, the search must end
+ * exactly on the target with less expanded states.
+ */
+TEST_F(ShortestPathFullFixture, TEST_direct_shot)
+{
+    State res = m_factory->build(m_start, std::chrono::seconds(0));
+    std::size_t nrExpanded = find(res);
+
+    m_neighborsFinder->setDirectShot(meter_t(3000.));
+    State shotRes = res;
+    std::size_t nrShotExpanded = find(shotRes);
+    // 6569 states without the direct shot, 4844 with it
+    EXPECT_LT(nrShotExpanded, nrExpanded);
+    EXPECT_LT(shotRes.position().distance(m_target), meter_t(1e-3));
+    // Continuous arrival time instead of the target cell one
+    EXPECT_LE(shotRes.g().t, res.g().t);
+}
@@ -0,0 +1,398 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// includes
+// GTest
+#include <gtest/gtest.h>
+
+// tiny_sea
+#include <tiny_sea/core/boat_velocity_table.h>
+#include <tiny_sea/core/compiled_boat_velocity_table.h>
+#include <tiny_sea/core/exception.h>
+#include <tiny_sea/core/tidal_current_grid.h>
+#include <tiny_sea/core/world_map.h>
+#include <tiny_sea/gsp/binary_heap_open_list.h>
+#include <tiny_sea/gsp/close_list.h>
+#include <tiny_sea/gsp/global_shortest_path.h>
+#include <tiny_sea/gsp/heuristic_field.h>
+#include <tiny_sea/gsp/landmarks.h>
+#include <tiny_sea/gsp/neighbors_finder.h>
+#include <tiny_sea/gsp/state_factory.h>
+
+using namespace tiny_sea;
+using namespace tiny_sea::gsp;
+
+namespace {
+
+const double KNOT_TO_MS = 0.51444;
+const double DEG_TO_RAD = PI / 180.;
+
+}
+
+/*! Light air from north/east on the west of the map and a stronger
+ * wind on the east, over 12 hours.
+ * Same boat and route than ShortestPathFullFixture.
+ */
+class HeuristicFieldFixture : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        const std::size_t NR_WORLD = 12;
+
+        TimeWorldMapBuilder timeWorldMapBuilder(
+          makeLinearSpace(fromChrono(std::chrono::seconds(0)),
+                          fromChrono(std::chrono::hours(1)),
+                          NR_WORLD));
+
+        WorldMapGridBuilder gridBuilder(m_latSpace, m_lonSpace);
+        for (std::size_t i = 0; i < NR_WORLD; ++i) {
+            for (std::size_t lat = 0; lat < 5; ++lat) {
+                for (std::size_t lon = 0; lon < 6; ++lon) {
+                    double wind = lon < 4 ? 3. : 7.;
+                    gridBuilder(lat, lon) = WorldMapData(
+                      radian_t(PI / 4.), velocity_t(wind * KNOT_TO_MS));
+                }
+            }
+            timeWorldMapBuilder.add(WorldMap(gridBuilder.build()));
+        }
+
+        BoatVelocityTableBuilder velocityTableBuilder(
+          makeLinearSpace(velocity_t(0.), velocity_t(6. * KNOT_TO_MS), 4));
+        velocityTableBuilder.addSymetric(radian_t(40. * DEG_TO_RAD),
+                                         { velocity_t(0.),
+                                           velocity_t(4.05 * KNOT_TO_MS),
+                                           velocity_t(6.27 * KNOT_TO_MS),
+                                           velocity_t(0.) });
+        velocityTableBuilder.addSymetric(radian_t(90. * DEG_TO_RAD),
+                                         { velocity_t(0.),
+                                           velocity_t(6.14 * KNOT_TO_MS),
+                                           velocity_t(7.47 * KNOT_TO_MS),
+                                           velocity_t(0.) });
+        velocityTableBuilder.add(radian_t(180. * DEG_TO_RAD),
+                                 { velocity_t(0.),
+                                   velocity_t(2.99 * KNOT_TO_MS),
+                                   velocity_t(5.75 * KNOT_TO_MS),
+                                   velocity_t(0.) });
+        m_boatVelocityTable.reset(
+          new BoatVelocityTable(velocityTableBuilder.build()));
+        m_speedTable.reset(
+          new CompiledBoatVelocityTable(*m_boatVelocityTable));
+
+        m_start =
+          NVector::fromLatLon(latitude_t(0.75520397), longitude_t(0.06126106));
+        m_target =
+          NVector::fromLatLon(latitude_t(0.75641780), longitude_t(0.06360946));
+
+        m_factory.reset(new StateFactory(std::chrono::minutes(10),
+                                         meter_t(500.),
+                                         std::chrono::seconds(0),
+                                         meter_t(EARTH_RADIUS),
+                                         m_target,
+                                         m_boatVelocityTable->maxVelocity()));
+        m_timeWorldMap.reset(new TimeWorldMap(timeWorldMapBuilder.build()));
+        m_neighborsFinder.reset(new NeighborsFinder(m_factory.get(),
+                                                    m_timeWorldMap.get(),
+                                                    m_boatVelocityTable.get(),
+                                                    meter_t(1000.)));
+    }
+
+    VelocityLattice buildLattice() const
+    {
+        // Twice the world map resolution
+        return VelocityLattice(
+          *m_timeWorldMap,
+          *m_speedTable,
+          makeLinearSpace(latitude_t(0.75520397), latitude_t(0.00043633), 9),
+          makeLinearSpace(
+            longitude_t(0.06126106), longitude_t(0.00043633), 11));
+    }
+
+    /// Rebuild the factory with another speed over ground bound
+    void setMaxVelocity(velocity_t maxVelocity)
+    {
+        *m_factory = StateFactory(std::chrono::minutes(10),
+                                  meter_t(500.),
+                                  std::chrono::seconds(0),
+                                  meter_t(EARTH_RADIUS),
+                                  m_target,
+                                  maxVelocity);
+    }
+
+    HeuristicField buildField() const
+    {
+        return HeuristicField(buildLattice(), m_target);
+    }
+
+    /// Run a search and return the number of expanded states
+    std::size_t find(State& res) const
+    {
+        CloseList closeList;
+        std::vector<State> start(
+          { m_factory->build(m_start, std::chrono::seconds(0)) });
+        BinaryHeapOpenList openList(start.begin(), start.end());
+        auto target = m_factory->build(m_target, std::chrono::seconds(0));
+        auto path = findGlobalShortestPath(
+          target, openList, closeList, *m_neighborsFinder);
+        EXPECT_TRUE(path);
+        if (path) {
+            res = path->state;
+        }
+        return closeList.size();
+    }
+
+    LinearSpace<latitude_t> m_latSpace{
+        makeLinearSpace(latitude_t(0.75520397), latitude_t(0.00087266), 5)
+    };
+    LinearSpace<longitude_t> m_lonSpace{
+        makeLinearSpace(longitude_t(0.06126106), longitude_t(0.00087266), 6)
+    };
+    NVector m_start;
+    NVector m_target;
+    std::unique_ptr<StateFactory> m_factory;
+    std::unique_ptr<TimeWorldMap> m_timeWorldMap;
+    std::unique_ptr<BoatVelocityTable> m_boatVelocityTable;
+    std::unique_ptr<CompiledBoatVelocityTable> m_speedTable;
+    std::unique_ptr<NeighborsFinder> m_neighborsFinder;
+};
+
+TEST_F(HeuristicFieldFixture, TEST_cells)
+{
+    auto field = buildField();
+    EXPECT_GT(field.buildTime().count(), 0);
+    EXPECT_EQ(field.memory(), (9 * 11 + 8 * 10) * sizeof(double));
+    // Best boat velocity at 7 knots
+    double fast = (6.14 + (7.47 - 6.14) / 6.) * KNOT_TO_MS;
+    EXPECT_NEAR(field.maxVelocity().t, fast, 1e-8);
+
+    // Best boat velocity at 3 knots
+    EXPECT_NEAR(field.cellVelocity(0, 0).t, 6.14 / 2. * KNOT_TO_MS, 1e-8);
+    EXPECT_NEAR(field.cellVelocity(7, 5).t, 6.14 / 2. * KNOT_TO_MS, 1e-8);
+    // Cells touching the 7 knots nodes
+    EXPECT_NEAR(field.cellVelocity(0, 6).t, fast, 1e-8);
+    EXPECT_NEAR(field.cellVelocity(7, 9).t, fast, 1e-8);
+
+    EXPECT_EQ(field.heuristic(m_target), cost_t(0.));
+    // Outside of the lattice
+    EXPECT_EQ(
+      field.heuristic(NVector::fromLatLon(latitude_t(0.7), longitude_t(0.))),
+      cost_t(0.));
+
+    EXPECT_THROW(HeuristicField(*m_timeWorldMap,
+                                *m_speedTable,
+                                m_latSpace,
+                                m_lonSpace,
+                                NVector::fromLatLon(latitude_t(0.7),
+                                                    longitude_t(0.))),
+                 Exception);
+}
+
+/*! The field must stay below the travel time found by the search and
+ * expand less states than the distance / max velocity heuristic.
+ */
+TEST_F(HeuristicFieldFixture, TEST_search)
+{
+    State res = m_factory->build(m_start, std::chrono::seconds(0));
+    std::size_t nrExpanded = find(res);
+
+    auto field = buildField();
+    auto h = field.heuristic(m_start);
+    EXPECT_GT(h, m_factory->build(m_start, std::chrono::seconds(0)).h());
+    EXPECT_LE(h, res.g());
+
+    m_factory->setHeuristic(&field);
+    State fieldRes = res;
+    std::size_t nrFieldExpanded = find(fieldRes);
+    EXPECT_EQ(m_factory->build(m_start, std::chrono::seconds(0)).h(), h);
+    EXPECT_LT(nrFieldExpanded, nrExpanded);
+    EXPECT_LT(fieldRes.position().distance(m_target),
+              meter_t(std::sqrt(2. * (500 * 500))));
+    EXPECT_NEAR(fieldRes.g().t, res.g().t, 600.);
+}
+
+TEST_F(HeuristicFieldFixture, TEST_landmarks)
+{
+    Landmarks landmarks(buildLattice(), 4, 1);
+    const auto& lattice = landmarks.lattice();
+    EXPECT_EQ(landmarks.nrLandmarks(), 4);
+    EXPECT_GT(landmarks.buildTime().count(), 0);
+    EXPECT_EQ(landmarks.memory(), (4 * 9 * 11 + 8 * 10) * sizeof(double));
+    // Evenly spaced on the 36 border nodes
+    EXPECT_EQ(landmarks.landmark(0), lattice.node(0, 0));
+    EXPECT_EQ(landmarks.landmark(1), lattice.node(0, 9));
+    EXPECT_EQ(landmarks.landmark(2), lattice.node(8, 10));
+    EXPECT_EQ(landmarks.landmark(3), lattice.node(8, 1));
+    for (std::size_t l = 0; l < landmarks.nrLandmarks(); ++l) {
+        EXPECT_EQ(landmarks.time(l, landmarks.landmark(l)), 0.);
+    }
+    // Lattice times are symmetric
+    EXPECT_NEAR(landmarks.time(0, landmarks.landmark(2)),
+                landmarks.time(2, landmarks.landmark(0)),
+                1e-6);
+
+    // Parallel precompute give the same times
+    Landmarks parallelLandmarks(buildLattice(), 4, 4);
+    for (std::size_t l = 0; l < landmarks.nrLandmarks(); ++l) {
+        for (std::size_t n = 0; n < lattice.nrNodes(); ++n) {
+            EXPECT_EQ(parallelLandmarks.time(l, n), landmarks.time(l, n));
+        }
+    }
+
+    Landmarks positionLandmarks(buildLattice(), { m_start, m_target });
+    EXPECT_EQ(positionLandmarks.landmark(0), lattice.node(0, 0));
+    EXPECT_EQ(positionLandmarks.landmark(1), lattice.node(3, 5));
+
+    LandmarkHeuristic heuristic(landmarks, m_target);
+    EXPECT_EQ(&heuristic.landmarks(), &landmarks);
+    EXPECT_EQ(heuristic.heuristic(m_target), cost_t(0.));
+    // Outside of the lattice
+    EXPECT_EQ(heuristic.heuristic(
+                NVector::fromLatLon(latitude_t(0.7), longitude_t(0.))),
+              cost_t(0.));
+
+    EXPECT_THROW(Landmarks(buildLattice(), 0), Exception);
+    EXPECT_THROW(Landmarks(buildLattice(), std::vector<NVector>()), Exception);
+    EXPECT_THROW(
+      Landmarks(buildLattice(),
+                { NVector::fromLatLon(latitude_t(0.7), longitude_t(0.)) }),
+      Exception);
+    EXPECT_THROW(
+      LandmarkHeuristic(
+        landmarks, NVector::fromLatLon(latitude_t(0.7), longitude_t(0.))),
+      Exception);
+}
+
+/*! Landmarks are shared by heuristics of several targets, each one must stay
+ * below the travel time found by the search.
+ */
+TEST_F(HeuristicFieldFixture, TEST_landmarks_search)
+{
+    State res = m_factory->build(m_start, std::chrono::seconds(0));
+    std::size_t nrExpanded = find(res);
+
+    Landmarks landmarks(buildLattice(), 8);
+    LandmarkHeuristic heuristic(landmarks, m_target);
+    auto h = heuristic.heuristic(m_start);
+    EXPECT_GT(h, m_factory->build(m_start, std::chrono::seconds(0)).h());
+    EXPECT_LE(h, res.g());
+
+    // Relaxed travel times are symmetric
+    LandmarkHeuristic reverseHeuristic(landmarks, m_start);
+    EXPECT_GT(reverseHeuristic.heuristic(m_target), cost_t(0.));
+    EXPECT_LE(reverseHeuristic.heuristic(m_target), res.g());
+
+    m_factory->setHeuristic(&heuristic);
+    State landmarkRes = res;
+    std::size_t nrLandmarkExpanded = find(landmarkRes);
+    EXPECT_EQ(m_factory->build(m_start, std::chrono::seconds(0)).h(), h);
+    EXPECT_LT(nrLandmarkExpanded, nrExpanded);
+    EXPECT_LT(landmarkRes.position().distance(m_target),
+              meter_t(std::sqrt(2. * (500 * 500))));
+    EXPECT_NEAR(landmarkRes.g().t, res.g().t, 600.);
+
+    m_factory->setHeuristic(nullptr);
+    EXPECT_LT(m_factory->build(m_start, std::chrono::seconds(0)).h(), h);
+}
+
+/*! A tidal current on the east of the map raise the cells bounds, the field
+ * built with it must stay below the travel time of a search using it.
+ */
+TEST_F(HeuristicFieldFixture, TEST_tidal_current)
+{
+    TidalCurrentGridBuilder builder(
+      m_latSpace,
+      m_lonSpace,
+      makeLinearSpace(fromChrono(std::chrono::seconds(0)),
+                      fromChrono(std::chrono::hours(1)),
+                      12),
+      { TidalConstituent::fromDegreesPerHour(
+          TidalConstituent::M2, radian_t(0.), 0.9) });
+    TidalHarmonic flood{ velocity_t(2. * KNOT_TO_MS), radian_t(0.) };
+    TidalHarmonic none{ velocity_t(0.), radian_t(0.) };
+    for (std::size_t lat = 0; lat < 5; ++lat) {
+        for (std::size_t lon = 4; lon < 6; ++lon) {
+            builder.set(lat, lon, 0, flood, none);
+        }
+    }
+    TidalCurrentGrid tidal(builder.build());
+
+    auto field = buildField();
+    HeuristicField tidalField(*m_timeWorldMap,
+                              *m_speedTable,
+                              field.latSpace(),
+                              field.lonSpace(),
+                              m_target,
+                              &tidal);
+    double tide = 0.9 * 2. * KNOT_TO_MS;
+    EXPECT_NEAR(tidalField.maxVelocity().t, field.maxVelocity().t + tide, 1e-6);
+    // West cells don't touch the tidal nodes
+    EXPECT_NEAR(
+      tidalField.cellVelocity(0, 0).t, field.cellVelocity(0, 0).t, 1e-8);
+    EXPECT_NEAR(
+      tidalField.cellVelocity(7, 5).t, field.cellVelocity(7, 5).t, 1e-8);
+    EXPECT_NEAR(
+      tidalField.cellVelocity(7, 9).t, field.cellVelocity(7, 9).t + tide, 1e-6);
+    EXPECT_LE(tidalField.heuristic(m_start), field.heuristic(m_start));
+
+    EXPECT_NEAR(tidal.maxSpeedBound().t, tide, 1e-6);
+    m_neighborsFinder->setTidalCurrentGrid(&tidal);
+    setMaxVelocity(m_boatVelocityTable->maxVelocity() + tidal.maxSpeedBound());
+    m_factory->setHeuristic(&tidalField);
+    State res = m_factory->build(m_start, std::chrono::seconds(0));
+    find(res);
+    EXPECT_LE(tidalField.heuristic(m_start), res.g());
+}
+
+/*! A current flowing toward the target make the boat faster than its polar,
+ * the distance bound must use the speed over ground bound.
+ */
+TEST_F(HeuristicFieldFixture, TEST_following_current)
+{
+    EXPECT_EQ(m_timeWorldMap->maxCurrentVelocity(), velocity_t(0.));
+
+    // WindVector bearings are where the flow come from
+    auto current =
+      WindVector::fromBearing(m_start.bearing(m_target) + radian_t(PI),
+                              velocity_t(2. * KNOT_TO_MS));
+    TimeWorldMapBuilder builder(m_timeWorldMap->xSpace());
+    for (std::size_t i = 0; i + 1 < m_timeWorldMap->values().size(); ++i) {
+        const auto& worldMap = m_timeWorldMap->values()[i];
+        WorldMapGridBuilder gridBuilder(m_latSpace, m_lonSpace);
+        for (std::size_t lat = 0; lat < 5; ++lat) {
+            for (std::size_t lon = 0; lon < 6; ++lon) {
+                auto data = worldMap(lat, lon);
+                data.current = current;
+                gridBuilder(lat, lon) = data;
+            }
+        }
+        builder.add(WorldMap(gridBuilder.build()));
+    }
+    *m_timeWorldMap = builder.build();
+    EXPECT_NEAR(
+      m_timeWorldMap->maxCurrentVelocity().t, 2. * KNOT_TO_MS, 1e-8);
+
+    auto polarH = m_factory->build(m_start, std::chrono::seconds(0)).h();
+    setMaxVelocity(m_boatVelocityTable->maxVelocity() +
+                   m_timeWorldMap->maxCurrentVelocity());
+    auto h = m_factory->build(m_start, std::chrono::seconds(0)).h();
+    EXPECT_LT(h, polarH);
+
+    State res = m_factory->build(m_start, std::chrono::seconds(0));
+    find(res);
+    EXPECT_LE(h, res.g());
+    EXPECT_LT(res.position().distance(m_target),
+              meter_t(std::sqrt(2. * (500 * 500))));
+}
@@ -19,7 +19,12 @@
 #include <gtest/gtest.h>
 
 // tiny_sea
+#include <tiny_sea/core/boat_velocity_raster.h>
 #include <tiny_sea/core/boat_velocity_table.h>
+#include <tiny_sea/core/edge_index.h>
+#include <tiny_sea/core/land_mask.h>
+#include <tiny_sea/core/tidal_current_grid.h>
+#include <tiny_sea/core/time_obstacle_index.h>
 #include <tiny_sea/core/world_map.h>
 #include <tiny_sea/gsp/close_list.h>
 #include <tiny_sea/gsp/neighbors_finder.h>
@@ -200,3 +205,346 @@ TEST_F(NeighborsFinderFixture, TEST_search4)
     EXPECT_EQ(res[0].h(), it.first->h());
     EXPECT_EQ(res[0].parentState(), it.first->discretState());
 }
+
+/*! Expand a state between the calm and the 10 m/s slices
+ * Without time interpolation the calm slice is used, with it the 5 m/s
+ * blended wind give 2 moved neighbors at half the boat velocity
+ */
+TEST_F(NeighborsFinderFixture, TEST_search_time_interpolation)
+{
+    auto it =
+      m_closeList.insert(m_factory->build(m_start, std::chrono::minutes(30)));
+
+    std::vector<State> res;
+    m_neighborsFinder->search(it.first, res);
+    ASSERT_EQ(res.size(), 1);
+
+    res.clear();
+    m_neighborsFinder->setTimeInterpolation(true);
+    m_neighborsFinder->search(it.first, res);
+    ASSERT_EQ(res.size(), 3);
+    EXPECT_EQ(res[0].position(), it.first->position());
+    EXPECT_EQ(res[0].time(), fromChrono(std::chrono::hours(1)));
+    EXPECT_NEAR(res[1].time().t,
+                it.first->time().t + 2. * (m_distance / m_velocity).t,
+                1e-6);
+}
+
+/*! Expand a state on a calm world with 1h then 3h steps
+ * The wait neighbor should reach the next slice, 3h later
+ */
+TEST_F(NeighborsFinderFixture, TEST_search_non_uniform)
+{
+    TimeWorldMapBuilder timeWorldMapBuilder(
+      makeNonUniformSpace(std::vector<tiny_sea::time_t>{
+        fromChrono(std::chrono::hours(0)),
+        fromChrono(std::chrono::hours(1)),
+        fromChrono(std::chrono::hours(4)) }));
+    WorldMapGridBuilder gridBuilder(
+      makeLinearSpace(latitude_t(0.), latitude_t(PI / 16.), 8),
+      makeLinearSpace(longitude_t(0.), longitude_t(PI / 16.), 8));
+    for (std::size_t i = 0; i < 3; ++i) {
+        timeWorldMapBuilder.add(WorldMap(gridBuilder.build()));
+    }
+    auto timeWorldMap = std::move(timeWorldMapBuilder).build();
+    NeighborsFinder neighborsFinder(
+      m_factory.get(), &timeWorldMap, m_boatVelocityTable.get(), m_distance);
+
+    auto it = m_closeList.insert(
+      m_factory->build(m_start, std::chrono::minutes(90)));
+    std::vector<State> res;
+    neighborsFinder.search(it.first, res);
+    ASSERT_EQ(res.size(), 1);
+    EXPECT_EQ(res[0].time(), fromChrono(std::chrono::hours(4)));
+    EXPECT_EQ(res[0].g(),
+              it.first->g() + cost_t(fromChrono(std::chrono::minutes(150)).t));
+
+    res.clear();
+    it = m_closeList.insert(m_factory->build(m_start, std::chrono::hours(4)));
+    neighborsFinder.search(it.first, res);
+    EXPECT_TRUE(res.empty());
+}
+
+/*! Expand a state with wind next to a coast on its east
+ * The south east move cross the land and should be pruned
+ */
+TEST_F(NeighborsFinderFixture, TEST_search_land_mask)
+{
+    // 100x100 pixels of 1e-5 radian centered on the start position, pixels
+    // east of the start pixel are blocked
+    std::vector<bool> blocked(100 * 100);
+    for (std::size_t y = 51; y < 100; ++y) {
+        for (std::size_t x = 0; x < 100; ++x) {
+            blocked[x + y * 100] = true;
+        }
+    }
+    LandMask mask(
+      makeLinearSpace(latitude_t(6. * (PI / 16.) - 50e-5), latitude_t(1e-5),
+                      100),
+      makeLinearSpace(longitude_t(2. * (PI / 16.) - 50e-5),
+                      longitude_t(1e-5), 100),
+      blocked);
+    m_neighborsFinder->setLandMask(&mask);
+
+    auto it =
+      m_closeList.insert(m_factory->build(m_start, std::chrono::hours(1)));
+
+    std::vector<State> res;
+    m_neighborsFinder->search(it.first, res);
+    ASSERT_EQ(res.size(), 2);
+    EXPECT_EQ(res[0].position(), it.first->position());
+    NVector pos1(it.first->position()
+                   .destination(radian_t((PI / 4.) + PI), m_distance)
+                   .toEigen());
+    EXPECT_EQ(res[1].position(), pos1);
+
+    res.clear();
+    m_neighborsFinder->setLandMask(nullptr);
+    m_neighborsFinder->search(it.first, res);
+    EXPECT_EQ(res.size(), 3);
+}
+
+/*! Expand a state with wind next to a coastline going south east
+ * The south east move cross the coastline and should be pruned
+ */
+TEST_F(NeighborsFinderFixture, TEST_search_edge_index)
+{
+    double lat = 6. * (PI / 16.);
+    double lon = 2. * (PI / 16.);
+    EdgeIndexBuilder builder(radian_t(1e-5));
+    builder.addPolyline(
+      { NVector::fromLatLon(latitude_t(lat + 1e-4), longitude_t(lon + 1e-5)),
+        NVector::fromLatLon(latitude_t(lat - 1e-4),
+                            longitude_t(lon + 1e-5)) });
+    EdgeIndex index = builder.build();
+    m_neighborsFinder->setEdgeIndex(&index);
+
+    auto it =
+      m_closeList.insert(m_factory->build(m_start, std::chrono::hours(1)));
+
+    std::vector<State> res;
+    m_neighborsFinder->search(it.first, res);
+    ASSERT_EQ(res.size(), 2);
+    NVector pos1(it.first->position()
+                   .destination(radian_t((PI / 4.) + PI), m_distance)
+                   .toEigen());
+    EXPECT_EQ(res[1].position(), pos1);
+}
+
+/*! Expand a state with wind next to a zone on its south east
+ * The south east move should only be pruned while the zone is active
+ */
+TEST_F(NeighborsFinderFixture, TEST_search_time_obstacle)
+{
+    double lat = 6. * (PI / 16.);
+    double lon = 2. * (PI / 16.);
+    std::vector<NVector> zone{
+        NVector::fromLatLon(latitude_t(lat - 1e-4), longitude_t(lon + 1e-5)),
+        NVector::fromLatLon(latitude_t(lat + 1e-4), longitude_t(lon + 1e-5)),
+        NVector::fromLatLon(latitude_t(lat + 1e-4), longitude_t(lon + 1e-4)),
+        NVector::fromLatLon(latitude_t(lat - 1e-4), longitude_t(lon + 1e-4))
+    };
+    TimeObstacleIndexBuilder builder(m_timeWorldMap->xSpace(),
+                                     radian_t(1e-5));
+    builder.addZone(zone,
+                    fromChrono(std::chrono::minutes(50)),
+                    fromChrono(std::chrono::minutes(70)));
+    builder.addZone(zone,
+                    fromChrono(std::chrono::minutes(130)),
+                    fromChrono(std::chrono::minutes(140)));
+    auto index = std::move(builder).build();
+    m_neighborsFinder->setTimeObstacleIndex(&index);
+
+    auto it =
+      m_closeList.insert(m_factory->build(m_start, std::chrono::hours(1)));
+    std::vector<State> res;
+    m_neighborsFinder->search(it.first, res);
+    EXPECT_EQ(res.size(), 2);
+
+    // The move end before the second zone window
+    it = m_closeList.insert(
+      m_factory->build(m_start, std::chrono::minutes(100)));
+    res.clear();
+    m_neighborsFinder->search(it.first, res);
+    EXPECT_EQ(res.size(), 3);
+
+    // A zone active on the boat prune the wait and all the moves
+    std::vector<NVector> around{
+        NVector::fromLatLon(latitude_t(lat - 1e-4), longitude_t(lon - 1e-4)),
+        NVector::fromLatLon(latitude_t(lat - 1e-4), longitude_t(lon + 1e-4)),
+        NVector::fromLatLon(latitude_t(lat + 1e-4), longitude_t(lon + 1e-4)),
+        NVector::fromLatLon(latitude_t(lat + 1e-4), longitude_t(lon - 1e-4))
+    };
+    TimeObstacleIndexBuilder aroundBuilder(m_timeWorldMap->xSpace(),
+                                           radian_t(1e-5));
+    aroundBuilder.addZone(around,
+                          fromChrono(std::chrono::minutes(100)),
+                          fromChrono(std::chrono::minutes(130)));
+    auto aroundIndex = std::move(aroundBuilder).build();
+    m_neighborsFinder->setTimeObstacleIndex(&aroundIndex);
+    res.clear();
+    m_neighborsFinder->search(it.first, res);
+    EXPECT_TRUE(res.empty());
+
+    // Moves ending before the zone activation escape, waiting is pruned
+    TimeObstacleIndexBuilder laterBuilder(m_timeWorldMap->xSpace(),
+                                          radian_t(1e-5));
+    laterBuilder.addZone(around,
+                         fromChrono(std::chrono::minutes(115)),
+                         fromChrono(std::chrono::minutes(130)));
+    auto laterIndex = std::move(laterBuilder).build();
+    m_neighborsFinder->setTimeObstacleIndex(&laterIndex);
+    res.clear();
+    m_neighborsFinder->search(it.first, res);
+    EXPECT_EQ(res.size(), 2);
+    for (const auto& state : res) {
+        EXPECT_NE(state.position(), m_start);
+        EXPECT_LT(state.time(), fromChrono(std::chrono::minutes(115)));
+    }
+}
+
+/*! Expand a state in the 10 m/s wind slice with a current
+ * Moves are corrected to the course and speed over ground
+ */
+TEST_F(NeighborsFinderFixture, TEST_search_current)
+{
+    WindVector current(velocity_t(1.), velocity_t(2.));
+    TimeWorldMapBuilder timeWorldMapBuilder(m_timeWorldMap->xSpace());
+    for (std::size_t i = 0; i < 4; ++i) {
+        const auto& grid = m_timeWorldMap->values()[i].worldGrid();
+        WorldMapGridBuilder gridBuilder(grid.xSpace(), grid.ySpace());
+        for (std::size_t lat = 0; lat < 8; ++lat) {
+            for (std::size_t lon = 0; lon < 8; ++lon) {
+                auto data = grid(lat, lon);
+                gridBuilder(lat, lon) =
+                  WorldMapData(data.windBearing, data.windVelocity, current);
+            }
+        }
+        timeWorldMapBuilder.add(WorldMap(gridBuilder.build()));
+    }
+    TimeWorldMap timeWorldMap(timeWorldMapBuilder.build());
+    NeighborsFinder finder(
+      m_factory.get(), &timeWorldMap, m_boatVelocityTable.get(), m_distance);
+
+    auto it =
+      m_closeList.insert(m_factory->build(m_start, std::chrono::hours(1)));
+
+    std::vector<State> res;
+    finder.search(it.first, res);
+    ASSERT_EQ(res.size(), 3);
+    EXPECT_EQ(res[0].position(), it.first->position());
+
+    for (std::size_t i = 1; i < 3; ++i) {
+        double heading = (i == 1 ? PI / 4. : -PI / 4.) + PI;
+        double east = m_velocity.t * std::sin(heading) + current.m_x.t;
+        double north = m_velocity.t * std::cos(heading) + current.m_y.t;
+        NVector pos(it.first->position()
+                      .destination(radian_t(std::atan2(east, north)),
+                                   m_distance)
+                      .toEigen());
+        EXPECT_LT(res[i].position().distance(pos).t, 1e-6);
+        EXPECT_NEAR(res[i].time().t,
+                    it.first->time().t +
+                      m_distance.t / std::hypot(east, north),
+                    1e-6);
+    }
+
+    // Raster store the current of each node
+    CompiledBoatVelocityTable speedTable(*m_boatVelocityTable);
+    BoatVelocityRaster raster(timeWorldMap, speedTable, 1);
+    EXPECT_TRUE(raster.hasCurrent());
+    std::vector<State> rasterRes;
+    finder.setBoatVelocityRaster(&raster);
+    finder.search(it.first, rasterRes);
+    ASSERT_EQ(rasterRes.size(), res.size());
+    for (std::size_t i = 0; i < res.size(); ++i) {
+        EXPECT_LT(rasterRes[i].position().distance(res[i].position()).t,
+                  1e-3);
+        EXPECT_NEAR(rasterRes[i].time().t, res[i].time().t, 1e-3);
+    }
+}
+
+/*! Expand a state with a constant tidal current
+ * Moves must be the same than with the same gridded current
+ */
+TEST_F(NeighborsFinderFixture, TEST_search_tidal_current)
+{
+    WindVector current(velocity_t(1.), velocity_t(2.));
+    const auto& grid = m_timeWorldMap->values()[1].worldGrid();
+
+    // A zero speed constituent give a constant current
+    TidalCurrentGridBuilder builder(
+      grid.xSpace(),
+      grid.ySpace(),
+      m_timeWorldMap->xSpace(),
+      { TidalConstituent(0., radian_t(0.), 1.) });
+    for (std::size_t lat = 0; lat < 8; ++lat) {
+        for (std::size_t lon = 0; lon < 8; ++lon) {
+            builder.set(lat,
+                        lon,
+                        0,
+                        TidalHarmonic{ current.m_x, radian_t(0.) },
+                        TidalHarmonic{ current.m_y, radian_t(0.) });
+        }
+    }
+    TidalCurrentGrid tidalGrid(builder.build());
+
+    auto it =
+      m_closeList.insert(m_factory->build(m_start, std::chrono::hours(1)));
+
+    std::vector<State> res;
+    m_neighborsFinder->setTidalCurrentGrid(&tidalGrid);
+    m_neighborsFinder->search(it.first, res);
+    ASSERT_EQ(res.size(), 3);
+    EXPECT_EQ(res[0].position(), it.first->position());
+
+    for (std::size_t i = 1; i < 3; ++i) {
+        double heading = (i == 1 ? PI / 4. : -PI / 4.) + PI;
+        double east = m_velocity.t * std::sin(heading) + current.m_x.t;
+        double north = m_velocity.t * std::cos(heading) + current.m_y.t;
+        NVector pos(it.first->position()
+                      .destination(radian_t(std::atan2(east, north)),
+                                   m_distance)
+                      .toEigen());
+        EXPECT_LT(res[i].position().distance(pos).t, 1e-3);
+        EXPECT_NEAR(res[i].time().t,
+                    it.first->time().t +
+                      m_distance.t / std::hypot(east, north),
+                    1e-3);
+    }
+}
+
+/*! Expand a state with wind north of the target
+ * The target is in the no-go zone, the direct shot sail it at the best
+ * velocity made good and end on the target
+ */
+TEST_F(NeighborsFinderFixture, TEST_search_direct_shot)
+{
+    auto pos = m_target.destination(radian_t(0.), meter_t(150.));
+    auto it = m_closeList.insert(m_factory->build(pos, std::chrono::hours(1)));
+
+    // Target is outside of the radius
+    m_neighborsFinder->setDirectShot(meter_t(100.));
+    std::vector<State> res;
+    m_neighborsFinder->search(it.first, res);
+    EXPECT_EQ(res.size(), 3);
+
+    m_neighborsFinder->setDirectShot(meter_t(1000.));
+    res.clear();
+    m_neighborsFinder->search(it.first, res);
+    ASSERT_EQ(res.size(), 4);
+    EXPECT_EQ(res[3].position(), m_target);
+    EXPECT_NEAR(res[3].time().t,
+                it.first->time().t + pos.distance(m_target).t /
+                                       (m_velocity.t * std::cos(PI / 4.)),
+                1e-3);
+    EXPECT_EQ(res[3].h(), cost_t(0.));
+    EXPECT_EQ(res[3].parentState(), it.first->discretState());
+
+    // No wind, the leg is not feasible
+    auto calm =
+      m_closeList.insert(m_factory->build(pos, std::chrono::hours(0)));
+    res.clear();
+    m_neighborsFinder->search(calm.first, res);
+    EXPECT_EQ(res.size(), 1);
+}
@@ -0,0 +1,165 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// includes
+// GTest
+#include <gtest/gtest.h>
+
+// tiny_sea
+#include <tiny_sea/core/boat_velocity_table.h>
+#include <tiny_sea/core/world_map.h>
+#include <tiny_sea/gsp/close_list.h>
+#include <tiny_sea/gsp/neighbors_finder.h>
+#include <tiny_sea/gsp/state_factory.h>
+#include <tiny_sea/gsp/world_map_sample_cache.h>
+
+using namespace tiny_sea;
+using namespace tiny_sea::gsp;
+
+/*! Create a word map with 2 time step and a wind velocity growing with
+ * longitude, 1 m/s by 0.001 radian.
+ */
+class WorldMapSampleCacheFixture : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        TimeWorldMapBuilder timeWorldMapBuilder(
+          makeLinearSpace(fromChrono(std::chrono::seconds(0)),
+                          fromChrono(std::chrono::hours(1)),
+                          2));
+
+        WorldMapGridBuilder gridBuilder(
+          makeLinearSpace(latitude_t(0.), latitude_t(0.001), 10),
+          makeLinearSpace(longitude_t(0.), longitude_t(0.001), 10));
+
+        for (std::size_t i = 0; i < 2; ++i) {
+            for (std::size_t lat = 0; lat < 10; ++lat) {
+                for (std::size_t lon = 0; lon < 10; ++lon) {
+                    gridBuilder(lat, lon) = WorldMapData(
+                      radian_t(PI), velocity_t(double(i + lon)));
+                }
+            }
+            timeWorldMapBuilder.add(WorldMap(gridBuilder.build()));
+        }
+        m_timeWorldMap.reset(new TimeWorldMap(timeWorldMapBuilder.build()));
+    }
+
+    std::unique_ptr<TimeWorldMap> m_timeWorldMap;
+};
+
+/*! Close positions share the same sample
+ */
+TEST_F(WorldMapSampleCacheFixture, TEST_sample)
+{
+    WorldMapSampleCache cache(m_timeWorldMap.get(), meter_t(100.));
+
+    NVector pos1 = NVector::fromLatLon(latitude_t(0.0042), longitude_t(0.0042));
+    NVector pos2 = pos1.destination(radian_t(0.3), meter_t(1.));
+    NVector pos3 = pos1.destination(radian_t(0.3), meter_t(1000.));
+
+    auto data1 = cache.sample(0, pos1);
+    EXPECT_NEAR(data1.windVelocity.t, 4.2, 1e-6);
+    EXPECT_EQ(cache.nrHit(), 0);
+    EXPECT_EQ(cache.nrMiss(), 1);
+
+    // pos2 is in the same cube
+    auto data2 = cache.sample(0, pos2);
+    EXPECT_EQ(data2.windVelocity, data1.windVelocity);
+    EXPECT_EQ(cache.nrHit(), 1);
+    EXPECT_EQ(cache.nrMiss(), 1);
+
+    // Same position in another slice
+    auto data3 = cache.sample(1, pos1);
+    EXPECT_NEAR(data3.windVelocity.t, 5.2, 1e-6);
+    EXPECT_EQ(cache.nrMiss(), 2);
+
+    // pos3 is far away
+    cache.sample(0, pos3);
+    EXPECT_EQ(cache.nrMiss(), 3);
+    EXPECT_EQ(cache.size(), 3);
+
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0);
+    EXPECT_EQ(cache.nrHit(), 0);
+    EXPECT_EQ(cache.nrMiss(), 0);
+}
+
+/*! Sample error must be bounded by the wind gradient on the cube diagonal
+ */
+TEST_F(WorldMapSampleCacheFixture, TEST_tolerance)
+{
+    const double tolerance = 50.;
+    // 1 m/s by 0.001 radian of longitude near equator
+    const double gradient = 1. / (0.001 * EARTH_RADIUS);
+    WorldMapSampleCache cache(m_timeWorldMap.get(), meter_t(tolerance));
+
+    NVector pos = NVector::fromLatLon(latitude_t(0.002), longitude_t(0.002));
+    for (int i = 0; i < 200; ++i) {
+        pos = pos.destination(radian_t(0.1 * i), meter_t(37.));
+        const auto& latLon = pos.toLatLon();
+        const auto& grid = m_timeWorldMap->values()[0].worldGrid();
+        auto expected = grid.safeInterpolated(latLon.first, latLon.second);
+        auto data = cache.sample(0, pos);
+        EXPECT_LE(std::abs((data.windVelocity - expected.windVelocity).t),
+                  gradient * tolerance * std::sqrt(3.) + 1e-9);
+    }
+    EXPECT_GT(cache.nrHit(), 0);
+    EXPECT_EQ(cache.nrHit() + cache.nrMiss(), 200);
+}
+
+/*! NeighborsFinder must find the same neighbors with a cache when wind is
+ * constant around the state
+ */
+TEST_F(WorldMapSampleCacheFixture, TEST_neighbors_finder)
+{
+    BoatVelocityTableBuilder velocityTableBuilder(
+      makeLinearSpace(velocity_t(0.), velocity_t(10.), 3));
+    velocityTableBuilder.addSymetric(
+      radian_t(PI / 4.), { velocity_t(0.), velocity_t(5.), velocity_t(0.) });
+    BoatVelocityTable boatVelocityTable(velocityTableBuilder.build());
+
+    StateFactory factory(std::chrono::minutes(10),
+                         meter_t(50.),
+                         std::chrono::seconds(0),
+                         meter_t(EARTH_RADIUS),
+                         NVector::fromLatLon(latitude_t(0.), longitude_t(0.)),
+                         boatVelocityTable.maxVelocity());
+    NeighborsFinder finder(
+      &factory, m_timeWorldMap.get(), &boatVelocityTable, meter_t(100));
+
+    CloseList closeList;
+    auto it = closeList.insert(factory.build(
+      NVector::fromLatLon(latitude_t(0.004), longitude_t(0.004)),
+      std::chrono::seconds(0)));
+
+    std::vector<State> expected;
+    finder.search(it.first, expected);
+
+    WorldMapSampleCache cache(m_timeWorldMap.get(), meter_t(1.));
+    finder.setSampleCache(&cache);
+    std::vector<State> res;
+    finder.search(it.first, res);
+    finder.search(it.first, res);
+    EXPECT_EQ(cache.nrMiss(), 1);
+    EXPECT_EQ(cache.nrHit(), 1);
+
+    ASSERT_EQ(res.size(), 2 * expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(res[i].position(), expected[i].position());
+        EXPECT_EQ(res[i].time(), expected[i].time());
+    }
+}
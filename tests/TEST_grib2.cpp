@@ -0,0 +1,592 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// includes
+// std
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+
+// GTest
+#include <gtest/gtest.h>
+
+// tiny_sea
+#include <tiny_sea/core/exception.h>
+#include <tiny_sea/core/forecast_file.h>
+#include <tiny_sea/core/grib2.h>
+#include <tiny_sea/core/wind_grid.h>
+#include <tiny_sea/core/world_map.h>
+
+using namespace tiny_sea;
+
+namespace {
+
+using bytes_t = std::vector<std::uint8_t>;
+
+/// Set a big endian value at a GRIB2 octet number
+void
+set(bytes_t& s, std::size_t octet, std::uint64_t value, std::size_t nrOctets)
+{
+    for (std::size_t i = 0; i < nrOctets; ++i) {
+        s[octet - 1 + i] =
+          std::uint8_t(value >> (8 * (nrOctets - 1 - i)) & 0xFF);
+    }
+}
+
+/// Sign and magnitude representation
+std::uint64_t
+signMagnitude(std::int64_t value, std::size_t nrOctets)
+{
+    std::uint64_t sign = std::uint64_t(1) << (8 * nrOctets - 1);
+    return value < 0 ? (sign | std::uint64_t(-value)) : std::uint64_t(value);
+}
+
+bytes_t
+section(std::size_t length, std::uint8_t number)
+{
+    bytes_t s(length, 0);
+    set(s, 1, length, 4);
+    s[4] = number;
+    return s;
+}
+
+class BitWriter
+{
+public:
+    void write(std::uint64_t value, std::size_t nrBits)
+    {
+        for (std::size_t i = nrBits; i > 0; --i) {
+            if (m_pos % 8 == 0) {
+                m_data.push_back(0);
+            }
+            if ((value >> (i - 1)) & 1) {
+                m_data.back() |= std::uint8_t(0x80 >> (m_pos % 8));
+            }
+            ++m_pos;
+        }
+    }
+
+    void align() { m_pos = m_data.size() * 8; }
+
+    const bytes_t& data() const { return m_data; }
+
+private:
+    bytes_t m_data;
+    std::size_t m_pos = 0;
+};
+
+std::size_t
+bitsFor(std::uint64_t value)
+{
+    std::size_t nrBits = 0;
+    for (; value != 0; value >>= 1) {
+        ++nrBits;
+    }
+    return nrBits;
+}
+
+/*! 3 longitudes (10, 11, 12 degrees) by 2 latitudes (40, 41 degrees) grid.
+ * Default scanning mode go from north to south.
+ */
+struct GridDefinition
+{
+    std::size_t ni = 3;
+    std::size_t nj = 2;
+    std::uint32_t scanningMode = 0;
+    std::uint32_t lo1 = 10000000; //< Micro degree
+    std::uint32_t lo2 = 12000000;
+    std::uint32_t di = 1000000;
+
+    bytes_t encode() const
+    {
+        bool south = (scanningMode & 0x40) != 0;
+        auto s = section(72, 3);
+        set(s, 7, ni * nj, 4);
+        set(s, 31, ni, 4);
+        set(s, 35, nj, 4);
+        set(s, 47, south ? 40000000 : 41000000, 4);
+        set(s, 51, lo1, 4);
+        set(s, 56, south ? 41000000 : 40000000, 4);
+        set(s, 60, lo2, 4);
+        set(s, 64, di, 4);
+        set(s, 68, 1000000, 4);
+        set(s, 72, scanningMode, 1);
+        return s;
+    }
+
+    /// Index in scanning order of the (lat, lon) node
+    std::size_t scanIndex(std::size_t lat, std::size_t lon) const
+    {
+        std::size_t j = (scanningMode & 0x40) ? lat : nj - 1 - lat;
+        return (scanningMode & 0x20) ? j + lon * nj : lon + j * ni;
+    }
+};
+
+bytes_t
+productSection(std::uint8_t category, std::uint8_t number, std::uint32_t hour)
+{
+    auto s = section(34, 4);
+    set(s, 10, category, 1);
+    set(s, 11, number, 1);
+    set(s, 18, 1, 1);
+    set(s, 19, hour, 4);
+    set(s, 23, 103, 1);
+    set(s, 25, 10, 4);
+    return s;
+}
+
+/// Simple packing of values scaled by 10 (D = 1)
+std::pair<bytes_t, bytes_t>
+simplePacking(const std::vector<std::int64_t>& scaled)
+{
+    auto minmax = std::minmax_element(scaled.begin(), scaled.end());
+    std::int64_t reference = *minmax.first;
+    std::size_t nrBits = bitsFor(std::uint64_t(*minmax.second - reference));
+
+    auto rep = section(21, 5);
+    set(rep, 6, scaled.size(), 4);
+    set(rep, 10, 0, 2);
+    float r = float(reference);
+    std::uint32_t rBits;
+    std::memcpy(&rBits, &r, sizeof(r));
+    set(rep, 12, rBits, 4);
+    set(rep, 18, 1, 2);
+    set(rep, 20, nrBits, 1);
+
+    BitWriter writer;
+    for (auto v : scaled) {
+        writer.write(std::uint64_t(v - reference), nrBits);
+    }
+    auto data = section(5, 7);
+    data.insert(data.end(), writer.data().begin(), writer.data().end());
+    set(data, 1, data.size(), 4);
+    return std::make_pair(rep, data);
+}
+
+/// Complex packing with spatial differencing of values scaled by 10 (D = 1)
+std::pair<bytes_t, bytes_t>
+complexPacking(const std::vector<std::int64_t>& scaled, std::size_t order)
+{
+    std::vector<std::int64_t> diff(scaled.size(), 0);
+    for (std::size_t i = order; i < scaled.size(); ++i) {
+        diff[i] = order == 1
+                    ? scaled[i] - scaled[i - 1]
+                    : scaled[i] - 2 * scaled[i - 1] + scaled[i - 2];
+    }
+    std::int64_t minimum =
+      *std::min_element(diff.begin() + std::ptrdiff_t(order), diff.end());
+    for (std::size_t i = order; i < diff.size(); ++i) {
+        diff[i] -= minimum;
+    }
+
+    // Groups of 3 values
+    const std::size_t groupLength = 3;
+    std::size_t nrGroups = scaled.size() / groupLength;
+    std::vector<std::uint64_t> references, widths;
+    for (std::size_t g = 0; g < nrGroups; ++g) {
+        auto begin = diff.begin() + std::ptrdiff_t(g * groupLength);
+        auto minmax = std::minmax_element(begin, begin + groupLength);
+        references.push_back(std::uint64_t(*minmax.first));
+        widths.push_back(
+          bitsFor(std::uint64_t(*minmax.second - *minmax.first)));
+    }
+    std::size_t refNrBits =
+      bitsFor(*std::max_element(references.begin(), references.end()));
+
+    auto rep = section(49, 5);
+    set(rep, 6, scaled.size(), 4);
+    set(rep, 10, 3, 2);
+    set(rep, 18, 1, 2);
+    set(rep, 20, refNrBits, 1);
+    set(rep, 32, nrGroups, 4);
+    set(rep, 37, 4, 1);
+    set(rep, 38, groupLength, 4);
+    set(rep, 42, 1, 1);
+    set(rep, 43, groupLength, 4);
+    set(rep, 47, 1, 1);
+    set(rep, 48, order, 1);
+    set(rep, 49, 2, 1);
+
+    BitWriter writer;
+    for (std::size_t i = 0; i < order; ++i) {
+        writer.write(signMagnitude(scaled[i], 2), 16);
+    }
+    writer.write(signMagnitude(minimum, 2), 16);
+    for (auto r : references) {
+        writer.write(r, refNrBits);
+    }
+    writer.align();
+    for (auto w : widths) {
+        writer.write(w, 4);
+    }
+    writer.align();
+    for (std::size_t g = 0; g < nrGroups; ++g) {
+        writer.write(0, 1);
+    }
+    writer.align();
+    for (std::size_t i = 0; i < diff.size(); ++i) {
+        std::size_t g = i / groupLength;
+        writer.write(std::uint64_t(diff[i]) - references[g], widths[g]);
+    }
+
+    auto data = section(5, 7);
+    data.insert(data.end(), writer.data().begin(), writer.data().end());
+    set(data, 1, data.size(), 4);
+    return std::make_pair(rep, data);
+}
+
+bytes_t
+message(std::uint8_t discipline, const std::vector<bytes_t>& sections)
+{
+    bytes_t m = { 'G', 'R', 'I', 'B', 0, 0, discipline, 2 };
+    m.resize(16, 0);
+    auto identification = section(21, 1);
+    m.insert(m.end(), identification.begin(), identification.end());
+    for (const auto& s : sections) {
+        m.insert(m.end(), s.begin(), s.end());
+    }
+    m.insert(m.end(), { '7', '7', '7', '7' });
+    set(m, 9, m.size(), 8);
+    return m;
+}
+
+bytes_t
+noBitmap()
+{
+    auto s = section(6, 6);
+    s[5] = 255;
+    return s;
+}
+
+/// Scaled value of the (lat, lon) node
+std::int64_t
+nodeValue(std::size_t lat, std::size_t lon, std::int64_t seed)
+{
+    return seed + std::int64_t(lat * 7) - std::int64_t(lon * lon * 3);
+}
+
+/// Scaled values of a grid in scanning order
+std::vector<std::int64_t>
+scanValues(const GridDefinition& grid, std::int64_t seed)
+{
+    std::vector<std::int64_t> values(grid.ni * grid.nj);
+    for (std::size_t lat = 0; lat < grid.nj; ++lat) {
+        for (std::size_t lon = 0; lon < grid.ni; ++lon) {
+            values[grid.scanIndex(lat, lon)] = nodeValue(lat, lon, seed);
+        }
+    }
+    return values;
+}
+
+bytes_t
+windMessage(std::uint8_t number,
+            std::uint32_t hour,
+            std::int64_t seed,
+            bool complex = false,
+            const GridDefinition& grid = GridDefinition())
+{
+    auto values = scanValues(grid, seed);
+    auto packing = complex ? complexPacking(values, 2) : simplePacking(values);
+    return message(0,
+                   { grid.encode(),
+                     productSection(2, number, hour),
+                     packing.first,
+                     noBitmap(),
+                     packing.second });
+}
+
+void
+checkField(const Grib2Field& field, std::int64_t seed)
+{
+    const double DEG = PI / 180.;
+    EXPECT_NEAR(field.latSpace.start().t, 40. * DEG, 1e-9);
+    EXPECT_NEAR(field.latSpace.delta().t, 1. * DEG, 1e-9);
+    EXPECT_EQ(field.latSpace.nrPoints(), 2);
+    EXPECT_NEAR(field.lonSpace.start().t, 10. * DEG, 1e-9);
+    EXPECT_NEAR(field.lonSpace.delta().t, 1. * DEG, 1e-9);
+    EXPECT_EQ(field.lonSpace.nrPoints(), 3);
+    ASSERT_EQ(field.values.size(), 6);
+    for (std::size_t lat = 0; lat < 2; ++lat) {
+        for (std::size_t lon = 0; lon < 3; ++lon) {
+            EXPECT_NEAR(field.values[lat + lon * 2],
+                        double(nodeValue(lat, lon, seed)) / 10.,
+                        1e-5);
+        }
+    }
+}
+
+}
+
+TEST(GRIB2_TESTS, TEST_simple_packing)
+{
+    auto m = windMessage(2, 3, -42);
+    auto fields = decodeGrib2Message(m.data(), m.size());
+    ASSERT_EQ(fields.size(), 1);
+    EXPECT_TRUE(fields[0].header.isWindU10m());
+    EXPECT_FALSE(fields[0].header.isWindV10m());
+    EXPECT_EQ(fields[0].header.forecastTime, tiny_sea::time_t(3. * 3600.));
+    checkField(fields[0], -42);
+}
+
+TEST(GRIB2_TESTS, TEST_complex_packing)
+{
+    GridDefinition grid;
+    for (std::size_t order = 1; order <= 2; ++order) {
+        auto values = scanValues(grid, 17);
+        auto packing = complexPacking(values, order);
+        auto m = message(0,
+                         { grid.encode(),
+                           productSection(2, 3, 0),
+                           packing.first,
+                           noBitmap(),
+                           packing.second });
+        auto fields = decodeGrib2Message(m.data(), m.size());
+        ASSERT_EQ(fields.size(), 1);
+        EXPECT_TRUE(fields[0].header.isWindV10m());
+        checkField(fields[0], 17);
+    }
+}
+
+TEST(GRIB2_TESTS, TEST_scanning_mode)
+{
+    for (std::uint32_t mode : { 0x00u, 0x40u, 0x20u, 0x60u }) {
+        GridDefinition grid;
+        grid.scanningMode = mode;
+        auto m = windMessage(2, 0, 5, mode == 0x60u, grid);
+        auto fields = decodeGrib2Message(m.data(), m.size());
+        ASSERT_EQ(fields.size(), 1);
+        checkField(fields[0], 5);
+    }
+}
+
+/*! Global grid from 0 to 270 degrees, columns must be rotated to start at
+ * -180 degrees and the 180 degrees column repeated at the end.
+ */
+TEST(GRIB2_TESTS, TEST_global_longitudes)
+{
+    const double DEG = PI / 180.;
+    GridDefinition grid;
+    grid.ni = 4;
+    grid.lo1 = 0;
+    grid.lo2 = 270000000;
+    grid.di = 90000000;
+
+    auto m = windMessage(2, 0, 5, false, grid);
+    auto fields = decodeGrib2Message(m.data(), m.size());
+    ASSERT_EQ(fields.size(), 1);
+    const auto& field = fields[0];
+    EXPECT_NEAR(field.lonSpace.start().t, -180. * DEG, 1e-9);
+    EXPECT_NEAR(field.lonSpace.delta().t, 90. * DEG, 1e-9);
+    ASSERT_EQ(field.lonSpace.nrPoints(), 5);
+    ASSERT_EQ(field.values.size(), 10);
+    std::size_t columns[5] = { 2, 3, 0, 1, 2 };
+    for (std::size_t lat = 0; lat < 2; ++lat) {
+        for (std::size_t lon = 0; lon < 5; ++lon) {
+            EXPECT_NEAR(field.values[lat + lon * 2],
+                        double(nodeValue(lat, columns[lon], 5)) / 10.,
+                        1e-5);
+        }
+    }
+
+    // Western hemisphere and seam nodes are reachable
+    std::string stream;
+    for (std::uint32_t hour : { 0u, 3u }) {
+        for (std::uint8_t number : { 2, 3 }) {
+            auto wind =
+              windMessage(number, hour, number == 2 ? 5 : 9, false, grid);
+            stream.append(wind.begin(), wind.end());
+        }
+    }
+    std::istringstream in(stream);
+    auto timeWorldMap = decodeGrib2Wind(
+      in,
+      makeLinearSpace(tiny_sea::time_t(0.), tiny_sea::time_t(3. * 3600.), 2),
+      1);
+    const auto& worldMap = timeWorldMap.values()[0];
+    // Original column of each queried longitude
+    for (auto query : { std::make_pair(-90., 3), std::make_pair(0., 0),
+                        std::make_pair(-180., 2), std::make_pair(180., 2) }) {
+        auto res = worldMap.safeInterpolatedVector(
+          latitude_t(41. * DEG), longitude_t(query.first * DEG));
+        double u = double(nodeValue(1, query.second, 5)) / 10.;
+        double v = double(nodeValue(1, query.second, 9)) / 10.;
+        EXPECT_NEAR(res.m_x.t, u, 1e-4) << query.first;
+        EXPECT_NEAR(res.m_y.t, v, 1e-4) << query.first;
+    }
+
+    // Regional grid west of the meridian is shifted
+    GridDefinition west;
+    west.lo1 = 350000000;
+    west.lo2 = 352000000;
+    m = windMessage(2, 0, 5, false, west);
+    fields = decodeGrib2Message(m.data(), m.size());
+    ASSERT_EQ(fields.size(), 1);
+    EXPECT_NEAR(fields[0].lonSpace.start().t, -10. * DEG, 1e-9);
+    EXPECT_EQ(fields[0].lonSpace.nrPoints(), 3);
+
+    // Regional grid crossing the antimeridian
+    GridDefinition crossing;
+    crossing.lo1 = 179000000;
+    crossing.lo2 = 181000000;
+    m = windMessage(2, 0, 5, false, crossing);
+    EXPECT_THROW(decodeGrib2Message(m.data(), m.size()), Exception);
+}
+
+/// Filtered fields are not unpacked, their packing is not checked
+TEST(GRIB2_TESTS, TEST_filter)
+{
+    auto unsupported = section(21, 5);
+    set(unsupported, 10, 40, 2);
+    auto temperature = message(0,
+                               { GridDefinition().encode(),
+                                 productSection(0, 0, 0),
+                                 unsupported,
+                                 noBitmap(),
+                                 section(8, 7) });
+    auto isWind = [](const Grib2FieldHeader& h) {
+        return h.isWindU10m() || h.isWindV10m();
+    };
+    EXPECT_TRUE(
+      decodeGrib2Message(temperature.data(), temperature.size(), isWind)
+        .empty());
+    EXPECT_THROW(decodeGrib2Message(temperature.data(), temperature.size()),
+                 Exception);
+}
+
+/*!
+ * Stream with two slices (0h and 3h) in random order, a temperature field and
+ * garbage between messages.
+ */
+class Grib2StreamFixture : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        std::vector<bytes_t> messages = {
+            windMessage(3, 3, 30, true),
+            windMessage(2, 0, -20),
+            message(0,
+                    { GridDefinition().encode(),
+                      productSection(0, 0, 0),
+                      simplePacking(scanValues(GridDefinition(), 0)).first,
+                      noBitmap(),
+                      simplePacking(scanValues(GridDefinition(), 0)).second }),
+            windMessage(2, 6, 0),
+            windMessage(2, 3, 10, true),
+            windMessage(3, 0, 40),
+        };
+        for (const auto& m : messages) {
+            m_stream.append(m.begin(), m.end());
+            m_stream.append("garbage");
+        }
+    }
+
+    void checkTimeWorldMap(const TimeWorldMap& timeWorldMap)
+    {
+        ASSERT_EQ(timeWorldMap.xSpace().nrPoints(), 2);
+        std::int64_t seeds[2][2] = { { -20, 40 }, { 10, 30 } };
+        for (std::size_t t = 0; t < 2; ++t) {
+            const auto& worldMap = timeWorldMap.values()[t];
+            for (std::size_t lat = 0; lat < 2; ++lat) {
+                for (std::size_t lon = 0; lon < 3; ++lon) {
+                    double u = double(nodeValue(lat, lon, seeds[t][0])) / 10.;
+                    double v = double(nodeValue(lat, lon, seeds[t][1])) / 10.;
+                    WindVector expected{ velocity_t(u), velocity_t(v) };
+                    auto res = worldMap(lat, lon);
+                    EXPECT_NEAR(
+                      res.windVelocity.t, expected.velocity().t, 1e-5);
+                    EXPECT_NEAR(
+                      minDistance(res.windBearing, expected.bearing()).t,
+                      0.,
+                      1e-5);
+                }
+            }
+        }
+    }
+
+    std::string m_stream;
+};
+
+TEST_F(Grib2StreamFixture, TEST_read_message)
+{
+    std::istringstream in(m_stream);
+    std::vector<std::uint8_t> m;
+    std::size_t nrMessages = 0;
+    while (readGrib2Message(in, m)) {
+        ASSERT_GE(m.size(), 20);
+        EXPECT_EQ(std::memcmp(m.data(), "GRIB", 4), 0);
+        EXPECT_EQ(std::memcmp(m.data() + m.size() - 4, "7777", 4), 0);
+        ++nrMessages;
+    }
+    EXPECT_EQ(nrMessages, 6);
+
+    std::istringstream truncated(m_stream.substr(0, 100));
+    EXPECT_THROW(
+      while (readGrib2Message(truncated, m)) {}, Exception);
+}
+
+TEST_F(Grib2StreamFixture, TEST_time_world_map)
+{
+    auto timeSpace =
+      makeLinearSpace(tiny_sea::time_t(0.), tiny_sea::time_t(3. * 3600.), 2);
+    for (std::size_t nrThreads : { 1, 4 }) {
+        std::istringstream in(m_stream);
+        checkTimeWorldMap(decodeGrib2Wind(in, timeSpace, nrThreads));
+    }
+
+    // 6h slice only have the u component
+    std::istringstream in(m_stream);
+    EXPECT_THROW(
+      decodeGrib2Wind(
+        in,
+        makeLinearSpace(
+          tiny_sea::time_t(0.), tiny_sea::time_t(3. * 3600.), 3),
+        4),
+      Exception);
+}
+
+TEST_F(Grib2StreamFixture, TEST_forecast_file)
+{
+    const double DEG = PI / 180.;
+    std::string path = testing::TempDir() + "tiny_sea_grib2.tsf";
+    {
+        ForecastWriter writer(
+          path,
+          makeLinearSpace(
+            tiny_sea::time_t(0.), tiny_sea::time_t(3. * 3600.), 2),
+          makeLinearSpace(latitude_t(40. * DEG), latitude_t(DEG), 2),
+          makeLinearSpace(longitude_t(10. * DEG), longitude_t(DEG), 3));
+        std::istringstream in(m_stream);
+        decodeGrib2Wind(in, writer, 4);
+        writer.close();
+    }
+    checkTimeWorldMap(mapForecast(path));
+
+    // Grid mismatch
+    {
+        ForecastWriter writer(
+          path,
+          makeLinearSpace(
+            tiny_sea::time_t(0.), tiny_sea::time_t(3. * 3600.), 2),
+          makeLinearSpace(latitude_t(40. * DEG), latitude_t(DEG), 3),
+          makeLinearSpace(longitude_t(10. * DEG), longitude_t(DEG), 3));
+        std::istringstream in(m_stream);
+        EXPECT_THROW(decodeGrib2Wind(in, writer, 4), Exception);
+    }
+    std::remove(path.c_str());
+}
@@ -0,0 +1,158 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// includes
+// std
+#include <random>
+#include <vector>
+
+// GTest
+#include <gtest/gtest.h>
+
+// tiny_sea
+#include <tiny_sea/core/exception.h>
+#include <tiny_sea/core/land_mask.h>
+#include <tiny_sea/core/n_vector.h>
+
+using namespace tiny_sea;
+
+/*! 100x70 pixels of 0.001 radian mask with a rectangular island and a
+ * single blocked pixel.
+ */
+class LandMaskFixture : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_blocked.resize(NX * NY);
+        for (std::size_t y = 30; y < 40; ++y) {
+            for (std::size_t x = 40; x < 60; ++x) {
+                m_blocked[x + y * NX] = true;
+            }
+        }
+        m_blocked[90 + 10 * NX] = true;
+    }
+
+    NVector pos(double x, double y) const
+    {
+        return NVector::fromLatLon(latitude_t(0.5 + x * 0.001),
+                                   longitude_t(-0.2 + y * 0.001));
+    }
+
+    static constexpr std::size_t NX = 100;
+    static constexpr std::size_t NY = 70;
+    LinearSpace<latitude_t> m_latSpace{
+        makeLinearSpace(latitude_t(0.5), latitude_t(0.001), NX)
+    };
+    LinearSpace<longitude_t> m_lonSpace{
+        makeLinearSpace(longitude_t(-0.2), longitude_t(0.001), NY)
+    };
+    std::vector<bool> m_blocked;
+};
+
+TEST_F(LandMaskFixture, TEST_pixels)
+{
+    LandMask mask(m_latSpace, m_lonSpace, m_blocked);
+    // 100x70, 50x35, 25x18, 13x9, 7x5, 4x3, 2x2, 1x1
+    EXPECT_EQ(mask.nrLevels(), 8);
+    for (std::size_t y = 0; y < NY; ++y) {
+        for (std::size_t x = 0; x < NX; ++x) {
+            EXPECT_EQ(mask(x, y), m_blocked[x + y * NX]);
+        }
+    }
+
+    EXPECT_TRUE(mask.blocked(pos(45., 35.)));
+    EXPECT_TRUE(mask.blocked(pos(39.6, 29.6)));
+    EXPECT_FALSE(mask.blocked(pos(39.4, 29.6)));
+    EXPECT_TRUE(mask.blocked(pos(90.2, 9.8)));
+    EXPECT_FALSE(mask.blocked(pos(10., 10.)));
+    // Outside of the raster
+    EXPECT_FALSE(mask.blocked(pos(-10., 35.)));
+    EXPECT_FALSE(mask.blocked(pos(45., 80.)));
+
+    EXPECT_THROW(LandMask(m_latSpace, m_lonSpace, std::vector<bool>(10)),
+                 Exception);
+}
+
+TEST_F(LandMaskFixture, TEST_segment)
+{
+    LandMask mask(m_latSpace, m_lonSpace, m_blocked);
+
+    // Cross the island
+    EXPECT_TRUE(mask.blocked(pos(30., 35.), pos(70., 35.)));
+    EXPECT_TRUE(mask.blocked(pos(50., 20.), pos(50., 50.)));
+    // Start on the island
+    EXPECT_TRUE(mask.blocked(pos(45., 35.), pos(20., 10.)));
+    // Pass along the island
+    EXPECT_FALSE(mask.blocked(pos(30., 28.), pos(70., 28.)));
+    EXPECT_FALSE(mask.blocked(pos(35., 20.), pos(35., 50.)));
+    // Pass near the island corner
+    EXPECT_FALSE(mask.blocked(pos(30., 35.), pos(45., 25.)));
+    EXPECT_TRUE(mask.blocked(pos(30., 35.), pos(45., 27.)));
+    // Cross the single pixel
+    EXPECT_TRUE(mask.blocked(pos(85., 5.), pos(95., 15.)));
+    EXPECT_FALSE(mask.blocked(pos(85., 7.), pos(95., 17.)));
+    // Zero length step
+    EXPECT_FALSE(mask.blocked(pos(10., 10.), pos(10., 10.)));
+    // Leave the raster and come back
+    EXPECT_FALSE(mask.blocked(pos(-10., 20.), pos(120., 20.)));
+    EXPECT_TRUE(mask.blocked(pos(-10., 35.), pos(120., 35.)));
+}
+
+/*! Compare segment tests with a dense sampling of the great circle step.
+ * A sampled blocked point must block the step.
+ */
+TEST_F(LandMaskFixture, TEST_segment_sampling)
+{
+    LandMask mask(m_latSpace, m_lonSpace, m_blocked);
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> xDist(-5., 105.);
+    std::uniform_real_distribution<double> yDist(-5., 75.);
+    for (int i = 0; i < 500; ++i) {
+        NVector from = pos(xDist(gen), yDist(gen));
+        NVector to = pos(xDist(gen), yDist(gen));
+
+        bool sampled = false;
+        for (int s = 0; s <= 2000 && !sampled; ++s) {
+            double t = s / 2000.;
+            NVector p(((1. - t) * from.toEigen() + t * to.toEigen())
+                        .normalized());
+            sampled = mask.blocked(p);
+        }
+        if (sampled) {
+            EXPECT_TRUE(mask.blocked(from, to));
+        }
+    }
+}
+
+TEST_F(LandMaskFixture, TEST_depth)
+{
+    std::vector<float> depth(NX * NY, 50.f);
+    depth[10 + 20 * NX] = 0.f;
+    depth[11 + 20 * NX] = 4.f;
+    depth[12 + 20 * NX] = 6.f;
+
+    LandMask mask =
+      LandMask::fromDepth(m_latSpace, m_lonSpace, depth, meter_t(5.));
+    EXPECT_TRUE(mask(10, 20));
+    EXPECT_TRUE(mask(11, 20));
+    EXPECT_FALSE(mask(12, 20));
+    EXPECT_FALSE(mask(13, 20));
+
+    EXPECT_TRUE(mask.blocked(pos(11., 15.), pos(11., 25.)));
+    EXPECT_FALSE(mask.blocked(pos(12., 15.), pos(12., 25.)));
+}
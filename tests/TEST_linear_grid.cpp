@@ -57,6 +57,9 @@ TEST(LINEAR_GRID_TESTS, TEST_builder)
                                  70,
                                  700,
                                  700 }));
+
+    auto moved = std::move(gridBuilder).build();
+    EXPECT_EQ(moved.values(), grid.values());
 }
 
 /*!
@@ -133,3 +136,128 @@ TEST_F(LinearGridFixture, TEST_safeInterpolated)
                 184.8,
                 1e-8);
 }
+
+template<typename Layout>
+class LinearGridLayoutTest : public ::testing::Test
+{};
+
+using Layouts = ::testing::
+  Types<RowMajorLayout, BlockedLayout<4>, BlockedLayout<8>, MortonLayout>;
+TYPED_TEST_SUITE(LinearGridLayoutTest, Layouts);
+
+/// Each point of a grid have its own value index
+TYPED_TEST(LinearGridLayoutTest, TEST_index)
+{
+    for (std::size_t nrX : { 2, 5, 17 }) {
+        for (std::size_t nrY : { 2, 9, 33 }) {
+            std::size_t size = TypeParam::size(nrX, nrY);
+            std::vector<bool> used(size, false);
+            for (std::size_t y = 0; y < nrY; ++y) {
+                for (std::size_t x = 0; x < nrX; ++x) {
+                    std::size_t idx = TypeParam::index(nrX, nrY, x, y);
+                    ASSERT_LT(idx, size);
+                    EXPECT_FALSE(used[idx]);
+                    used[idx] = true;
+                }
+            }
+        }
+    }
+}
+
+/// All layouts give the same results than RowMajorLayout
+TYPED_TEST(LinearGridLayoutTest, TEST_interpolated)
+{
+    auto xSpace = makeLinearSpace(latitude_t(2.), latitude_t(0.5), 11);
+    auto ySpace = makeLinearSpace(longitude_t(10.), longitude_t(0.25), 7);
+    LinearGridBuilder<latitude_t, longitude_t, double> reference(xSpace,
+                                                                 ySpace);
+    LinearGridBuilder<latitude_t,
+                      longitude_t,
+                      double,
+                      NumericInterpolator<double>,
+                      TypeParam>
+      builder(xSpace, ySpace);
+    for (std::size_t x = 0; x < 11; ++x) {
+        for (std::size_t y = 0; y < 7; ++y) {
+            double value = double(x * x) - 3. * double(y) + double(x * y);
+            reference(x, y) = value;
+            builder(x, y) = value;
+        }
+    }
+    auto expected = reference.build();
+    auto grid = builder.build();
+
+    for (std::size_t x = 0; x < 11; ++x) {
+        for (std::size_t y = 0; y < 7; ++y) {
+            EXPECT_EQ(grid(x, y), expected(x, y));
+        }
+    }
+    for (double x = 1.5; x < 8.; x += 0.13) {
+        for (double y = 9.5; y < 12.; y += 0.07) {
+            EXPECT_EQ(grid.safeInterpolated(latitude_t(x), longitude_t(y)),
+                      expected.safeInterpolated(latitude_t(x), longitude_t(y)));
+            EXPECT_EQ(grid.safeAt(latitude_t(x), longitude_t(y)),
+                      expected.safeAt(latitude_t(x), longitude_t(y)));
+        }
+    }
+}
+
+/// Batch interpolation give the scalar results on all layouts
+TYPED_TEST(LinearGridLayoutTest, TEST_batch)
+{
+    auto xSpace = makeLinearSpace(latitude_t(2.), latitude_t(0.5), 11);
+    auto ySpace = makeLinearSpace(longitude_t(10.), longitude_t(0.25), 7);
+    LinearGridBuilder<latitude_t,
+                      longitude_t,
+                      double,
+                      NumericInterpolator<double>,
+                      TypeParam>
+      builder(xSpace, ySpace);
+    for (std::size_t x = 0; x < 11; ++x) {
+        for (std::size_t y = 0; y < 7; ++y) {
+            builder(x, y) = double(x * x) - 3. * double(y) + double(x * y);
+        }
+    }
+    auto grid = builder.build();
+
+    // More than one block with a partial last block
+    const std::size_t size = 150;
+    std::vector<latitude_t> xs;
+    std::vector<longitude_t> ys;
+    for (std::size_t i = 0; i < size; ++i) {
+        xs.emplace_back(1.5 + 7. * double(i) / size);
+        ys.emplace_back(9.5 + 2.5 * double((i * 7) % size) / size);
+    }
+    xs.back() = xSpace.stop();
+    ys.back() = ySpace.stop();
+
+    std::vector<double> res(size);
+    grid.safeInterpolated(xs.data(), ys.data(), size, res.data());
+    for (std::size_t i = 0; i < size; ++i) {
+        EXPECT_NEAR(res[i], grid.safeInterpolated(xs[i], ys[i]), 1e-9);
+    }
+}
+
+/// Non vectorizable values use the interpolator
+TEST(LINEAR_GRID_TESTS, TEST_batch_interpolator)
+{
+    auto xSpace = makeLinearSpace(latitude_t(2.), latitude_t(0.5), 3);
+    auto ySpace = makeLinearSpace(longitude_t(10.), longitude_t(0.5), 3);
+    LinearGridBuilder<latitude_t, longitude_t, int> builder(xSpace, ySpace);
+    for (std::size_t x = 0; x < 3; ++x) {
+        for (std::size_t y = 0; y < 3; ++y) {
+            builder(x, y) = int(x * 10 + y * 100);
+        }
+    }
+    auto grid = builder.build();
+
+    std::vector<latitude_t> xs = { latitude_t(2.), latitude_t(2.25),
+                                   latitude_t(3.), latitude_t(5.) };
+    std::vector<longitude_t> ys = { longitude_t(10.), longitude_t(10.75),
+                                    longitude_t(9.), longitude_t(11.) };
+    std::vector<int> res(xs.size());
+    grid.safeInterpolated(xs.data(), ys.data(), xs.size(), res.data());
+    for (std::size_t i = 0; i < xs.size(); ++i) {
+        EXPECT_EQ(res[i], grid.safeInterpolated(xs[i], ys[i]));
+    }
+}
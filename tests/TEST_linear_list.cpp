@@ -20,6 +20,7 @@
 
 // tiny_sea
 #include <tiny_sea/core/linear_list.h>
+#include <tiny_sea/core/non_uniform_space.h>
 
 using namespace tiny_sea;
 
@@ -33,6 +34,9 @@ TEST(LINEAR_LIST_TESTS, TEST_builder)
 
     auto list = listBuilder.build();
     EXPECT_EQ(list.values(), std::vector<int>({ 3, 5, 5 }));
+
+    auto moved = std::move(listBuilder).build();
+    EXPECT_EQ(moved.values(), list.values());
 }
 
 /*!
@@ -78,3 +82,33 @@ TEST_F(LinearListFixture, TEST_safeInterpolated)
     EXPECT_NEAR(m_list->safeInterpolated(latitude_t(-0.75)), 4., 1e-8);
     EXPECT_NEAR(m_list->safeInterpolated(latitude_t(0.)), 5., 1e-8);
 }
+
+TEST_F(LinearListFixture, TEST_batch)
+{
+    std::vector<latitude_t> xs;
+    for (double x = -2.; x < 1.; x += 0.01) {
+        xs.emplace_back(x);
+    }
+    std::vector<double> res(xs.size());
+    m_list->safeInterpolated(xs.data(), xs.size(), res.data());
+    for (std::size_t i = 0; i < xs.size(); ++i) {
+        EXPECT_NEAR(res[i], m_list->safeInterpolated(xs[i]), 1e-9);
+    }
+}
+
+TEST(LINEAR_LIST_TESTS, TEST_batch_non_uniform)
+{
+    LinearList<latitude_t,
+               double,
+               NumericInterpolator<double>,
+               NonUniformSpace<latitude_t>>
+      list(makeNonUniformSpace<latitude_t>(
+             { latitude_t(0.), latitude_t(1.), latitude_t(4.) }),
+           { 0., 2., 8., 8. });
+
+    std::vector<latitude_t> xs = { latitude_t(-1.), latitude_t(0.5),
+                                   latitude_t(2.5), latitude_t(5.) };
+    std::vector<double> res(xs.size());
+    list.safeInterpolated(xs.data(), xs.size(), res.data());
+    EXPECT_EQ(res, std::vector<double>({ 0., 1., 5., 8. }));
+}
@@ -114,3 +114,23 @@ TEST(LINEAR_SPACE_TESTS, TEST_inside)
     EXPECT_FALSE(space.inside(latitude_t(-5.)));
     EXPECT_FALSE(space.inside(latitude_t(22.)));
 }
+
+TEST(LINEAR_SPACE_TESTS, TEST_safeInterpolations)
+{
+    auto space = makeLinearSpace(latitude_t(-1.), latitude_t(0.5), 7);
+
+    std::vector<latitude_t> t = { latitude_t(-5.),
+                                  latitude_t(-0.75),
+                                  latitude_t(1.3),
+                                  latitude_t(2.),
+                                  latitude_t(22.) };
+    std::vector<std::size_t> index(t.size());
+    std::vector<double> percent(t.size());
+    space.safeInterpolationWeights(
+      t.data(), t.size(), index.data(), percent.data());
+    for (std::size_t i = 0; i < t.size(); ++i) {
+        auto res = space.safeInterpolationWeight(t[i]);
+        EXPECT_EQ(index[i], res.index);
+        EXPECT_NEAR(percent[i], res.percent.t, 1e-8);
+    }
+}
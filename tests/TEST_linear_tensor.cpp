@@ -0,0 +1,204 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// includes
+// GTest
+#include <gtest/gtest.h>
+
+// tiny_sea
+#include <tiny_sea/core/linear_grid.h>
+#include <tiny_sea/core/linear_list.h>
+#include <tiny_sea/core/linear_tensor.h>
+#include <tiny_sea/core/non_uniform_space.h>
+#include <tiny_sea/core/world_map_grid.h>
+
+using namespace tiny_sea;
+
+namespace {
+
+using TimeAxis = TensorAxis<LinearSpace<tiny_sea::time_t>,
+                            NullInterpolator<WorldMapData>>;
+using LatAxis = TensorAxis<LinearSpace<latitude_t>, WorldMapDataInterpolator>;
+using LonAxis = TensorAxis<LinearSpace<longitude_t>, WorldMapDataInterpolator>;
+
+/// time x latitude x longitude tensor, like a TimeWorldMap of WorldMapGrid
+using WorldMapTensor = LinearTensor<WorldMapData, TimeAxis, LatAxis, LonAxis>;
+
+double
+value(std::size_t x, std::size_t y, std::size_t z)
+{
+    return double(x * x) - 3. * double(y) + double(x * y) + 7. * double(z);
+}
+
+}
+
+TEST(LINEAR_TENSOR_TESTS, TEST_order)
+{
+    using Axis = TensorAxis<LinearSpace<scale_t>, NumericInterpolator<int>>;
+    auto space2 = makeLinearSpace(scale_t(0.), scale_t(1.), 2);
+    auto space3 = makeLinearSpace(scale_t(0.), scale_t(1.), 3);
+    auto space4 = makeLinearSpace(scale_t(0.), scale_t(1.), 4);
+
+    LinearTensorBuilder<int, Axis, Axis, Axis> defaultBuilder(
+      std::make_tuple(space2, space3, space4));
+    auto tensor = defaultBuilder.build();
+    EXPECT_EQ(tensor.shape(), (std::array<std::size_t, 3>{ 2, 3, 4 }));
+    EXPECT_EQ(tensor.strides(), (std::array<std::size_t, 3>{ 1, 2, 6 }));
+    EXPECT_EQ(tensor.values().size(), 24);
+
+    LinearTensorBuilder<int, Axis, Axis, Axis> builder(
+      std::make_tuple(space2, space3, space4), { 2, 0, 1 });
+    for (std::size_t x = 0; x < 2; ++x) {
+        for (std::size_t y = 0; y < 3; ++y) {
+            for (std::size_t z = 0; z < 4; ++z) {
+                builder({ x, y, z }) = int(x + 10 * y + 100 * z);
+            }
+        }
+    }
+    tensor = std::move(builder).build();
+    EXPECT_EQ(tensor.strides(), (std::array<std::size_t, 3>{ 4, 8, 1 }));
+    EXPECT_EQ(tensor.values()[1], 100);
+    EXPECT_EQ(tensor.values()[4], 1);
+    EXPECT_EQ(tensor({ 1, 2, 3 }), 321);
+    EXPECT_EQ(tensor.safeAt({ 1, 2, 3 }), 321);
+    EXPECT_THROW(tensor.safeAt({ 2, 0, 0 }), std::out_of_range);
+    EXPECT_THROW(tensor.safeAt({ 0, 0, 4 }), std::out_of_range);
+}
+
+/// One axis tensor interpolate like a LinearList
+TEST(LINEAR_TENSOR_TESTS, TEST_linear_list)
+{
+    using Axis =
+      TensorAxis<LinearSpace<velocity_t>, UnitsInterpolator<velocity_t>>;
+    auto space = makeLinearSpace(velocity_t(0.), velocity_t(2.5), 5);
+    LinearListBuilder<velocity_t, velocity_t, UnitsInterpolator<velocity_t>>
+      listBuilder(space);
+    LinearTensorBuilder<velocity_t, Axis> tensorBuilder(std::make_tuple(space));
+    for (std::size_t i = 0; i < 5; ++i) {
+        listBuilder(i) = velocity_t(double(i * i));
+        tensorBuilder({ i }) = velocity_t(double(i * i));
+    }
+    auto list = listBuilder.build();
+    auto tensor = tensorBuilder.build();
+
+    for (double v = -1.; v < 12.; v += 0.1) {
+        EXPECT_EQ(tensor.safeInterpolated(velocity_t(v)),
+                  list.safeInterpolated(velocity_t(v)));
+    }
+    EXPECT_EQ(tensor.interpolated(velocity_t(10.)), velocity_t(16.));
+}
+
+/// Two axes tensor interpolate like a LinearGrid, whatever the axis order
+TEST(LINEAR_TENSOR_TESTS, TEST_linear_grid)
+{
+    using XAxis =
+      TensorAxis<LinearSpace<latitude_t>, NumericInterpolator<double>>;
+    using YAxis =
+      TensorAxis<LinearSpace<longitude_t>, NumericInterpolator<double>>;
+    auto xSpace = makeLinearSpace(latitude_t(2.), latitude_t(0.5), 11);
+    auto ySpace = makeLinearSpace(longitude_t(10.), longitude_t(0.25), 7);
+
+    LinearGridBuilder<latitude_t, longitude_t, double> gridBuilder(xSpace,
+                                                                   ySpace);
+    LinearTensorBuilder<double, XAxis, YAxis> tensorBuilder(
+      std::make_tuple(xSpace, ySpace));
+    LinearTensorBuilder<double, XAxis, YAxis> transposedBuilder(
+      std::make_tuple(xSpace, ySpace), { 1, 0 });
+    for (std::size_t x = 0; x < 11; ++x) {
+        for (std::size_t y = 0; y < 7; ++y) {
+            gridBuilder(x, y) = value(x, y, 0);
+            tensorBuilder({ x, y }) = value(x, y, 0);
+            transposedBuilder({ x, y }) = value(x, y, 0);
+        }
+    }
+    auto grid = gridBuilder.build();
+    auto tensor = tensorBuilder.build();
+    auto transposed = transposedBuilder.build();
+
+    for (double x = 1.5; x < 8.; x += 0.13) {
+        for (double y = 9.5; y < 12.; y += 0.07) {
+            auto expected =
+              grid.safeInterpolated(latitude_t(x), longitude_t(y));
+            EXPECT_NEAR(tensor.safeInterpolated(latitude_t(x), longitude_t(y)),
+                        expected,
+                        1e-9);
+            EXPECT_NEAR(
+              transposed.safeInterpolated(latitude_t(x), longitude_t(y)),
+              expected,
+              1e-9);
+        }
+    }
+}
+
+/// Time x latitude x longitude tensor snap to the time slice and interpolate
+/// like a WorldMapGrid
+TEST(LINEAR_TENSOR_TESTS, TEST_world_map)
+{
+    auto tSpace =
+      makeLinearSpace(tiny_sea::time_t(0.), tiny_sea::time_t(3600.), 3);
+    auto xSpace = makeLinearSpace(latitude_t(2.), latitude_t(0.5), 5);
+    auto ySpace = makeLinearSpace(longitude_t(10.), longitude_t(0.25), 4);
+
+    std::vector<WorldMapGrid> grids;
+    LinearTensorBuilder<WorldMapData, TimeAxis, LatAxis, LonAxis> builder(
+      std::make_tuple(tSpace, xSpace, ySpace));
+    for (std::size_t t = 0; t < 3; ++t) {
+        WorldMapGridBuilder gridBuilder(xSpace, ySpace);
+        for (std::size_t x = 0; x < 5; ++x) {
+            for (std::size_t y = 0; y < 4; ++y) {
+                WorldMapData data(radian_t(value(x, y, t) / 10.),
+                                  velocity_t(double(x + y + t)));
+                gridBuilder(x, y) = data;
+                builder({ t, x, y }) = data;
+            }
+        }
+        grids.emplace_back(gridBuilder.build());
+    }
+    WorldMapTensor tensor = builder.build();
+
+    for (double t = -100.; t < 8000.; t += 450.) {
+        const auto& grid = grids[tSpace.safeIndex(tiny_sea::time_t(t))];
+        for (double x = 1.5; x < 5.; x += 0.3) {
+            for (double y = 9.5; y < 11.5; y += 0.2) {
+                auto expected =
+                  grid.safeInterpolated(latitude_t(x), longitude_t(y));
+                auto res = tensor.safeInterpolated(
+                  tiny_sea::time_t(t), latitude_t(x), longitude_t(y));
+                EXPECT_NEAR(res.windBearing.t, expected.windBearing.t, 1e-9);
+                EXPECT_NEAR(res.windVelocity.t, expected.windVelocity.t, 1e-9);
+            }
+        }
+    }
+}
+
+/// Axes can use a NonUniformSpace
+TEST(LINEAR_TENSOR_TESTS, TEST_non_uniform)
+{
+    using Axis =
+      TensorAxis<NonUniformSpace<scale_t>, NumericInterpolator<double>>;
+    auto space = makeNonUniformSpace<scale_t>(
+      { scale_t(0.), scale_t(1.), scale_t(4.) });
+    LinearTensorBuilder<double, Axis, Axis> builder(
+      std::make_tuple(space, space));
+    for (std::size_t x = 0; x < 3; ++x) {
+        for (std::size_t y = 0; y < 3; ++y) {
+            builder({ x, y }) = space.value(x).t + 2. * space.value(y).t;
+        }
+    }
+    auto tensor = builder.build();
+    EXPECT_NEAR(tensor.safeInterpolated(scale_t(2.5), scale_t(0.5)), 3.5, 1e-9);
+    EXPECT_NEAR(tensor.safeInterpolated(scale_t(4.), scale_t(3.)), 10., 1e-9);
+}
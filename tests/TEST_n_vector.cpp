@@ -80,3 +80,36 @@ TEST(NVECTOR_TESTS, TEST_destination)
     EXPECT_NEAR(
       (dest.toEigen() - Eigen::Vector3d(0., 1., 0.)).norm(), 0., 1e-8);
 }
+
+TEST(NVECTOR_TESTS, TEST_to_angle)
+{
+    meter_t quarter((EARTH_RADIUS * 2. * PI) / 4.);
+    EXPECT_NEAR(NVector::toAngle(quarter).t, PI / 2., 1e-12);
+}
+
+/*! Validate bearing toward cardinal points and against destination
+ */
+TEST(NVECTOR_TESTS, TEST_bearing)
+{
+    NVector vec = NVector::fromLatLon(latitude_t(0.4), longitude_t(0.2));
+    EXPECT_NEAR(
+      vec.bearing(NVector::fromLatLon(latitude_t(0.5), longitude_t(0.2))).t,
+      0.,
+      1e-8);
+    EXPECT_NEAR(
+      vec.bearing(NVector::fromLatLon(latitude_t(0.4), longitude_t(0.201)))
+        .t,
+      PI / 2.,
+      1e-3);
+    EXPECT_NEAR(
+      std::abs(
+        vec.bearing(NVector::fromLatLon(latitude_t(0.3), longitude_t(0.2)))
+          .t),
+      PI,
+      1e-8);
+
+    for (double bearing : { -2.5, -1., 0.3, 1.2, 3. }) {
+        NVector dest = vec.destination(radian_t(bearing), meter_t(5000.));
+        EXPECT_NEAR(vec.bearing(dest).t, bearing, 1e-8);
+    }
+}
@@ -0,0 +1,132 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// includes
+// std
+#include <random>
+
+// GTest
+#include <gtest/gtest.h>
+
+// tiny_sea
+#include <tiny_sea/core/non_uniform_space.h>
+
+using namespace tiny_sea;
+
+/*!
+ *  [start()  1      2        3      stop()]
+ *   0h       1h     2h       5h     11h
+ */
+class NonUniformSpaceFixture : public ::testing::Test
+{
+protected:
+    NonUniformSpace<tiny_sea::time_t> m_space =
+      makeNonUniformSpace<tiny_sea::time_t>({ tiny_sea::time_t(0.),
+                                               tiny_sea::time_t(3600.),
+                                               tiny_sea::time_t(7200.),
+                                               tiny_sea::time_t(18000.),
+                                               tiny_sea::time_t(39600.) });
+};
+
+TEST_F(NonUniformSpaceFixture, TEST_value)
+{
+    EXPECT_EQ(m_space.nrPoints(), 5);
+    EXPECT_EQ(m_space.start(), tiny_sea::time_t(0.));
+    EXPECT_EQ(m_space.stop(), tiny_sea::time_t(39600.));
+    EXPECT_EQ(m_space.value(3), tiny_sea::time_t(18000.));
+    EXPECT_EQ(m_space.delta(0), tiny_sea::time_t(3600.));
+    EXPECT_EQ(m_space.delta(3), tiny_sea::time_t(21600.));
+}
+
+TEST_F(NonUniformSpaceFixture, TEST_index)
+{
+    EXPECT_EQ(m_space.index(tiny_sea::time_t(0.)), 0);
+    EXPECT_EQ(m_space.index(tiny_sea::time_t(3599.)), 0);
+    EXPECT_EQ(m_space.index(tiny_sea::time_t(3600.)), 1);
+    EXPECT_EQ(m_space.index(tiny_sea::time_t(7200.)), 2);
+    EXPECT_EQ(m_space.index(tiny_sea::time_t(17999.)), 2);
+    EXPECT_EQ(m_space.index(tiny_sea::time_t(18000.)), 3);
+    EXPECT_EQ(m_space.index(tiny_sea::time_t(39599.)), 3);
+    EXPECT_EQ(m_space.index(tiny_sea::time_t(39600.)), 4);
+
+    EXPECT_EQ(m_space.safeIndex(tiny_sea::time_t(-10.)), 0);
+    EXPECT_EQ(m_space.safeIndex(tiny_sea::time_t(50000.)), 4);
+}
+
+TEST_F(NonUniformSpaceFixture, TEST_interpolation)
+{
+    auto res1 = m_space.interpolationWeight(tiny_sea::time_t(1800.));
+    EXPECT_NEAR(res1.percent.t, 0.5, 1e-8);
+    EXPECT_EQ(res1.index, 0);
+
+    auto res2 = m_space.interpolationWeight(tiny_sea::time_t(25200.));
+    EXPECT_NEAR(res2.percent.t, 1. / 3., 1e-8);
+    EXPECT_EQ(res2.index, 3);
+
+    auto res3 = m_space.safeInterpolationWeight(tiny_sea::time_t(50000.));
+    EXPECT_NEAR(res3.percent.t, 0., 1e-8);
+    EXPECT_EQ(res3.index, 4);
+
+    EXPECT_TRUE(m_space.inside(tiny_sea::time_t(20000.)));
+    EXPECT_FALSE(m_space.inside(tiny_sea::time_t(-1.)));
+}
+
+/// Uniform space give the same result than LinearSpace
+TEST(NON_UNIFORM_SPACE_TESTS, TEST_linear_space)
+{
+    auto linear = makeLinearSpace(latitude_t(-1.), latitude_t(0.1), 37);
+    NonUniformSpace<latitude_t> space(linear);
+    EXPECT_EQ(space.nrPoints(), linear.nrPoints());
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(-1.5, 3.);
+    for (int i = 0; i < 1000; ++i) {
+        latitude_t t(dist(gen));
+        auto expected = linear.safeInterpolationWeight(t);
+        auto res = space.safeInterpolationWeight(t);
+        EXPECT_EQ(res.index, expected.index);
+        EXPECT_NEAR(res.percent.t, expected.percent.t, 1e-6);
+    }
+}
+
+/// Very irregular spaces have more than one point by bucket
+TEST(NON_UNIFORM_SPACE_TESTS, TEST_irregular)
+{
+    std::vector<double> raw = { 0., 1e-3, 2e-3, 10., 1000., 1000.5, 5000. };
+    std::vector<latitude_t> values;
+    for (double v : raw) {
+        values.emplace_back(v);
+    }
+    auto space = makeNonUniformSpace(values);
+    for (std::size_t i = 0; i < raw.size(); ++i) {
+        EXPECT_EQ(space.index(values[i]), i);
+        if (i + 1 < raw.size()) {
+            latitude_t middle((raw[i] + raw[i + 1]) / 2.);
+            EXPECT_EQ(space.index(middle), i);
+        }
+    }
+}
+
+TEST(NON_UNIFORM_SPACE_TESTS, TEST_safe_make)
+{
+    EXPECT_THROW(safeMakeNonUniformSpace<latitude_t>({ latitude_t(1.) }),
+                 Exception);
+    EXPECT_THROW(safeMakeNonUniformSpace<latitude_t>(
+                   { latitude_t(1.), latitude_t(2.), latitude_t(2.) }),
+                 Exception);
+    EXPECT_NO_THROW(
+      safeMakeNonUniformSpace<latitude_t>({ latitude_t(1.), latitude_t(2.) }));
+}
@@ -0,0 +1,221 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// includes
+// std
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+// GTest
+#include <gtest/gtest.h>
+
+// tiny_sea
+#include <tiny_sea/core/exception.h>
+#include <tiny_sea/core/forecast_file.h>
+#include <tiny_sea/core/paged_wind_grid.h>
+#include <tiny_sea/core/world_map.h>
+
+using namespace tiny_sea;
+
+/// 10 latitudes by 13 longitudes grid with 2 slices
+class PagedWindGridFixture : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_path = testing::TempDir() + "tiny_sea_paged.tsf";
+
+        auto latSpace = makeLinearSpace(latitude_t(-1.), latitude_t(0.1), 10);
+        auto lonSpace =
+          makeLinearSpace(longitude_t(2.), longitude_t(0.05), 13);
+        TimeWorldMapBuilder builder(makeLinearSpace(
+          tiny_sea::time_t(0.), tiny_sea::time_t(3600.), 2));
+        for (std::size_t t = 0; t < 2; ++t) {
+            WorldMapGridBuilder gridBuilder(latSpace, lonSpace);
+            for (std::size_t lat = 0; lat < 10; ++lat) {
+                for (std::size_t lon = 0; lon < 13; ++lon) {
+                    gridBuilder(lat, lon) = WorldMapData(
+                      radian_t(double(lat * 3 + lon + t) * 0.2),
+                      velocity_t(double(1 + lat + lon % 4 + 5 * t)));
+                }
+            }
+            builder.add(WorldMap(gridBuilder.build()));
+        }
+        writeForecast(m_path, builder.build());
+        m_mapped.reset(new TimeWorldMap(mapForecast(m_path)));
+    }
+
+    void TearDown() override { std::remove(m_path.c_str()); }
+
+    /// Compare \p timeWorldMap against the fully mapped forecast
+    void compare(const TimeWorldMap& timeWorldMap)
+    {
+        for (std::size_t t = 0; t < 2; ++t) {
+            const auto& expected = m_mapped->values()[t];
+            const auto& res = timeWorldMap.values()[t];
+            for (double lat = -1.1; lat <= 0.0; lat += 0.013) {
+                for (double lon = 1.95; lon <= 2.65; lon += 0.011) {
+                    auto e = expected.safeInterpolated(latitude_t(lat),
+                                                       longitude_t(lon));
+                    auto r =
+                      res.safeInterpolated(latitude_t(lat), longitude_t(lon));
+                    EXPECT_NEAR(r.windVelocity.t, e.windVelocity.t, 1e-6);
+                    EXPECT_NEAR(
+                      minDistance(r.windBearing, e.windBearing).t, 0., 1e-6);
+                }
+            }
+            for (std::size_t lat = 0; lat < 10; ++lat) {
+                for (std::size_t lon = 0; lon < 13; ++lon) {
+                    EXPECT_EQ(res(lat, lon).windVelocity,
+                              expected(lat, lon).windVelocity);
+                }
+            }
+        }
+    }
+
+    std::string m_path;
+    std::unique_ptr<TimeWorldMap> m_mapped;
+};
+
+TEST_F(PagedWindGridFixture, TEST_interpolation)
+{
+    for (std::size_t tileSize : { 1, 3, 4, 32 }) {
+        auto forecast = std::make_shared<PagedForecast>(m_path, tileSize);
+        auto timeWorldMap = pagedTimeWorldMap(forecast);
+        EXPECT_EQ(timeWorldMap.xSpace().nrPoints(), 2);
+        EXPECT_EQ(timeWorldMap.values()[0].latSpace().nrPoints(), 10);
+        EXPECT_EQ(timeWorldMap.values()[0].lonSpace().nrPoints(), 13);
+        compare(timeWorldMap);
+        EXPECT_EQ(forecast->stats().nrEvicted, 0);
+    }
+}
+
+TEST_F(PagedWindGridFixture, TEST_stats)
+{
+    // 4x4 cells tiles, 3 latitude tiles and 4 longitude tiles by slice
+    auto forecast = std::make_shared<PagedForecast>(m_path, 4);
+    auto timeWorldMap = pagedTimeWorldMap(forecast);
+    const auto& worldMap = timeWorldMap.values()[0];
+
+    // Only the touched tile is loaded
+    worldMap.safeInterpolated(latitude_t(-0.95), longitude_t(2.01));
+    auto stats = forecast->stats();
+    EXPECT_EQ(stats.nrMiss, 1);
+    EXPECT_EQ(stats.nrHit, 0);
+    EXPECT_EQ(stats.memory, 2 * 5 * 5 * sizeof(float));
+
+    worldMap.safeInterpolated(latitude_t(-0.75), longitude_t(2.12));
+    worldMap(3, 3);
+    stats = forecast->stats();
+    EXPECT_EQ(stats.nrMiss, 1);
+    EXPECT_EQ(stats.nrHit, 2);
+
+    // Border tile is smaller
+    worldMap.safeInterpolated(latitude_t(1.), longitude_t(3.));
+    stats = forecast->stats();
+    EXPECT_EQ(stats.nrMiss, 2);
+    EXPECT_EQ(stats.memory, 2 * (5 * 5 + 3 * 2) * sizeof(float));
+
+    forecast->clear();
+    stats = forecast->stats();
+    EXPECT_EQ(stats.nrMiss, 0);
+    EXPECT_EQ(stats.memory, 0);
+}
+
+TEST_F(PagedWindGridFixture, TEST_memory_cap)
+{
+    // Room for two full tiles
+    std::size_t cap = 2 * 2 * 5 * 5 * sizeof(float);
+    auto forecast = std::make_shared<PagedForecast>(m_path, 4, cap);
+    auto timeWorldMap = pagedTimeWorldMap(forecast);
+    compare(timeWorldMap);
+
+    auto stats = forecast->stats();
+    EXPECT_LE(stats.memory, cap);
+    EXPECT_GT(stats.nrEvicted, 0);
+    // Two full tiles or up to three smaller border tiles
+    EXPECT_LE(stats.nrMiss - stats.nrEvicted, 3);
+
+    // Cap smaller than a tile still keep the last tile
+    forecast = std::make_shared<PagedForecast>(m_path, 4, 1);
+    compare(pagedTimeWorldMap(forecast));
+    stats = forecast->stats();
+    EXPECT_EQ(stats.nrMiss - stats.nrEvicted, 1);
+    EXPECT_GT(stats.memory, 1);
+}
+
+TEST_F(PagedWindGridFixture, TEST_concurrent)
+{
+    // Small cap to mix hits, loads and evictions between threads
+    std::size_t cap = 2 * 2 * 5 * 5 * sizeof(float);
+    auto forecast = std::make_shared<PagedForecast>(m_path, 4, cap);
+    auto timeWorldMap = pagedTimeWorldMap(forecast);
+
+    std::size_t nrThreads = 4;
+    std::vector<std::size_t> nrErrors(nrThreads, 0);
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < nrThreads; ++i) {
+        threads.emplace_back([&, i]() {
+            for (std::size_t t = 0; t < 2; ++t) {
+                const auto& expected = m_mapped->values()[t];
+                const auto& res = timeWorldMap.values()[t];
+                for (double lat = -1.1 + 0.003 * double(i); lat <= 0.0;
+                     lat += 0.013) {
+                    for (double lon = 1.95; lon <= 2.65; lon += 0.011) {
+                        auto e = expected.safeInterpolated(latitude_t(lat),
+                                                           longitude_t(lon));
+                        auto r = res.safeInterpolated(latitude_t(lat),
+                                                      longitude_t(lon));
+                        if (std::abs(r.windVelocity.t - e.windVelocity.t) >
+                            1e-6) {
+                            ++nrErrors[i];
+                        }
+                    }
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (std::size_t nrError : nrErrors) {
+        EXPECT_EQ(nrError, 0);
+    }
+    auto stats = forecast->stats();
+    EXPECT_LE(stats.memory, cap);
+    EXPECT_GT(stats.nrHit, 0);
+    EXPECT_GT(stats.nrEvicted, 0);
+}
+
+TEST_F(PagedWindGridFixture, TEST_invalid)
+{
+    EXPECT_THROW(PagedForecast(m_path + ".missing"), Exception);
+
+    // Current planes are not paged
+    {
+        ForecastWriter writer(
+          m_path,
+          makeLinearSpace(tiny_sea::time_t(0.), tiny_sea::time_t(3600.), 2),
+          m_mapped->values()[0].latSpace(),
+          m_mapped->values()[0].lonSpace(),
+          true);
+        writer.close();
+    }
+    EXPECT_THROW(PagedForecast{ m_path }, Exception);
+}
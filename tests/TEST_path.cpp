@@ -0,0 +1,72 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// includes
+// GTest
+#include <gtest/gtest.h>
+
+// tiny_sea
+#include <tiny_sea/core/exception.h>
+#include <tiny_sea/core/path.h>
+
+using namespace tiny_sea;
+
+TEST(PATH_TESTS, TEST_from_nvector)
+{
+    NVector start = NVector::fromLatLon(latitude_t(0.), longitude_t(0.));
+    Path path = Path::fromNVector(
+      start, NVector::fromLatLon(latitude_t(0.), longitude_t(0.1)));
+    EXPECT_EQ(path.nvector, start);
+    EXPECT_NEAR(path.bearing.t, PI / 2., 1e-8);
+    // Equator normal
+    EXPECT_NEAR((path.normal() - Eigen::Vector3d(0., 0., 1.)).norm(), 0., 1e-8);
+}
+
+/*! Equator and Greenwich meridian cross on (0, 0) and (0, pi)
+ */
+TEST(PATH_TESTS, TEST_intersection)
+{
+    Path equator(NVector::fromLatLon(latitude_t(0.), longitude_t(0.3)),
+                 radian_t(-PI / 2.));
+    Path meridian(NVector::fromLatLon(latitude_t(0.7), longitude_t(0.)),
+                  radian_t(PI));
+
+    NVector res = equator.intersection(meridian);
+    EXPECT_NEAR((res.toEigen() - Eigen::Vector3d(1., 0., 0.)).norm(), 0., 1e-8);
+    res = meridian.intersection(equator);
+    EXPECT_NEAR((res.toEigen() - Eigen::Vector3d(1., 0., 0.)).norm(), 0., 1e-8);
+
+    // Start nearer the antipodal point
+    Path farEquator(NVector::fromLatLon(latitude_t(0.), longitude_t(2.8)),
+                    radian_t(PI / 2.));
+    res = farEquator.intersection(meridian);
+    EXPECT_NEAR(
+      (res.toEigen() - Eigen::Vector3d(-1., 0., 0.)).norm(), 0., 1e-8);
+
+    // Intersection is on both great circles
+    NVector a = NVector::fromLatLon(latitude_t(0.4), longitude_t(0.1));
+    NVector b = NVector::fromLatLon(latitude_t(0.45), longitude_t(0.2));
+    NVector c = NVector::fromLatLon(latitude_t(0.5), longitude_t(0.12));
+    NVector d = NVector::fromLatLon(latitude_t(0.38), longitude_t(0.17));
+    Path p1 = Path::fromNVector(a, b);
+    Path p2 = Path::fromNVector(c, d);
+    res = p1.intersection(p2);
+    EXPECT_NEAR(p1.normal().dot(res.toEigen()), 0., 1e-12);
+    EXPECT_NEAR(p2.normal().dot(res.toEigen()), 0., 1e-12);
+    EXPECT_NEAR(Path::fromNVector(a, res).bearing.t, p1.bearing.t, 1e-8);
+
+    EXPECT_THROW(equator.intersection(equator), Exception);
+}
@@ -0,0 +1,153 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// includes
+// GTest
+#include <gtest/gtest.h>
+
+// tiny_sea
+#include <tiny_sea/core/quantized_wind_grid.h>
+#include <tiny_sea/core/wind_grid.h>
+#include <tiny_sea/core/world_map.h>
+
+using namespace tiny_sea;
+
+TEST(QUANTIZATION_TESTS, TEST_range)
+{
+    auto q = Quantization::fromRange(-10.f, 30.f);
+    EXPECT_EQ(q.quantize(-10.f), -Quantization::MAX_VALUE);
+    EXPECT_EQ(q.quantize(30.f), Quantization::MAX_VALUE);
+    EXPECT_EQ(q.quantize(10.f), 0);
+    EXPECT_EQ(q.quantize(100.f), Quantization::MAX_VALUE);
+    EXPECT_NEAR(q.dequantize(q.quantize(3.3f)), 3.3f, q.scale / 2.f);
+
+    // Constant plane
+    q = Quantization::fromRange(2.f, 2.f);
+    EXPECT_EQ(q.dequantize(q.quantize(2.f)), 2.f);
+}
+
+/*! Create a 20x30 world map grid with a rotating wind
+ */
+class QuantizedWindGridFixture : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        WorldMapGridBuilder builder(
+          makeLinearSpace(latitude_t(0.), latitude_t(0.01), 20),
+          makeLinearSpace(longitude_t(0.), longitude_t(0.01), 30));
+        for (std::size_t lat = 0; lat < 20; ++lat) {
+            for (std::size_t lon = 0; lon < 30; ++lon) {
+                builder(lat, lon) =
+                  WorldMapData(radian_t(0.3 * double(lat + 2 * lon)),
+                               velocity_t(2. + double((lat * lon) % 17)));
+            }
+        }
+        m_worldGrid.reset(new WorldMapGrid(builder.build()));
+        m_grid.reset(new QuantizedWindGrid(*m_worldGrid));
+    }
+
+    std::unique_ptr<WorldMapGrid> m_worldGrid;
+    std::unique_ptr<QuantizedWindGrid> m_grid;
+};
+
+TEST_F(QuantizedWindGridFixture, TEST_nodes)
+{
+    double maxError = std::hypot(m_grid->uQuantization().scale,
+                                 m_grid->vQuantization().scale);
+    for (std::size_t lat = 0; lat < 20; ++lat) {
+        for (std::size_t lon = 0; lon < 30; ++lon) {
+            auto expected = (*m_worldGrid)(lat, lon);
+            auto res = (*m_grid)(lat, lon);
+            EXPECT_NEAR(res.windVelocity.t, expected.windVelocity.t, maxError);
+        }
+    }
+}
+
+/// Node currents are quantized in their own planes
+TEST_F(QuantizedWindGridFixture, TEST_current)
+{
+    EXPECT_FALSE(m_grid->hasCurrent());
+    EXPECT_EQ(m_grid->safeInterpolated(latitude_t(0.05), longitude_t(0.05))
+                .current.velocity(),
+              velocity_t(0.));
+
+    WorldMapGridBuilder builder(m_worldGrid->xSpace(), m_worldGrid->ySpace());
+    for (std::size_t lat = 0; lat < 20; ++lat) {
+        for (std::size_t lon = 0; lon < 30; ++lon) {
+            auto data = (*m_worldGrid)(lat, lon);
+            data.current = WindVector(velocity_t(0.1 * double(lat)),
+                                      velocity_t(-0.05 * double(lon)));
+            builder(lat, lon) = data;
+        }
+    }
+    WorldMapGrid worldGrid(builder.build());
+    QuantizedWindGrid grid(worldGrid);
+    ASSERT_TRUE(grid.hasCurrent());
+    EXPECT_EQ(grid.memory(), 2 * m_grid->memory());
+
+    float uError = grid.currentUQuantization().scale;
+    float vError = grid.currentVQuantization().scale;
+    for (std::size_t lat = 0; lat < 20; ++lat) {
+        for (std::size_t lon = 0; lon < 30; ++lon) {
+            auto expected = worldGrid(lat, lon).current;
+            auto res = grid(lat, lon).current;
+            EXPECT_NEAR(res.m_x.t, expected.m_x.t, uError);
+            EXPECT_NEAR(res.m_y.t, expected.m_y.t, vError);
+        }
+    }
+
+    // Linear current, interpolated exactly up to the quantization
+    auto res = grid.safeInterpolated(latitude_t(0.055), longitude_t(0.1225));
+    EXPECT_NEAR(res.current.m_x.t, 0.55, uError);
+    EXPECT_NEAR(res.current.m_y.t, -0.6125, vError);
+
+    // The world map keep the current
+    EXPECT_NEAR(WorldMap(grid).maxCurrentVelocity().t,
+                std::hypot(1.9, 1.45),
+                uError + vError);
+}
+
+/*! Quantized grid error must be bounded by the quantization steps and
+ * float grid error must be smaller
+ */
+TEST_F(QuantizedWindGridFixture, TEST_error)
+{
+    auto error = measureError(*m_worldGrid, *m_grid);
+    EXPECT_EQ(error.nrSamples, 19 * 29 * 16 + 19 * 4 + 29 * 4 + 1);
+    EXPECT_LT(error.maxVelocity.t,
+              std::hypot(m_grid->uQuantization().scale,
+                         m_grid->vQuantization().scale));
+    EXPECT_LE(error.rmsVelocity, error.maxVelocity);
+
+    auto floatError = measureError(*m_worldGrid, WindGrid(*m_worldGrid));
+    EXPECT_LT(floatError.maxVelocity, error.maxVelocity);
+
+    // 32 bytes by cell for WorldMapData with its current, 4 bytes for
+    // QuantizedWindGrid
+    EXPECT_EQ(m_grid->memory() * 8,
+              m_worldGrid->values().size() * sizeof(WorldMapData));
+}
+
+TEST_F(QuantizedWindGridFixture, TEST_world_map)
+{
+    WorldMap worldMap(*m_grid);
+    auto expected = m_grid->safeInterpolated(latitude_t(0.055),
+                                             longitude_t(0.123));
+    auto res = worldMap.safeInterpolated(latitude_t(0.055), longitude_t(0.123));
+    EXPECT_EQ(res.windBearing, expected.windBearing);
+    EXPECT_EQ(res.windVelocity, expected.windVelocity);
+}
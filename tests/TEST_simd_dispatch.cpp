@@ -0,0 +1,193 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// includes
+// std
+#include <random>
+#include <vector>
+
+// GTest
+#include <gtest/gtest.h>
+
+// tiny_sea
+#include <tiny_sea/core/exception.h>
+#include <tiny_sea/core/n_vector.h>
+#include <tiny_sea/core/simd_dispatch.h>
+
+using namespace tiny_sea;
+
+namespace {
+
+const simd::Isa ALL_ISA[] = { simd::Isa::SCALAR,
+                              simd::Isa::SSE42,
+                              simd::Isa::AVX2,
+                              simd::Isa::AVX512 };
+
+// Odd size to exercise vector loops remainder
+const std::size_t SIZE = 203;
+
+std::vector<double>
+randomValues(std::mt19937& gen, double min, double max, std::size_t size)
+{
+    std::uniform_real_distribution<double> dist(min, max);
+    std::vector<double> values(size);
+    for (double& v : values) {
+        v = dist(gen);
+    }
+    return values;
+}
+
+}
+
+TEST(SIMD_DISPATCH_TESTS, TEST_best)
+{
+    const auto& kernels = simd::kernels();
+    EXPECT_TRUE(simd::supported(kernels.isa));
+    EXPECT_EQ(&kernels, &simd::kernels(kernels.isa));
+    EXPECT_TRUE(simd::supported(simd::Isa::SCALAR));
+
+    for (simd::Isa isa : ALL_ISA) {
+        if (!simd::supported(isa)) {
+            EXPECT_THROW(simd::kernels(isa), Exception);
+        }
+    }
+}
+
+TEST(SIMD_DISPATCH_TESTS, TEST_lerp)
+{
+    std::mt19937 gen(42);
+    auto v0 = randomValues(gen, -10., 10., SIZE);
+    auto v1 = randomValues(gen, -10., 10., SIZE);
+    double percent = 0.37;
+
+    std::vector<double> ref(SIZE);
+    simd::kernels(simd::Isa::SCALAR)
+      .lerp(v0.data(), v1.data(), percent, SIZE, ref.data());
+    for (std::size_t i = 0; i < SIZE; ++i) {
+        EXPECT_NEAR(ref[i], v0[i] + (v1[i] - v0[i]) * percent, 1e-12);
+    }
+
+    for (simd::Isa isa : ALL_ISA) {
+        if (!simd::supported(isa)) {
+            continue;
+        }
+        SCOPED_TRACE(simd::isaName(isa));
+        std::vector<double> res(SIZE);
+        simd::kernels(isa).lerp(v0.data(), v1.data(), percent, SIZE,
+                                res.data());
+        EXPECT_EQ(res, ref);
+    }
+}
+
+TEST(SIMD_DISPATCH_TESTS, TEST_bilinear)
+{
+    const std::size_t rowSize = 11;
+    const std::size_t nrRows = 7;
+    std::mt19937 gen(42);
+    std::vector<float> plane(rowSize * nrRows);
+    std::uniform_real_distribution<float> valueDist(-20.f, 20.f);
+    for (float& v : plane) {
+        v = valueDist(gen);
+    }
+
+    std::uniform_int_distribution<std::size_t> xDist(0, rowSize - 2);
+    std::uniform_int_distribution<std::size_t> yDist(0, nrRows - 2);
+    std::uniform_real_distribution<float> percentDist(0.f, 1.f);
+    std::vector<std::size_t> idx00(SIZE);
+    std::vector<float> pX(SIZE), pY(SIZE);
+    for (std::size_t i = 0; i < SIZE; ++i) {
+        idx00[i] = xDist(gen) + yDist(gen) * rowSize;
+        pX[i] = percentDist(gen);
+        pY[i] = percentDist(gen);
+    }
+
+    std::vector<float> ref(SIZE);
+    simd::kernels(simd::Isa::SCALAR)
+      .bilinear(plane.data(), rowSize, idx00.data(), pX.data(), pY.data(),
+                SIZE, ref.data());
+    for (std::size_t i = 0; i < SIZE; ++i) {
+        const float* c = plane.data() + idx00[i];
+        float y0 = c[0] + (c[1] - c[0]) * pX[i];
+        float y1 = c[rowSize] + (c[rowSize + 1] - c[rowSize]) * pX[i];
+        EXPECT_NEAR(ref[i], y0 + (y1 - y0) * pY[i], 1e-5);
+    }
+
+    for (simd::Isa isa : ALL_ISA) {
+        if (!simd::supported(isa)) {
+            continue;
+        }
+        SCOPED_TRACE(simd::isaName(isa));
+        std::vector<float> res(SIZE);
+        simd::kernels(isa).bilinear(plane.data(), rowSize, idx00.data(),
+                                    pX.data(), pY.data(), SIZE, res.data());
+        EXPECT_EQ(res, ref);
+    }
+}
+
+TEST(SIMD_DISPATCH_TESTS, TEST_destination_distance)
+{
+    std::mt19937 gen(42);
+    NVector origin =
+      NVector::fromLatLon(latitude_t(0.71), longitude_t(-0.23));
+    meter_t dist(12000.);
+    auto bearingValues = randomValues(gen, -PI, PI, SIZE);
+    std::vector<radian_t> bearings;
+    for (double b : bearingValues) {
+        bearings.push_back(radian_t(b));
+    }
+
+    // Batch helpers against the NVector scalar methods
+    std::vector<NVector> dest(SIZE);
+    origin.destinations(bearings.data(), dist, SIZE, dest.data());
+    std::vector<meter_t> dists(SIZE);
+    origin.distances(dest.data(), SIZE, dists.data());
+    for (std::size_t i = 0; i < SIZE; ++i) {
+        NVector expected = origin.destination(bearings[i], dist);
+        EXPECT_NEAR((dest[i].toEigen() - expected.toEigen()).norm(),
+                    0.,
+                    1e-12);
+        EXPECT_NEAR(dists[i].t, origin.distance(dest[i]).t, 1e-6);
+    }
+
+    // Variants against the scalar reference
+    const double o[3] = { origin.x(), origin.y(), origin.z() };
+    double angle = dist.t / EARTH_RADIUS;
+    const auto& scalar = simd::kernels(simd::Isa::SCALAR);
+    std::vector<double> refX(SIZE), refY(SIZE), refZ(SIZE), refD(SIZE);
+    scalar.destination(o, bearingValues.data(), angle, SIZE, refX.data(),
+                       refY.data(), refZ.data());
+    scalar.distance(o, refX.data(), refY.data(), refZ.data(), SIZE,
+                    refD.data());
+
+    for (simd::Isa isa : ALL_ISA) {
+        if (!simd::supported(isa)) {
+            continue;
+        }
+        SCOPED_TRACE(simd::isaName(isa));
+        const auto& kernels = simd::kernels(isa);
+        std::vector<double> x(SIZE), y(SIZE), z(SIZE), d(SIZE);
+        kernels.destination(o, bearingValues.data(), angle, SIZE, x.data(),
+                            y.data(), z.data());
+        kernels.distance(o, refX.data(), refY.data(), refZ.data(), SIZE,
+                         d.data());
+        for (std::size_t i = 0; i < SIZE; ++i) {
+            EXPECT_NEAR(x[i], refX[i], 1e-15);
+            EXPECT_NEAR(y[i], refY[i], 1e-15);
+            EXPECT_NEAR(z[i], refZ[i], 1e-15);
+            EXPECT_NEAR(d[i], refD[i], 1e-15);
+        }
+    }
+}
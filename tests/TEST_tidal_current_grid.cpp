@@ -0,0 +1,193 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// includes
+// std
+#include <cmath>
+#include <vector>
+
+// GTest
+#include <gtest/gtest.h>
+
+// tiny_sea
+#include <tiny_sea/core/exception.h>
+#include <tiny_sea/core/tidal_current_grid.h>
+
+using namespace tiny_sea;
+
+/*! 3x2 nodes grid with M2 and K1 constituents over 3 days of 1h slices.
+ * Amplitudes and phase lags grow with latitude.
+ */
+class TidalCurrentGridFixture : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        TidalCurrentGridBuilder builder(m_latSpace,
+                                        m_lonSpace,
+                                        m_timeSpace,
+                                        m_constituents);
+        for (std::size_t x = 0; x < 3; ++x) {
+            for (std::size_t y = 0; y < 2; ++y) {
+                for (std::size_t k = 0; k < 2; ++k) {
+                    builder.set(x, y, k, uHarmonic(x, y, k), vHarmonic(x, k));
+                }
+            }
+        }
+        m_grid.reset(new TidalCurrentGrid(builder.build()));
+    }
+
+    static TidalHarmonic uHarmonic(std::size_t x, std::size_t y, std::size_t k)
+    {
+        return TidalHarmonic{ velocity_t(1. + double(x) + 0.5 * double(y)),
+                              radian_t(0.3 * double(x + k)) };
+    }
+
+    static TidalHarmonic vHarmonic(std::size_t x, std::size_t k)
+    {
+        return TidalHarmonic{ velocity_t(0.5 / double(k + 1)),
+                              radian_t(1. + 0.2 * double(x)) };
+    }
+
+    /// Component of a node computed in double
+    double expected(const TidalHarmonic& h, std::size_t k, double t) const
+    {
+        const auto& c = m_constituents[k];
+        return c.nodalFactor * h.amplitude.t *
+               std::cos(c.phase.t + c.speed * t - h.phase.t);
+    }
+
+    LinearSpace<latitude_t> m_latSpace{
+        makeLinearSpace(latitude_t(0.5), latitude_t(0.01), 3)
+    };
+    LinearSpace<longitude_t> m_lonSpace{
+        makeLinearSpace(longitude_t(-0.1), longitude_t(0.01), 2)
+    };
+    NonUniformSpace<tiny_sea::time_t> m_timeSpace{ makeLinearSpace(
+      tiny_sea::time_t(0.), tiny_sea::time_t(3600.), 72) };
+    std::vector<TidalConstituent> m_constituents{
+        TidalConstituent::fromDegreesPerHour(
+          TidalConstituent::M2, radian_t(0.4), 0.97),
+        TidalConstituent::fromDegreesPerHour(
+          TidalConstituent::K1, radian_t(2.1), 1.1)
+    };
+    std::unique_ptr<TidalCurrentGrid> m_grid;
+};
+
+TEST_F(TidalCurrentGridFixture, TEST_nodes)
+{
+    EXPECT_EQ(m_grid->nrConstituents(), 2);
+    // 4x3 nodes with the duplicated row and column, 8 floats by node
+    EXPECT_EQ(m_grid->memory(), 4 * 3 * 8 * sizeof(float));
+
+    // On slices, between slices and on the last days
+    for (double t : { 0., 1800., 7200., 100000., 250000., 255599. }) {
+        for (std::size_t x = 0; x < 3; ++x) {
+            for (std::size_t y = 0; y < 2; ++y) {
+                auto res = m_grid->current(tiny_sea::time_t(t),
+                                           m_latSpace.value(x),
+                                           m_lonSpace.value(y));
+                double u = expected(uHarmonic(x, y, 0), 0, t) +
+                           expected(uHarmonic(x, y, 1), 1, t);
+                double v = expected(vHarmonic(x, 0), 0, t) +
+                           expected(vHarmonic(x, 1), 1, t);
+                EXPECT_NEAR(res.m_x.t, u, 1e-5);
+                EXPECT_NEAR(res.m_y.t, v, 1e-5);
+            }
+        }
+    }
+}
+
+/*! Between nodes, the current is the bilinear blend of the corners current
+ */
+TEST_F(TidalCurrentGridFixture, TEST_interpolated)
+{
+    tiny_sea::time_t t(43210.);
+    auto c00 = m_grid->current(t, m_latSpace.value(1), m_lonSpace.value(0));
+    auto c10 = m_grid->current(t, m_latSpace.value(2), m_lonSpace.value(0));
+    auto c01 = m_grid->current(t, m_latSpace.value(1), m_lonSpace.value(1));
+    auto c11 = m_grid->current(t, m_latSpace.value(2), m_lonSpace.value(1));
+
+    auto res = m_grid->current(t, latitude_t(0.5125), longitude_t(-0.093));
+    auto blend = [](double v00, double v10, double v01, double v11) {
+        double y0 = v00 + (v10 - v00) * 0.25;
+        double y1 = v01 + (v11 - v01) * 0.25;
+        return y0 + (y1 - y0) * 0.7;
+    };
+    EXPECT_NEAR(
+      res.m_x.t, blend(c00.m_x.t, c10.m_x.t, c01.m_x.t, c11.m_x.t), 1e-5);
+    EXPECT_NEAR(
+      res.m_y.t, blend(c00.m_y.t, c10.m_y.t, c01.m_y.t, c11.m_y.t), 1e-5);
+
+    // Clamped outside the grid and the time space
+    auto clamped =
+      m_grid->current(tiny_sea::time_t(1e7), latitude_t(1.), longitude_t(1.));
+    auto last = m_grid->current(
+      m_timeSpace.stop(), m_latSpace.value(2), m_lonSpace.value(1));
+    EXPECT_NEAR(clamped.m_x.t, last.m_x.t, 1e-6);
+    EXPECT_NEAR(clamped.m_y.t, last.m_y.t, 1e-6);
+}
+
+/// Node bounds hold for all times and bound interpolated currents
+TEST_F(TidalCurrentGridFixture, TEST_speed_bound)
+{
+    for (std::size_t x = 0; x < 3; ++x) {
+        for (std::size_t y = 0; y < 2; ++y) {
+            double bound = 0.;
+            for (std::size_t k = 0; k < 2; ++k) {
+                double u = uHarmonic(x, y, k).amplitude.t;
+                double v = vHarmonic(x, k).amplitude.t;
+                bound += m_constituents[k].nodalFactor * std::hypot(u, v);
+            }
+            EXPECT_NEAR(m_grid->speedBound(x, y).t, bound, 1e-5);
+        }
+    }
+
+    double maxBound = m_grid->speedBound(2, 1).t;
+    for (double t = 0.; t < 255600.; t += 600.) {
+        auto res = m_grid->current(
+          tiny_sea::time_t(t), latitude_t(0.517), longitude_t(-0.094));
+        EXPECT_LE(res.velocity().t, maxBound + 1e-5);
+    }
+}
+
+TEST_F(TidalCurrentGridFixture, TEST_errors)
+{
+    TidalCurrentGridBuilder builder(
+      m_latSpace, m_lonSpace, m_timeSpace, m_constituents);
+    TidalHarmonic h{ velocity_t(1.), radian_t(0.) };
+    EXPECT_THROW(builder.set(3, 0, 0, h, h), Exception);
+    EXPECT_THROW(builder.set(0, 2, 0, h, h), Exception);
+    EXPECT_THROW(builder.set(0, 0, 2, h, h), Exception);
+
+    EXPECT_THROW(TidalCurrentGrid(m_latSpace,
+                                  m_lonSpace,
+                                  m_timeSpace,
+                                  m_constituents,
+                                  std::vector<float>(10)),
+                 Exception);
+
+    // Time weights have a fixed capacity
+    std::vector<TidalConstituent> constituents(
+      TidalCurrentGrid::MAX_CONSTITUENTS + 1, m_constituents[0]);
+    EXPECT_THROW(TidalCurrentGrid(m_latSpace,
+                                  m_lonSpace,
+                                  m_timeSpace,
+                                  constituents,
+                                  std::vector<float>(3 * 2 * 4 *
+                                                     constituents.size())),
+                 Exception);
+}
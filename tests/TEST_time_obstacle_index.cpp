@@ -0,0 +1,166 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// includes
+// std
+#include <chrono>
+#include <memory>
+#include <vector>
+
+// GTest
+#include <gtest/gtest.h>
+
+// tiny_sea
+#include <tiny_sea/core/exception.h>
+#include <tiny_sea/core/time_obstacle_index.h>
+
+using namespace tiny_sea;
+
+namespace {
+
+NVector
+pos(double lat, double lon)
+{
+    return NVector::fromLatLon(latitude_t(lat), longitude_t(lon));
+}
+
+/// Square zone of 0.02 radian centered on (lat, lon)
+std::vector<NVector>
+square(double lat, double lon)
+{
+    return { pos(lat - 0.01, lon - 0.01),
+             pos(lat - 0.01, lon + 0.01),
+             pos(lat + 0.01, lon + 0.01),
+             pos(lat + 0.01, lon - 0.01) };
+}
+
+tiny_sea::time_t
+minutes(int m)
+{
+    return fromChrono(std::chrono::minutes(m));
+}
+
+}
+
+/*! Slices at 0h, 1h, 2h and 5h
+ * Zone A at (0.5, 0.) active in [30min, 90min[
+ * Zone B at (0.5, 0.1) active in [3h, 4h[
+ * Zone C at (0.6, 0.) active in [0h, 10h[
+ */
+class TimeObstacleIndexFixture : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        TimeObstacleIndexBuilder builder(
+          makeNonUniformSpace(std::vector<tiny_sea::time_t>{
+            minutes(0), minutes(60), minutes(120), minutes(300) }),
+          radian_t(0.005));
+        builder.addZone(square(0.5, 0.), minutes(30), minutes(90));
+        builder.addZone(square(0.5, 0.1), minutes(180), minutes(240));
+        builder.addZone(square(0.6, 0.), minutes(0), minutes(600));
+        EXPECT_THROW(
+          builder.addZone(square(0.7, 0.), minutes(60), minutes(60)),
+          Exception);
+        m_index.reset(new TimeObstacleIndex(std::move(builder).build()));
+    }
+
+    std::unique_ptr<TimeObstacleIndex> m_index;
+};
+
+TEST_F(TimeObstacleIndexFixture, TEST_slices)
+{
+    EXPECT_EQ(m_index->obstacles().size(), 3);
+    EXPECT_EQ(m_index->nrActive(0), 2);
+    EXPECT_EQ(m_index->nrActive(1), 2);
+    EXPECT_EQ(m_index->nrActive(2), 2);
+    EXPECT_EQ(m_index->nrActive(3), 1);
+}
+
+TEST_F(TimeObstacleIndexFixture, TEST_blocked)
+{
+    // Cross zone A west edge
+    NVector from = pos(0.5, -0.02);
+    NVector to = pos(0.5, -0.005);
+    EXPECT_FALSE(m_index->blocked(from, to, minutes(0), minutes(20)));
+    EXPECT_TRUE(m_index->blocked(from, to, minutes(20), minutes(40)));
+    EXPECT_TRUE(m_index->blocked(from, to, minutes(70), minutes(80)));
+    EXPECT_FALSE(m_index->blocked(from, to, minutes(90), minutes(100)));
+
+    // Cross zone B with a move spanning many slices
+    from = pos(0.5, 0.08);
+    to = pos(0.5, 0.095);
+    EXPECT_FALSE(m_index->blocked(from, to, minutes(50), minutes(170)));
+    EXPECT_TRUE(m_index->blocked(from, to, minutes(50), minutes(200)));
+    EXPECT_FALSE(m_index->blocked(from, to, minutes(250), minutes(400)));
+
+    // Cross zone C before, in and after the time space
+    from = pos(0.6, -0.02);
+    to = pos(0.6, -0.005);
+    EXPECT_TRUE(m_index->blocked(from, to, minutes(-10), minutes(5)));
+    EXPECT_TRUE(m_index->blocked(from, to, minutes(200), minutes(210)));
+    EXPECT_TRUE(m_index->blocked(from, to, minutes(500), minutes(510)));
+    EXPECT_FALSE(m_index->blocked(from, to, minutes(600), minutes(610)));
+
+    // Stay inside zone C
+    EXPECT_TRUE(m_index->blocked(
+      pos(0.6, -0.005), pos(0.6, 0.005), minutes(10), minutes(20)));
+    EXPECT_FALSE(m_index->blocked(
+      pos(0.6, -0.005), pos(0.6, 0.005), minutes(600), minutes(620)));
+
+    // Leave or enter zone A without crossing an edge at this step
+    from = pos(0.5, 0.005);
+    to = pos(0.5, 0.);
+    EXPECT_TRUE(m_index->blocked(from, to, minutes(40), minutes(50)));
+    EXPECT_FALSE(m_index->blocked(from, to, minutes(0), minutes(20)));
+    // Zone A activate around a waiting boat
+    EXPECT_TRUE(m_index->blocked(from, from, minutes(20), minutes(60)));
+    EXPECT_FALSE(m_index->blocked(from, from, minutes(0), minutes(20)));
+    // Waiting outside of the zone
+    EXPECT_FALSE(m_index->blocked(
+      pos(0.5, 0.02), pos(0.5, 0.02), minutes(20), minutes(60)));
+}
+
+TEST_F(TimeObstacleIndexFixture, TEST_inside)
+{
+    const auto& zone = m_index->obstacles()[0];
+    EXPECT_TRUE(zone.inside(pos(0.5, 0.)));
+    EXPECT_TRUE(zone.inside(pos(0.509, -0.009)));
+    EXPECT_FALSE(zone.inside(pos(0.5, 0.011)));
+    EXPECT_FALSE(zone.inside(pos(0.489, 0.)));
+
+    // Concave zone
+    TimeObstacleIndexBuilder builder(
+      makeNonUniformSpace(
+        std::vector<tiny_sea::time_t>{ minutes(0), minutes(60) }),
+      radian_t(0.005));
+    builder.addZone({ pos(0., 0.),
+                      pos(0., 0.03),
+                      pos(0.03, 0.03),
+                      pos(0.03, 0.02),
+                      pos(0.01, 0.02),
+                      pos(0.01, 0.01),
+                      pos(0.03, 0.01),
+                      pos(0.03, 0.) },
+                    minutes(0),
+                    minutes(60));
+    auto index = std::move(builder).build();
+    const auto& u = index.obstacles()[0];
+    EXPECT_TRUE(u.inside(pos(0.005, 0.015)));
+    EXPECT_TRUE(u.inside(pos(0.02, 0.005)));
+    EXPECT_TRUE(u.inside(pos(0.02, 0.025)));
+    EXPECT_FALSE(u.inside(pos(0.02, 0.015)));
+}
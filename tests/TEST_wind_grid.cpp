@@ -0,0 +1,291 @@
+// TinySea: sailing boat routing library
+// Copyright (C) 2019 Joris Vaillant
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// includes
+// GTest
+#include <gtest/gtest.h>
+
+// tiny_sea
+#include <tiny_sea/core/wind_grid.h>
+#include <tiny_sea/core/world_map.h>
+
+using namespace tiny_sea;
+
+/*! Wind from east (PI/2) blow to west
+ */
+TEST(WIND_VECTOR_TESTS, TEST_from_bearing)
+{
+    auto wind = WindVector::fromBearing(radian_t(PI / 2.), velocity_t(3.));
+    EXPECT_NEAR(wind.m_x.t, -3., 1e-8);
+    EXPECT_NEAR(wind.m_y.t, 0., 1e-8);
+    EXPECT_NEAR(wind.bearing().t, PI / 2., 1e-8);
+    EXPECT_NEAR(wind.velocity().t, 3., 1e-8);
+
+    wind = WindVector::fromBearing(radian_t(-3. * PI / 4.), velocity_t(2.));
+    EXPECT_NEAR(wind.bearing().t, -3. * PI / 4., 1e-8);
+    EXPECT_NEAR(wind.velocity().t, 2., 1e-8);
+}
+
+/*!
+ * lon
+ *  11.     (PI/2, 2)  (PI, 4)  (PI, 4)
+ *  10.     (0, 2)     (PI, 2)  (PI/2, 8)
+ *           2.        3.       4.        lat
+ */
+class WindGridFixture : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        WorldMapGridBuilder builder(
+          makeLinearSpace(latitude_t(2.), latitude_t(1.), 3),
+          makeLinearSpace(longitude_t(10.), longitude_t(1.), 2));
+        builder(0, 0) = WorldMapData(radian_t(0.), velocity_t(2.));
+        builder(1, 0) = WorldMapData(radian_t(PI), velocity_t(2.));
+        builder(2, 0) = WorldMapData(radian_t(PI / 2.), velocity_t(8.));
+        builder(0, 1) = WorldMapData(radian_t(PI / 2.), velocity_t(2.));
+        builder(1, 1) = WorldMapData(radian_t(PI), velocity_t(4.));
+        builder(2, 1) = WorldMapData(radian_t(PI), velocity_t(4.));
+        m_worldGrid.reset(new WorldMapGrid(builder.build()));
+        m_windGrid.reset(new WindGrid(*m_worldGrid));
+    }
+
+    std::unique_ptr<WorldMapGrid> m_worldGrid;
+    std::unique_ptr<WindGrid> m_windGrid;
+};
+
+TEST_F(WindGridFixture, TEST_nodes)
+{
+    for (std::size_t lat = 0; lat < 3; ++lat) {
+        for (std::size_t lon = 0; lon < 2; ++lon) {
+            auto expected = (*m_worldGrid)(lat, lon);
+            auto res = (*m_windGrid)(lat, lon);
+            EXPECT_NEAR(
+              minDistance(res.windBearing, expected.windBearing).t, 0., 1e-6);
+            EXPECT_NEAR(res.windVelocity.t, expected.windVelocity.t, 1e-6);
+
+            res = m_windGrid->safeInterpolated(
+              m_worldGrid->xSpace().value(lat),
+              m_worldGrid->ySpace().value(lon));
+            EXPECT_NEAR(
+              minDistance(res.windBearing, expected.windBearing).t, 0., 1e-6);
+            EXPECT_NEAR(res.windVelocity.t, expected.windVelocity.t, 1e-6);
+        }
+    }
+}
+
+/*! Opposite winds interpolate toward a calm
+ */
+TEST_F(WindGridFixture, TEST_calm)
+{
+    auto res = m_windGrid->safeInterpolated(latitude_t(2.5), longitude_t(10.));
+    EXPECT_NEAR(res.windVelocity.t, 0., 1e-6);
+
+    // Angle interpolation keep the full velocity
+    auto angle =
+      m_worldGrid->safeInterpolated(latitude_t(2.5), longitude_t(10.));
+    EXPECT_NEAR(angle.windVelocity.t, 2., 1e-6);
+}
+
+TEST_F(WindGridFixture, TEST_interpolated)
+{
+    // u/v are (0, 2) and (-8, 0)
+    auto res = m_windGrid->safeInterpolated(latitude_t(3.5), longitude_t(10.));
+    EXPECT_NEAR(res.windVelocity.t, std::hypot(4., 1.), 1e-6);
+    EXPECT_NEAR(res.windBearing.t, std::atan2(4., -1.), 1e-6);
+
+    // Clamped outside the grid
+    res = m_windGrid->safeInterpolated(latitude_t(5.), longitude_t(12.));
+    EXPECT_NEAR(res.windVelocity.t, 4., 1e-6);
+    EXPECT_NEAR(std::abs(res.windBearing.t), PI, 1e-6);
+}
+
+/*! Batch kernel must give the same result than the scalar one
+ */
+TEST_F(WindGridFixture, TEST_batch)
+{
+    const std::size_t size = 150;
+    std::vector<latitude_t> lats;
+    std::vector<longitude_t> lons;
+    for (std::size_t i = 0; i < size; ++i) {
+        lats.emplace_back(1.8 + 2.4 * double(i) / size);
+        lons.emplace_back(9.9 + 1.3 * double((i * 7) % size) / size);
+    }
+
+    std::vector<WorldMapData> res(size);
+    m_windGrid->safeInterpolated(lats.data(), lons.data(), size, res.data());
+    for (std::size_t i = 0; i < size; ++i) {
+        auto expected = m_windGrid->safeInterpolated(lats[i], lons[i]);
+        EXPECT_NEAR(res[i].windBearing.t, expected.windBearing.t, 1e-6);
+        EXPECT_NEAR(res[i].windVelocity.t, expected.windVelocity.t, 1e-6);
+    }
+}
+
+TEST_F(WindGridFixture, TEST_world_map)
+{
+    WorldMap worldMap(*m_windGrid);
+    EXPECT_THROW(worldMap.worldGrid(), std::bad_variant_access);
+    EXPECT_EQ(worldMap.latSpace().nrPoints(), 3);
+    EXPECT_EQ(worldMap.lonSpace().nrPoints(), 2);
+
+    auto res = worldMap.safeInterpolated(latitude_t(3.5), longitude_t(10.));
+    EXPECT_NEAR(res.windVelocity.t, std::hypot(4., 1.), 1e-6);
+}
+
+TEST_F(WindGridFixture, TEST_world_map_sharing)
+{
+    WorldMap worldMap(*m_windGrid);
+    WorldMap copy(worldMap);
+    EXPECT_EQ(&worldMap.grid(), &copy.grid());
+
+    TimeWorldMapBuilder builder(
+      makeLinearSpace(tiny_sea::time_t(0.), tiny_sea::time_t(10.), 2));
+    builder.add(worldMap);
+    builder.add(WorldMap(WindGrid(*m_windGrid)));
+    auto shared = builder.build();
+    auto moved = std::move(builder).build();
+    ASSERT_EQ(moved.values().size(), 3);
+    EXPECT_EQ(&moved.values()[0].grid(), &worldMap.grid());
+    EXPECT_EQ(&moved.values()[1].grid(), &moved.values()[2].grid());
+    EXPECT_EQ(&shared.values()[1].grid(), &moved.values()[1].grid());
+}
+
+/*! Blend the fixture wind with a calm slice
+ * 10 s      calm
+ * 0 s       fixture
+ */
+TEST_F(WindGridFixture, TEST_time_interpolated)
+{
+    const auto& xSpace = m_windGrid->xSpace();
+    const auto& ySpace = m_windGrid->ySpace();
+    WindGrid::plane_type calm(m_windGrid->planeSize(), 0.f);
+    auto timeSpace =
+      makeLinearSpace(tiny_sea::time_t(0.), tiny_sea::time_t(10.), 2);
+
+    // Fused WindGrid kernel
+    TimeWorldMapBuilder windBuilder(timeSpace);
+    windBuilder.add(WorldMap(*m_windGrid));
+    windBuilder.add(WorldMap(WindGrid(xSpace, ySpace, calm, calm)));
+    auto windMap = std::move(windBuilder).build();
+
+    // Generic path
+    WorldMapGridBuilder calmBuilder(xSpace, ySpace);
+    for (std::size_t lat = 0; lat < 3; ++lat) {
+        for (std::size_t lon = 0; lon < 2; ++lon) {
+            calmBuilder(lat, lon) = WorldMapData(radian_t(0.), velocity_t(0.));
+        }
+    }
+    TimeWorldMapBuilder worldBuilder(timeSpace);
+    worldBuilder.add(WorldMap(*m_worldGrid));
+    worldBuilder.add(WorldMap(calmBuilder.build()));
+    auto worldMap = std::move(worldBuilder).build();
+
+    for (double lat : { 2., 2.3, 3.5, 4. }) {
+        for (double lon : { 10., 10.4, 11. }) {
+            auto expected = m_windGrid->safeInterpolatedVector(
+              latitude_t(lat), longitude_t(lon));
+            auto res = windMap.safeInterpolated(
+              tiny_sea::time_t(2.5), latitude_t(lat), longitude_t(lon));
+            EXPECT_NEAR(res.windVelocity.t, 0.75 * expected.velocity().t, 1e-5);
+            if (expected.velocity().t > 1e-5) {
+                EXPECT_NEAR(res.windBearing.t, expected.bearing().t, 1e-5);
+            }
+
+            // Slices are exact, only time blending is compared
+            res = windMap.safeInterpolated(
+              tiny_sea::time_t(0.), latitude_t(lat), longitude_t(lon));
+            EXPECT_NEAR(res.windVelocity.t, expected.velocity().t, 1e-5);
+        }
+    }
+
+    // On nodes, both paths blend the same vectors
+    for (std::size_t lat = 0; lat < 3; ++lat) {
+        for (std::size_t lon = 0; lon < 2; ++lon) {
+            auto x = xSpace.value(lat);
+            auto y = ySpace.value(lon);
+            auto fused = windMap.safeInterpolated(tiny_sea::time_t(7.), x, y);
+            auto generic =
+              worldMap.safeInterpolated(tiny_sea::time_t(7.), x, y);
+            EXPECT_NEAR(fused.windVelocity.t, generic.windVelocity.t, 1e-5);
+        }
+    }
+
+    // After stop, the last slice is used
+    auto res = windMap.safeInterpolated(
+      tiny_sea::time_t(20.), latitude_t(3.), longitude_t(10.));
+    EXPECT_NEAR(res.windVelocity.t, 0., 1e-8);
+}
+
+/*! Fixture wind with a current growing with latitude
+ */
+TEST_F(WindGridFixture, TEST_current)
+{
+    EXPECT_FALSE(m_windGrid->hasCurrent());
+    EXPECT_EQ(m_windGrid->currentU(), nullptr);
+
+    WorldMapGridBuilder builder(m_worldGrid->xSpace(), m_worldGrid->ySpace());
+    for (std::size_t lat = 0; lat < 3; ++lat) {
+        for (std::size_t lon = 0; lon < 2; ++lon) {
+            auto data = (*m_worldGrid)(lat, lon);
+            builder(lat, lon) = WorldMapData(
+              data.windBearing,
+              data.windVelocity,
+              WindVector(velocity_t(double(lat)), velocity_t(-1.)));
+        }
+    }
+    WorldMapGrid worldGrid(builder.build());
+    WindGrid windGrid(worldGrid);
+    ASSERT_TRUE(windGrid.hasCurrent());
+
+    auto res = windGrid(2, 1);
+    EXPECT_NEAR(res.current.m_x.t, 2., 1e-6);
+    EXPECT_NEAR(res.current.m_y.t, -1., 1e-6);
+
+    // Wind and current share the same weights
+    res = windGrid.safeInterpolated(latitude_t(3.5), longitude_t(10.));
+    EXPECT_NEAR(res.windVelocity.t, std::hypot(4., 1.), 1e-6);
+    EXPECT_NEAR(res.current.m_x.t, 1.5, 1e-6);
+    EXPECT_NEAR(res.current.m_y.t, -1., 1e-6);
+
+    std::vector<latitude_t> lats{ latitude_t(2.2), latitude_t(3.7) };
+    std::vector<longitude_t> lons{ longitude_t(10.1), longitude_t(10.9) };
+    std::vector<WorldMapData> batch(2);
+    windGrid.safeInterpolated(lats.data(), lons.data(), 2, batch.data());
+    for (std::size_t i = 0; i < 2; ++i) {
+        auto expected = windGrid.safeInterpolated(lats[i], lons[i]);
+        EXPECT_NEAR(batch[i].current.m_x.t, expected.current.m_x.t, 1e-6);
+        EXPECT_NEAR(batch[i].current.m_y.t, expected.current.m_y.t, 1e-6);
+    }
+
+    // Current is blended with a slice without current, on both paths
+    auto timeSpace =
+      makeLinearSpace(tiny_sea::time_t(0.), tiny_sea::time_t(10.), 2);
+    TimeWorldMapBuilder windBuilder(timeSpace);
+    windBuilder.add(WorldMap(windGrid));
+    windBuilder.add(WorldMap(*m_windGrid));
+    auto windMap = std::move(windBuilder).build();
+    TimeWorldMapBuilder worldBuilder(timeSpace);
+    worldBuilder.add(WorldMap(worldGrid));
+    worldBuilder.add(WorldMap(*m_worldGrid));
+    auto worldMap = std::move(worldBuilder).build();
+
+    for (const auto* map : { &windMap, &worldMap }) {
+        res = map->safeInterpolated(
+          tiny_sea::time_t(2.5), latitude_t(4.), longitude_t(10.5));
+        EXPECT_NEAR(res.current.m_x.t, 1.5, 1e-6);
+        EXPECT_NEAR(res.current.m_y.t, -0.75, 1e-6);
+    }
+}